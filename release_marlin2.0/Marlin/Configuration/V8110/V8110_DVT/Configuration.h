@@ -1648,6 +1648,13 @@
       #define BILINEAR_SUBDIVISIONS 2
     #endif
 
+    //
+    // Catmull-Rom between the probed points instead of straight lines.
+    // C1 continuous Z correction without more probe points or the subdivided mesh RAM.
+    // The polynomial of the current grid cell is cached. Requires SEGMENT_LEVELED_MOVES.
+    //
+    #define ABL_BILINEAR_BICUBIC
+
   #endif
 
 #elif ENABLED(AUTO_BED_LEVELING_UBL)
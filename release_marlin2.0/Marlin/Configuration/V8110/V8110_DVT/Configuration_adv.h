@@ -960,15 +960,19 @@
 
 #endif
 
-//#define INPUT_SHAPING
+#define INPUT_SHAPING
 #if ENABLED(INPUT_SHAPING)
-  #define SHAPING_FREQ_X    40  // (Hz) The dominant resonant frequency of the X axis.
-  #define SHAPING_FREQ_Y    40  // (Hz) The dominant resonant frequency of the Y axis.
-  #define SHAPING_ZETA_X  0.3f  // Damping ratio of the X axis (range: 0.0 = no damping to 1.0 = critical damping).
-  #define SHAPING_ZETA_Y  0.3f  // Damping ratio of the Y axis (range: 0.0 = no damping to 1.0 = critical damping).
-  #define SHAPING_BUFFER_X 301  // Must be > (steps/mm * maximum speed) / (SHAPING_FREQ_X * 2).
-  #define SHAPING_BUFFER_Y 301  // Must be > (steps/mm * maximum speed) / (SHAPING_FREQ_Y * 2).
-  #define SHAPING_SEGMENTS  10  // Maximum number of segments that could be processed in 1 / (min(ISHAPING_FREQ_X, ISHAPING_FREQ_Y) * 2) seconds.
+  #define SHAPING_TYPE_X  SHAPER_MZV  // Shaper family: SHAPER_NONE, SHAPER_ZV, SHAPER_ZVD, SHAPER_MZV or SHAPER_EI. (M4897 X I)
+  #define SHAPING_TYPE_Y  SHAPER_MZV  // Shaper family of the Y axis. (M4897 Y I)
+  #define SHAPING_FREQ_X    40  // (Hz) The dominant resonant frequency of the X axis. Measure with M4895 X.
+  #define SHAPING_FREQ_Y    40  // (Hz) The dominant resonant frequency of the Y axis. Measure with M4895 Y.
+  #define SHAPING_ZETA_X  0.1f  // Damping ratio of the X axis (range: 0.0 = no damping to 0.6).
+  #define SHAPING_ZETA_Y  0.1f  // Damping ratio of the Y axis (range: 0.0 = no damping to 0.6).
+  #define SHAPING_MIN_FREQ  25  // (Hz) Lowest frequency M4897 accepts. The longest echo delay is 1.25 / SHAPING_MIN_FREQ.
+  #define SHAPING_RAM     8192  // (bytes) RAM for the X and Y echo buffers, 4 bytes per step event.
+  #define SHAPING_BUFFER_X ((SHAPING_RAM) / 8)  // Step events. Full speed needs > steps/mm * maximum speed * 1.25 / SHAPING_MIN_FREQ,
+  #define SHAPING_BUFFER_Y ((SHAPING_RAM) / 8)  // otherwise the planner lowers the speed of shaped moves to fit.
+  #define SHAPING_SEGMENTS  40  // Maximum number of segments that could be processed in 1.25 / SHAPING_MIN_FREQ seconds.
 #endif
 
 // @section motion
@@ -2100,8 +2104,13 @@
  * reduces motion calculations, increases top printing speeds, and results in
  * less step aliasing by calculating all motions in advance.
  * Preparing your G-code: https://github.com/colinrgodsey/step-daemon
+ *
+ * With ANKER_MULTIORDER_PACK the host sends the pages as '#' frames on uart1,
+ * PackBits compressed, see feature/anker/anker_page_stream.h. The free pages
+ * are reported by M2021. LIN_ADVANCE and INPUT_SHAPING stay on for the G-code
+ * moves, a page gets neither: the host applies both while it generates the steps.
  */
-//#define DIRECT_STEPPING
+#define DIRECT_STEPPING
 
 /**
  * G38 Probe Target
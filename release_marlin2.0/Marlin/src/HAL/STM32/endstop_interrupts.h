@@ -27,6 +27,14 @@
 // One ISR for all EXT-Interrupts
 void endstop_ISR() { endstops.update(); }
 
+#if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+  #include "../../feature/anker/anker_endstop_debounce.h"
+
+  // One ISR per pin, the edge goes into the burst of its endstop
+  template<pin_t P, EndstopEnum E>
+  void endstop_edge_ISR() { es_debounce.edge(E, READ(P)); }
+#endif
+
 #if ENABLED(ANKER_FIX_ENDSTOPR)
 
 void setup_endstop_interrupts(uint16_t value) {
@@ -137,6 +145,34 @@ void setup_endstop_interrupts(uint16_t value) {
   }
 
 }
+ #elif ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+  void setup_endstop_interrupts() {
+    #define _ATTACH(E) do{ es_debounce.attach(E, READ(E##_PIN), #E); attachInterrupt(E##_PIN, endstop_edge_ISR<E##_PIN, E>, CHANGE); }while(0)
+    es_debounce.init();
+    TERN_(HAS_X_MAX, _ATTACH(X_MAX));
+    TERN_(HAS_X_MIN, _ATTACH(X_MIN));
+    TERN_(HAS_Y_MAX, _ATTACH(Y_MAX));
+    TERN_(HAS_Y_MIN, _ATTACH(Y_MIN));
+    TERN_(HAS_Z_MAX, _ATTACH(Z_MAX));
+    TERN_(HAS_Z_MIN, _ATTACH(Z_MIN));
+    TERN_(HAS_X2_MAX, _ATTACH(X2_MAX));
+    TERN_(HAS_X2_MIN, _ATTACH(X2_MIN));
+    TERN_(HAS_Y2_MAX, _ATTACH(Y2_MAX));
+    TERN_(HAS_Y2_MIN, _ATTACH(Y2_MIN));
+    TERN_(HAS_Z2_MAX, _ATTACH(Z2_MAX));
+    TERN_(HAS_Z2_MIN, _ATTACH(Z2_MIN));
+    TERN_(HAS_Z3_MAX, _ATTACH(Z3_MAX));
+    TERN_(HAS_Z3_MIN, _ATTACH(Z3_MIN));
+    TERN_(HAS_Z4_MAX, _ATTACH(Z4_MAX));
+    TERN_(HAS_Z4_MIN, _ATTACH(Z4_MIN));
+    TERN_(HAS_Z_MIN_PROBE_PIN, _ATTACH(Z_MIN_PROBE));
+    TERN_(HAS_I_MAX, _ATTACH(I_MAX));
+    TERN_(HAS_I_MIN, _ATTACH(I_MIN));
+    TERN_(HAS_J_MAX, _ATTACH(J_MAX));
+    TERN_(HAS_J_MIN, _ATTACH(J_MIN));
+    TERN_(HAS_K_MAX, _ATTACH(K_MAX));
+    TERN_(HAS_K_MIN, _ATTACH(K_MIN));
+  }
  #else
   void setup_endstop_interrupts() {
    #define _ATTACH(P) attachInterrupt(P, endstop_ISR, CHANGE)
@@ -38,6 +38,7 @@
 #define STEP_TIMER_IRQ_PRIO_DEFAULT      1
 #define TEMP_TIMER_IRQ_PRIO_DEFAULT      14 // Low priority avoids interference with other hardware and timers
 #define TEMP_MOTION_IRQ_PRIO_DEFAULT      4
+#define ENDSTOP_TIMER_IRQ_PRIO_DEFAULT    6 // Same as the EXTIs (EXTI_IRQ_PRIO), the endstop edges and the debounce never preempt each other
 
 #ifndef STEP_TIMER_IRQ_PRIO
   #define STEP_TIMER_IRQ_PRIO STEP_TIMER_IRQ_PRIO_DEFAULT
@@ -48,6 +49,9 @@
 #ifndef TEMP_MOTION_IRQ_PRIO
   #define TEMP_MOTION_IRQ_PRIO TEMP_MOTION_IRQ_PRIO_DEFAULT
 #endif
+#ifndef ENDSTOP_TIMER_IRQ_PRIO
+  #define ENDSTOP_TIMER_IRQ_PRIO ENDSTOP_TIMER_IRQ_PRIO_DEFAULT
+#endif
 
 #if HAS_TMC_SW_SERIAL
   #include <SoftwareSerial.h>
@@ -85,6 +89,7 @@
   #define MCU_STEP_TIMER  6           // STM32F401 has no TIM6, TIM7, or TIM8
   #define MCU_TEMP_TIMER 14           // TIM7 is consumed by Software Serial if used.
   #define MCU_MOTION_TIMER 13           // TIM13
+  #define MCU_ENDSTOP_TIMER 11          // TIM11, its only channel (PB9) is a plain GPIO on the V8110
 #endif
 
 #ifndef HAL_TIMER_RATE
@@ -100,12 +105,16 @@
 #ifndef MOTION_TIMER
   #define MOTION_TIMER MCU_MOTION_TIMER
 #endif
+#ifndef ENDSTOP_TIMER
+  #define ENDSTOP_TIMER MCU_ENDSTOP_TIMER
+#endif
 
 #define __TIMER_DEV(X) TIM##X
 #define _TIMER_DEV(X) __TIMER_DEV(X)
 #define STEP_TIMER_DEV _TIMER_DEV(STEP_TIMER)
 #define TEMP_TIMER_DEV _TIMER_DEV(TEMP_TIMER)
 #define MOTION_TIMER_DEV _TIMER_DEV(MOTION_TIMER)
+#define ENDSTOP_TIMER_DEV _TIMER_DEV(ENDSTOP_TIMER)
 
 // ------------------------
 // Private Variables
@@ -158,6 +167,13 @@ void HAL_timer_start(const uint8_t timer_num, const uint32_t frequency) {
         // The prescale factor is computed automatically for HERTZ_FORMAT
         timer_instance[timer_num]->setOverflow(frequency, HERTZ_FORMAT);
         break;
+
+      #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+        case ENDSTOP_TIMER_NUM: // ENDSTOP TIMER - any available 16bit timer, one-shot per edge burst
+          timer_instance[timer_num] = new HardwareTimer(ENDSTOP_TIMER_DEV);
+          timer_instance[timer_num]->setOverflow(frequency, HERTZ_FORMAT);
+          break;
+      #endif
     }
 
     // Disable preload. Leaving it default-enabled can cause the timer to stop if it happens
@@ -182,6 +198,11 @@ void HAL_timer_start(const uint8_t timer_num, const uint32_t frequency) {
       case MOTION_TRACK_TIMER_NUM:
         timer_instance[timer_num]->setInterruptPriority(TEMP_MOTION_IRQ_PRIO, 0);
         break;
+      #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+        case ENDSTOP_TIMER_NUM:
+          timer_instance[timer_num]->setInterruptPriority(ENDSTOP_TIMER_IRQ_PRIO, 0);
+          break;
+      #endif
     }
   }
 }
@@ -198,6 +219,11 @@ void HAL_timer_enable_interrupt(const uint8_t timer_num) {
       case MOTION_TRACK_TIMER_NUM:
         timer_instance[timer_num]->attachInterrupt(Motion_Handler);
         break;
+      #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+        case ENDSTOP_TIMER_NUM:
+          timer_instance[timer_num]->attachInterrupt(Endstop_Handler);
+          break;
+      #endif
     }
   }
 }
@@ -312,7 +338,7 @@ IF_ENABLED(HAS_TMC_SW_SERIAL, static constexpr uintptr_t timer_serial[] = {uintp
 IF_ENABLED(SPEAKER,           static constexpr uintptr_t timer_tone[]   = {uintptr_t(TIMER_TONE)});
 IF_ENABLED(HAS_SERVOS,        static constexpr uintptr_t timer_servo[]  = {uintptr_t(TIMER_SERVO)});
 
-enum TimerPurpose { TP_SERIAL, TP_TONE, TP_SERVO, TP_STEP, TP_TEMP, TP_MOTION};
+enum TimerPurpose { TP_SERIAL, TP_TONE, TP_SERVO, TP_STEP, TP_TEMP, TP_MOTION, TP_ENDSTOP};
 
 // List of timers, to enable checking for conflicts.
 // Includes the purpose of each timer to ease debugging when evaluating at build-time.
@@ -330,6 +356,9 @@ static constexpr struct { TimerPurpose p; int t; } timers_in_use[] = {
   {TP_STEP, STEP_TIMER},
   {TP_TEMP, TEMP_TIMER},
   {TP_MOTION, MOTION_TIMER},
+  #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+    {TP_ENDSTOP, ENDSTOP_TIMER},
+  #endif
 };
 
 static constexpr bool verify_no_timer_conflicts() {
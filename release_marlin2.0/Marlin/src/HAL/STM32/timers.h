@@ -44,7 +44,7 @@
 #define hal_timer_t uint32_t
 #define HAL_TIMER_TYPE_MAX UINT16_MAX
 
-#define NUM_HARDWARE_TIMERS 3
+#define NUM_HARDWARE_TIMERS 4
 
 #ifndef STEP_TIMER_NUM
   #define STEP_TIMER_NUM        0  // Timer Index for Stepper
@@ -57,6 +57,7 @@
 #endif
 
 #define MOTION_TRACK_TIMER_NUM 2  // Timer Index for motion debug
+#define ENDSTOP_TIMER_NUM      3  // Timer Index for the endstop debounce
 
 #define TEMP_TIMER_FREQUENCY 1000   // Temperature::isr() is expected to be called at around 1kHz
 
@@ -83,6 +84,7 @@ extern uint32_t GetStepperTimerClkFreq();
 extern void Step_Handler();
 extern void Temp_Handler();
 extern void Motion_Handler();
+extern void Endstop_Handler();
 
 #ifndef HAL_STEP_TIMER_ISR
   #define HAL_STEP_TIMER_ISR() void Step_Handler()
@@ -93,6 +95,9 @@ extern void Motion_Handler();
 #ifndef HAL_MOTION_TRACK_ISR
 #define HAL_MOTION_TRACK_ISR() void Motion_Handler()
 #endif
+#ifndef HAL_ENDSTOP_TIMER_ISR
+  #define HAL_ENDSTOP_TIMER_ISR() void Endstop_Handler()
+#endif
 
 // ------------------------
 // Public Variables
@@ -275,11 +275,31 @@
 #if ENABLED(NO_MOTION_BEFORE_HOMING)
   #include "feature/anker/anker_homing.h"
 #endif
+
+#if ENABLED(ANKER_TMC_POLL)
+  #include "feature/anker/anker_tmc_poll.h"
+#endif
+
+#if ENABLED(ANKER_ISR_PROFILE)
+  #include "feature/anker/anker_isr_profile.h"
+#endif
+
+#if ENABLED(ANKER_STEP_SCHED)
+  #include "feature/anker/anker_step_sched.h"
+#endif
+
+#if ENABLED(ANKER_PROBE_CAPTURE)
+  #include "feature/anker/anker_probe_capture.h"
+#endif
     
 #if ENABLED(ANKER_Z_OFFSET_FUNC)
   #include "feature/anker/anker_z_offset.h"
 #endif
 
+#if ENABLED(ANKER_MAKE_API)
+  #include "feature/anker/anker_sched.h"
+#endif
+
 #if ADAPT_DETACHED_NOZZLE
 #include "feature/interactive/uart_nozzle_rx.h"
 #include "feature/interactive/oci.h"
@@ -894,8 +914,10 @@ void idle(bool no_stepper_sleep/*=false*/) {
   TERN(DWIN_CREALITY_LCD, DWIN_Update(), ui.update());
 
   #if ENABLED(PHOTO_Z_LAYER)
-    parser.report_z_axis_process();
+    block_event.report();
   #endif
+
+  TERN_(ANKER_BINARY_LOG, anker_blog.flush());
   // Run i2c Position Encoders
   #if ENABLED(I2C_POSITION_ENCODERS)
   {
@@ -911,7 +933,7 @@ void idle(bool no_stepper_sleep/*=false*/) {
   #endif
 
   // Auto-report Temperatures / SD Status
-  #if HAS_AUTO_REPORTING
+  #if HAS_AUTO_REPORTING && DISABLED(ANKER_MAKE_API)
     if (!gcode.autoreport_paused) {
       TERN_(AUTO_REPORT_TEMPERATURES, thermalManager.auto_reporter.tick());
       TERN_(AUTO_REPORT_SD_STATUS, card.auto_reporter.tick());
@@ -932,27 +954,12 @@ void idle(bool no_stepper_sleep/*=false*/) {
   // Update the LVGL interface
   TERN_(HAS_TFT_LVGL_UI, LV_TASK_HANDLER());
   
-  #if ENABLED(ANKER_LOG_DEBUG)
-    anker_check_block_buf();
-  #endif
-
-  #if ENABLED(HANDSHAKE)
-    hand_shake.check();
-  #endif
-  
-  #if ENABLED(NO_MOTION_BEFORE_HOMING)
-    anker_homing.anker_disable_motton_before_check();
-  #endif
-  
   #if ENABLED(ANKER_Z_OFFSET_FUNC)
     anker_z_offset.loop_read();
   #endif
-  
-  #if ADAPT_DETACHED_NOZZLE
-    uart_nozzle_polling();  
-  #endif
 
-  TERN_(ANKER_MAKE_API, stepper.current_status_polling());
+  // Nozzle link, handshake, TMC polling, status and auto reports. See M4894 for their run time.
+  TERN_(ANKER_MAKE_API, anker_sched.loop());
 
   IDLE_DONE:
   TERN_(MARLIN_DEV_MODE, idle_depth--);
@@ -1749,6 +1756,22 @@ void setup() {
     anker_align.init();
   #endif
   
+  #if ENABLED(ANKER_TMC_POLL)
+    anker_tmc_poll.init();
+  #endif
+
+  #if ENABLED(ANKER_ISR_PROFILE)
+    isr_profile.init();
+  #endif
+
+  #if ENABLED(ANKER_STEP_SCHED)
+    step_sched.init();
+  #endif
+
+  #if ENABLED(ANKER_PROBE_CAPTURE)
+    probe_capture.init();
+  #endif
+
   #if ENABLED(USE_Z_SENSORLESS)
     use_z_sensorless.init();
   #endif
@@ -1767,6 +1790,8 @@ void setup() {
   uart_nozzle_init();
   oci_init();
 #endif
+
+  TERN_(ANKER_MAKE_API, anker_sched.init());
 }
 
 /**
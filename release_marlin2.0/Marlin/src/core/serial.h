@@ -319,9 +319,15 @@ void serialprintPGM(PGM_P str);
   #define SEND_MSG_CODE_TO_HOST(...) do{MYSERIAL2.printLine(__VA_ARGS__);}while (0) // Send the information to the Junzheng board
   #define SEND_MSG_CODE_TO_DEBUG(...) do{MYSERIAL3.printLine(__VA_ARGS__);}while (0) // Send the information to the debug board
   #define SEND_ERR_STR_CODE(errno, errno2, err_type, str_var, ...) SEND_MSG_CODE_TO_HOST(ERR_STR0_CONCAT(err_type, str_var), errno, errno2, __VA_ARGS__)
-  #define SEND_ERRNO_TO_HOST(errno, errno2, str_var, ...) SEND_MSG_CODE_TO_HOST(ERR_STR1_CONCAT(str_var), errno, errno2, __VA_ARGS__)
-  #define SEND_DEBUG_TO_HOST(errno, errno2, str_var, ...) SEND_MSG_CODE_TO_HOST(DEBUFG_STR_CONCAT(str_var), errno, errno2, __VA_ARGS__)
-  #define SEND_RESPONSE_TO_HOST(errno, errno2, str_var, ...) SEND_MSG_CODE_TO_HOST(DEBUFG_RESPONSE_CONCAT(str_var), errno, errno2, __VA_ARGS__)
+  #if ENABLED(ANKER_BINARY_LOG)
+    #include "../feature/anker/anker_blog.h"
+    #define SEND_LOG_CODE_TO_HOST BLOG_TO_HOST // Binary record once M4902 S1 turned it on
+  #else
+    #define SEND_LOG_CODE_TO_HOST SEND_MSG_CODE_TO_HOST
+  #endif
+  #define SEND_ERRNO_TO_HOST(errno, errno2, str_var, ...) SEND_LOG_CODE_TO_HOST(ERR_STR1_CONCAT(str_var), errno, errno2, __VA_ARGS__)
+  #define SEND_DEBUG_TO_HOST(errno, errno2, str_var, ...) SEND_LOG_CODE_TO_HOST(DEBUFG_STR_CONCAT(str_var), errno, errno2, __VA_ARGS__)
+  #define SEND_RESPONSE_TO_HOST(errno, errno2, str_var, ...) SEND_LOG_CODE_TO_HOST(DEBUFG_RESPONSE_CONCAT(str_var), errno, errno2, __VA_ARGS__)
 #endif
 
 //
@@ -10,6 +10,7 @@
 #if ENABLED(ANKER_ANLIGN)
   #include "anker_align.h"
   #include "../../module/stepper.h"
+  #include "../../module/planner.h"
   #include "../../module/probe.h"
   #include "../../gcode/gcode.h"
   #include "../../module/temperature.h"
@@ -79,6 +80,168 @@
        anker_align.run_align();
     }
 
+  #if ENABLED(ANKER_ALIGN_LSQ)
+
+    #define ALIGN_LSQ_MIN_SPREAD 0.02f // (mm) Corrections must differ this much before their slope is fitted
+
+    /**
+     * @brief  Raise both Z motors by rise and one of them by extra more, in one planned move.
+     *         The other motor is locked by the stepper isr once it made the rise.
+     * @param  rise : both motors (mm)
+     * @param  extra : correction (mm), 0 for none
+     * @param  choose : 0 Z1, 1 Z2 gets the correction
+     * @retval None
+     */
+    void Anker_Align::rise_and_correct(const float rise, const float extra, const uint8_t choose)
+    {
+       if (extra <= 0) { do_blocking_move_to_z(current_position.z + rise); return; }
+
+       const uint32_t rise_steps = LROUND(rise * planner.settings.axis_steps_per_mm[Z_AXIS]);
+       stepper.set_separate_multi_axis(true);
+       if (rise_steps)
+         stepper.set_z_lock_after(!choose, rise_steps);
+       else
+         stepper.set_all_z_lock(true, choose);
+
+       do_blocking_move_to_z(current_position.z + rise + extra);
+
+       stepper.set_z_lock_after(0, 0);
+       stepper.set_z_lock_after(1, 0);
+       stepper.set_all_z_lock(false);
+       stepper.set_separate_multi_axis(false);
+
+       if (choose) anker_align.z2_value += extra; else anker_align.z1_value += extra;
+    }
+
+    /**
+     * @brief  The tilt d = z1 - z2 of every pass against the correction c = z2_value - z1_value
+     *         it was measured with, as a line d = d0 + g * c. Once the passes spread c the slope g
+     *         is the least squares one, so a screw distance, backlash or bed flex other than the
+     *         drawing is learned. Until then, or if the fit is far off, g is the geometric slope.
+     * @param  c, d : the passes
+     * @param  n : number of passes
+     * @param  g_nom : geometric slope, -probe span / SCREW_DISTANCE
+     * @retval the correction c that brings d to 0
+     */
+    static float align_lsq_target(const float *c, const float *d, const uint8_t n, const float g_nom)
+    {
+       float mc = 0, md = 0;
+       LOOP_L_N(i, n) { mc += c[i]; md += d[i]; }
+       mc /= n; md /= n;
+
+       float g = g_nom;
+       if (n > 1) {
+         float sxx = 0, sxy = 0;
+         LOOP_L_N(i, n) { sxx += sq(c[i] - mc); sxy += (c[i] - mc) * (d[i] - md); }
+         if (sxx > n * sq(ALIGN_LSQ_MIN_SPREAD)) {
+           const float gf = sxy / sxx;
+           if (WITHIN(gf / g_nom, 0.5f, 1.5f)) g = gf;
+         }
+       }
+       return mc - md / g; // The fitted line through the mean of the passes
+    }
+
+    /**
+     * Each pass probes both sides, serpentine so the nozzle starts where it stopped, and the
+     * correction from the fit over all the passes so far rides on the rise of the next pass.
+     * Stops as soon as the two sides agree within ANLIGN_ALLOWED, ANLIGN_NUM is only the limit.
+     */
+    void Anker_Align::auto_align(void)
+    {
+     const ProbePtRaise raise_after =  PROBE_PT_RAISE;
+
+     #if ENABLED(Z_MULTI_ENDSTOPS)
+      const float z2_endstop_adj = endstops.z2_endstop_adj;
+      endstops.z2_endstop_adj = 0.0f;
+     #endif
+
+     anker_align.init();
+     #ifdef  ALIGN_PER_RESET
+      anker_align.reset();
+     #endif
+     anker_align.g36_running_flag = true;
+
+     const celsius_t targetTemperature = thermalManager.degTargetHotend(0);  // Reducing temperature during the process of wiping mouth
+
+     gcode.process_subcommands_now_P(PSTR("G28"));
+
+     const float g_nom = -(anker_align.xy[1].x - anker_align.xy[0].x) / (SCREW_DISTANCE);
+     float c[ANLIGN_NUM], d[ANLIGN_NUM], extra = 0;
+     uint8_t side = 0;
+
+     anker_probe_set.delay=800;
+     LOOP_L_N(num, ANLIGN_NUM)
+     {
+       anker_align.rise_and_correct(ANLIGN_RISE, extra, side);
+       extra = 0;
+       #if ADAPT_DETACHED_NOZZLE
+         uart_nozzle_tx_point_type(POINT_G36, num);
+       #endif
+       const uint8_t first = num & 1;
+       float z[2];
+       z[first] = probe.probe_at_point(anker_align.xy[first], raise_after, 0, true, false);
+       do_blocking_move_to_z(current_position.z+ANLIGN_RISE);
+       safe_delay(600);
+       z[!first] = probe.probe_at_point(anker_align.xy[!first], raise_after, 0, true, false);
+       const float z1 = z[0], z2 = z[1];
+       SERIAL_ECHOLNPAIR(" z1:", z1, " z2:", z2);
+
+       if(ABS(z1-z2)>ANLIGN_MAX_VALUE || ANKER_OVERPRESSURE_TRIGGER())
+       {
+         ANKER_CLOSED_OVERPRESSURE_TRIGGER();
+         TERN_(ADAPT_DETACHED_NOZZLE, uart_nozzle_tx_notify_error());
+         SERIAL_ECHO("ok\r\n");
+         SERIAL_ERROR_MSG("Adjustment range over 1.5mm!!\r\n");
+         SERIAL_ERROR_MSG(STR_ERR_PROBING_FAILED);
+         endstops.z2_endstop_adj = z2_endstop_adj;
+         anker_align.g36_running_flag = false;
+         kill();
+       }
+       if(ABS(z1-z2)<=ANLIGN_ALLOWED)
+       {
+         SERIAL_ECHO("echo:anlign ok!\r\n");
+         SERIAL_ECHO(" Z1_value:");
+         SERIAL_ECHO(anker_align.z1_value);
+         SERIAL_ECHO(" Z2_value:");
+         SERIAL_ECHO(anker_align.z2_value);
+         SERIAL_ECHO("\r\n");
+         SERIAL_ECHOLNPAIR("echo:anlign passes:", num + 1);
+         break;
+       }
+       if(num==(ANLIGN_NUM-1))
+       {
+         SERIAL_ECHO("echo:Please check the Z-axis limit!\r\n");
+         anker_align.reset();
+         break;
+       }
+       if(anker_align.g36_running_flag == false)
+       {
+         SERIAL_ECHO("echo:anker_align stop!\r\n");
+         break;
+       }
+
+       c[num] = anker_align.z2_value - anker_align.z1_value;
+       d[num] = z1 - z2;
+       const float delta = align_lsq_target(c, d, num + 1, g_nom) - c[num];
+       side = delta > 0;   // Raise Z2 for a positive change, Z1 for a negative one
+       extra = ABS(delta);
+
+       anker_align.xy[0].y+=1.5;
+       anker_align.xy[1].y+=1.5;
+     }
+     anker_probe_set.delay=LEVEING_PROBE_DELAY;
+     gcode.process_subcommands_now_P(PSTR("G2001\n"));
+     anker_align.g36_running_flag = false;
+     TERN_(USE_Z_SENSORLESS, anker_homing.is_again_probe_homing = false);
+     TERN_(Z_MULTI_ENDSTOPS, endstops.z2_endstop_adj = z2_endstop_adj);
+
+     TERN_(ANKER_MAKE_API, anker_homing.after_align_action(targetTemperature));
+     TERN_(ANKER_MAKE_API, anker_homing.filament_type = FILAMENT_PLA); // reset filament to PLA
+
+    }
+
+  #else
+
     void Anker_Align::auto_align(void)
     {
      uint16_t num=0;
@@ -181,6 +344,7 @@
 
     }
 
+  #endif // !ANKER_ALIGN_LSQ
 
 #endif
 
@@ -22,6 +22,9 @@
       void add_z2_value(float value);
       void add_z1_value_no_save(float value);
       void add_z2_value_no_save(float value);
+      #if ENABLED(ANKER_ALIGN_LSQ)
+        void rise_and_correct(const float rise, const float extra, const uint8_t choose);
+      #endif
     };
    extern Anker_Align anker_align;
 #endif
@@ -0,0 +1,98 @@
+/*
+ * @Author       : jason.wu
+ * @Date         : 2026-10-18 10:12:40
+ * @LastEditors  : jason.wu
+ * @LastEditTime : 2026-10-18 10:12:40
+ * @Description  : Block synchronized events, the planner tags a block and the stepper isr reports it
+ */
+#include "anker_block_event.h"
+
+#if ENABLED(PHOTO_Z_LAYER)
+
+#include "../../core/serial.h"
+
+static_assert(IS_POWER_OF_2(BLOCK_EVENT_SLOTS) && BLOCK_EVENT_SLOTS <= 128, "BLOCK_EVENT_SLOTS must be a power of 2, at most 128.");
+
+#define SLOT_FREE    0
+#define SLOT_PLANNED 1
+
+Anker_Block_Event block_event;
+
+block_event_t Anker_Block_Event::table[BLOCK_EVENT_SLOTS];
+uint8_t Anker_Block_Event::state[BLOCK_EVENT_SLOTS];
+block_event_done_t Anker_Block_Event::done[BLOCK_EVENT_SLOTS];
+volatile uint8_t Anker_Block_Event::done_head;
+volatile uint8_t Anker_Block_Event::done_tail;
+uint32_t Anker_Block_Event::deferred, Anker_Block_Event::lost;
+
+/**
+ * @brief  Take a table slot for the block being planned
+ * @param  type event type
+ * @param  value event value, the layer number
+ * @param  pos block target
+ * @retval event ID for block_t::event_id, BLOCK_EVENT_NONE if the table is full
+ */
+uint8_t Anker_Block_Event::alloc(const BlockEventType type, const_float_t value, const xyze_pos_t &pos) {
+  static uint8_t next;
+  LOOP_L_N(i, BLOCK_EVENT_SLOTS) {
+    const uint8_t s = (next + i) & (BLOCK_EVENT_SLOTS - 1);
+    if (state[s] != SLOT_FREE) continue;
+    block_event_t &e = table[s];
+    e.type = type;
+    e.value = LROUND(value * 1000.0f);
+    e.pos.set(LROUND(pos.x * 10000.0f), LROUND(pos.y * 10000.0f), LROUND(pos.z * 10000.0f));
+    e.start_ms = 0;
+    state[s] = SLOT_PLANNED;
+    next = s + 1;
+    return s + 1;
+  }
+  deferred++;
+  return BLOCK_EVENT_NONE;
+}
+
+// The queued blocks were dropped, their events will never run. Call with the stepper isr suspended.
+void Anker_Block_Event::discard() {
+  uint8_t queued[BLOCK_EVENT_SLOTS] = { 0 };
+  for (uint8_t t = done_tail; t != done_head; t++)
+    queued[done[t & (BLOCK_EVENT_SLOTS - 1)].id - 1] = 1;
+  LOOP_L_N(s, BLOCK_EVENT_SLOTS) if (!queued[s]) state[s] = SLOT_FREE;
+}
+
+// Fixed point to text, no float printf
+static char* fixed_to_str(char *p, const int32_t v, const uint8_t decimals) {
+  uint32_t scale = 1;
+  LOOP_L_N(i, decimals) scale *= 10;
+  const uint32_t a = v < 0 ? -v : v;
+  return p + sprintf_P(p, PSTR("%s%lu.%0*lu"), v < 0 ? "-" : "", (unsigned long)(a / scale), decimals, (unsigned long)(a % scale));
+}
+
+/**
+ * @brief  Send the completed events, called from idle()
+ *         z-upraise:<dir>,<layer>,<x>,<y>,<z>,<start ms>,<end ms>
+ * @retval None
+ */
+void Anker_Block_Event::report() {
+  uint8_t t = done_tail;
+  const uint8_t h = __atomic_load_n(&done_head, __ATOMIC_ACQUIRE);
+  for (; t != h; t++) {
+    const block_event_done_t &d = done[t & (BLOCK_EVENT_SLOTS - 1)];
+    const uint8_t s = d.id - 1;
+    if (state[s] != SLOT_PLANNED) continue;   // Discarded after it was queued
+
+    const block_event_t &e = table[s];
+    if (e.type == BLOCK_EVENT_LAYER) {
+      char buf[96], *p = buf;
+      p += sprintf_P(p, PSTR("\r\n\r\nz-upraise:1,"));
+      p = fixed_to_str(p, e.value, 3); *p++ = ',';
+      p = fixed_to_str(p, e.pos.x, 4); *p++ = ',';
+      p = fixed_to_str(p, e.pos.y, 4); *p++ = ',';
+      p = fixed_to_str(p, e.pos.z, 4);
+      sprintf_P(p, PSTR(",%lu,%lu\r\n"), (unsigned long)e.start_ms, (unsigned long)d.end_ms);
+      SERIAL_ECHO(buf);
+    }
+    state[s] = SLOT_FREE;
+  }
+  done_tail = t;
+}
+
+#endif
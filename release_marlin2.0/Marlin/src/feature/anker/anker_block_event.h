@@ -0,0 +1,76 @@
+/*
+ * @Author       : jason.wu
+ * @Date         : 2026-10-18 10:12:40
+ * @LastEditors  : jason.wu
+ * @LastEditTime : 2026-10-18 10:12:40
+ * @Description  : Block synchronized events, the planner tags a block and the stepper isr reports it
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(PHOTO_Z_LAYER)
+
+/**
+ * A block carries only a 1 byte event ID, the event itself waits in a side table.
+ *   main  : alloc() when the block is planned              FREE    -> PLANNED
+ *   isr   : start() when the block begins stepping, records the start time
+ *   isr   : finish() when the block completes, queues the ID with the end time
+ *   main  : report() sends the queued events to the host    PLANNED -> FREE
+ * Every slot is queued at most once, so the queue can not overflow and no event is lost.
+ * A full table leaves the event with the caller, who tags the next block instead.
+ */
+#define BLOCK_EVENT_SLOTS _MAX(16, BLOCK_BUFFER_SIZE * 2) // Power of 2, IDs are 1..BLOCK_EVENT_SLOTS
+#define BLOCK_EVENT_NONE  0
+
+enum BlockEventType : uint8_t {
+  BLOCK_EVENT_LAYER = 1       // Layer change, host takes the photo
+};
+
+typedef struct {
+  uint8_t type;
+  int32_t value;              // Layer number x1000
+  xyz_long_t pos;             // Block target, 0.0001mm
+  uint32_t start_ms;          // Written by the isr
+} block_event_t;
+
+typedef struct {
+  uint8_t id;
+  uint32_t end_ms;
+} block_event_done_t;
+
+class Anker_Block_Event {
+  public:
+    static block_event_t table[BLOCK_EVENT_SLOTS];
+    static uint8_t state[BLOCK_EVENT_SLOTS];
+
+    static block_event_done_t done[BLOCK_EVENT_SLOTS];
+    static volatile uint8_t done_head;  // isr
+    static volatile uint8_t done_tail;  // main
+
+    static uint32_t deferred, lost;
+
+    // Main loop
+    static uint8_t alloc(const BlockEventType type, const_float_t value, const xyze_pos_t &pos);
+    static void discard();
+    static void report();
+
+    // Stepper isr
+    FORCE_INLINE static void start(const uint8_t id) {
+      if (id) table[id - 1].start_ms = millis();
+    }
+
+    FORCE_INLINE static void finish(const uint8_t id) {
+      if (!id) return;
+      const uint8_t h = done_head;
+      if (uint8_t(h - done_tail) >= BLOCK_EVENT_SLOTS) { lost++; return; }
+      block_event_done_t &d = done[h & (BLOCK_EVENT_SLOTS - 1)];
+      d.id = id;
+      d.end_ms = millis();
+      __atomic_store_n(&done_head, uint8_t(h + 1), __ATOMIC_RELEASE);
+    }
+};
+
+extern Anker_Block_Event block_event;
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * @Author       : winter
+ * @Date         : 2026-10-18 17:20:44
+ * @LastEditors  : winter
+ * @LastEditTime : 2026-10-18 17:20:44
+ * @Description  : Binary host log, the format is resolved on the host
+ */
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_BINARY_LOG)
+
+#include "anker_blog.h"
+
+static_assert(IS_POWER_OF_2(BLOG_RING_SIZE), "BLOG_RING_SIZE must be a power of 2.");
+
+#define BLOG_MASK (BLOG_RING_SIZE - 1)
+
+Anker_Blog anker_blog;
+
+bool Anker_Blog::enabled;
+uint32_t Anker_Blog::records, Anker_Blog::dropped;
+
+static uint8_t ring[BLOG_RING_SIZE];
+static volatile uint16_t ring_head, ring_tail;
+
+/**
+ * @brief  Queue one record, from any context. A full ring drops the record.
+ * @param  id format hash
+ * @param  args packed arguments
+ * @param  len bytes of args
+ * @retval None
+ */
+void Anker_Blog::write(const uint32_t id, const uint8_t *args, const uint8_t len) {
+  uint8_t hdr[10];
+  const uint32_t ms = millis();
+  hdr[0] = BLOG_SYNC;
+  hdr[1] = len + 8;
+  memcpy(hdr + 2, &id, 4);
+  memcpy(hdr + 6, &ms, 4);
+
+  uint8_t sum = 0;
+  LOOP_S_L_N(i, 1, 10) sum += hdr[i];
+  LOOP_L_N(i, len) sum += args[i];
+
+  const uint16_t size = 10 + len + 1;
+  CRITICAL_SECTION_START();
+  uint16_t h = ring_head;
+  if (uint16_t(BLOG_RING_SIZE - uint16_t(h - ring_tail)) < size) {
+    dropped++;
+    CRITICAL_SECTION_END();
+    return;
+  }
+  LOOP_L_N(i, 10) ring[h++ & BLOG_MASK] = hdr[i];
+  LOOP_L_N(i, len) ring[h++ & BLOG_MASK] = args[i];
+  ring[h++ & BLOG_MASK] = sum;
+  ring_head = h;
+  records++;
+  CRITICAL_SECTION_END();
+}
+
+/**
+ * @brief  Send the queued records that fit in the uart tx buffer, called from idle()
+ * @retval None
+ */
+void Anker_Blog::flush() {
+  uint16_t t = ring_tail;
+  while (t != ring_head) {
+    const uint8_t size = ring[(t + 1) & BLOG_MASK] + 3;
+    if (MYSERIAL2.availableForWrite() < size) break;
+    LOOP_L_N(i, size) MYSERIAL2.write(ring[t++ & BLOG_MASK]);
+    ring_tail = t;
+  }
+}
+
+void Anker_Blog::report() {
+  MYSERIAL2.printLine("echo:binary log:%d records:%lu dropped:%lu\n", enabled, (unsigned long)records, (unsigned long)dropped);
+}
+
+#endif
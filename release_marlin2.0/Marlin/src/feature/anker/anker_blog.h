@@ -0,0 +1,89 @@
+/*
+ * @Author       : winter
+ * @Date         : 2026-10-18 17:20:44
+ * @LastEditors  : winter
+ * @LastEditTime : 2026-10-18 17:20:44
+ * @Description  : Binary host log, the format is resolved on the host
+ */
+#pragma once
+
+#include "../../inc/MarlinConfigPre.h"
+
+#if ENABLED(ANKER_BINARY_LOG)
+
+#include <string.h>
+
+/**
+ * A record holds the hash of the format string instead of the text, and the raw arguments:
+ *   0xA5 <len> <id:4> <ms:4> <args:len-8> <sum>     little endian, sum of <len>..<args> & 0xFF
+ * Integer args are 4 bytes, float/double are a 4 byte float, %s is <n> <n chars>.
+ * Records go to a ring from any context and reach the host uart from idle(), whole records
+ * only, so they never split a text line. 0xA5 is not text, the host tells them apart.
+ * buildroot/share/scripts/blog_decode.py finds the formats in the sources and prints the text.
+ * Off by default, M4902 S1 switches the host uart over, the text path stays as it was.
+ */
+#define BLOG_SYNC       0xA5
+#define BLOG_RING_SIZE  1024  // Power of 2
+#define BLOG_ARGS_MAX   48    // Bytes of arguments per record
+#define BLOG_STR_MAX    24    // Chars kept of a %s argument
+
+// FNV-1a of the format string, folded by the compiler
+constexpr uint32_t blog_hash(const char *s, const uint32_t h = 2166136261UL) {
+  return *s ? blog_hash(s + 1, (h ^ uint8_t(*s)) * 16777619UL) : h;
+}
+
+class Anker_Blog {
+  public:
+    static bool enabled;
+    static uint32_t records, dropped;
+
+    template<typename... Args>
+    static void log(const uint32_t id, Args... args) {
+      uint8_t buf[BLOG_ARGS_MAX];
+      uint8_t n = 0;
+      put_args(buf, n, args...);
+      write(id, buf, n);
+    }
+
+    static void write(const uint32_t id, const uint8_t *args, const uint8_t len);
+    static void flush();
+    static void report();
+
+  private:
+    static void put_word(uint8_t *b, uint8_t &n, const uint32_t w) {
+      if (n + 4 > BLOG_ARGS_MAX) return;
+      memcpy(b + n, &w, 4);
+      n += 4;
+    }
+    template<typename T>
+    static void put(uint8_t *b, uint8_t &n, const T v) { put_word(b, n, uint32_t(int32_t(v))); }
+    static void put(uint8_t *b, uint8_t &n, const float v) { uint32_t w; memcpy(&w, &v, 4); put_word(b, n, w); }
+    static void put(uint8_t *b, uint8_t &n, const double v) { put(b, n, float(v)); }
+    static void put(uint8_t *b, uint8_t &n, const char *s) {
+      uint8_t l = 0;
+      while (s[l] && l < BLOG_STR_MAX) l++;
+      if (n + 1 + l > BLOG_ARGS_MAX) return;
+      b[n++] = l;
+      memcpy(b + n, s, l);
+      n += l;
+    }
+    static void put(uint8_t *b, uint8_t &n, char *s) { put(b, n, (const char*)s); }
+
+    static void put_args(uint8_t*, uint8_t&) {}
+    template<typename T, typename... Args>
+    static void put_args(uint8_t *b, uint8_t &n, const T v, Args... args) {
+      put(b, n, v);
+      put_args(b, n, args...);
+    }
+};
+
+extern Anker_Blog anker_blog;
+
+// The format string and its arguments, as a record when the binary log is on, else as text
+#define BLOG_TO_HOST(FMT, ...) do{ \
+  constexpr uint32_t _blog_id = blog_hash(FMT); \
+  if (anker_blog.enabled) anker_blog.log(_blog_id, __VA_ARGS__); \
+  else MYSERIAL2.printLine(FMT, __VA_ARGS__); \
+}while(0)
+
+#endif
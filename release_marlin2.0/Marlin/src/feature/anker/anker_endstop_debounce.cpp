@@ -0,0 +1,123 @@
+/*
+ * @Author       : winter
+ * @Date         : 2026-10-18 17:21:36
+ * @LastEditors  : winter
+ * @LastEditTime : 2026-10-18 17:21:36
+ * @Description  : Endstop EXTI edges stamped per pin, debounced by a one-shot timer, glitch statistics
+ */
+#include "anker_endstop_debounce.h"
+
+#if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+
+#include "../../core/serial.h"
+
+#if DISABLED(ENDSTOP_INTERRUPTS_FEATURE) || ENABLED(ANKER_FIX_ENDSTOPR)
+  #error "ANKER_ENDSTOP_DEBOUNCE needs ENDSTOP_INTERRUPTS_FEATURE without ANKER_FIX_ENDSTOPR."
+#endif
+
+#define DEBOUNCE_TICKS_PER_US (float(F_CPU) / 1000000.0f)
+
+Anker_Endstop_Debounce es_debounce;
+
+es_pin_stat_t Anker_Endstop_Debounce::stat[NUM_ENDSTOP_STATES];
+uint32_t Anker_Endstop_Debounce::stops;
+es_burst_t Anker_Endstop_Debounce::burst[NUM_ENDSTOP_STATES];
+TIM_TypeDef *Anker_Endstop_Debounce::tim;
+bool Anker_Endstop_Debounce::armed;
+uint32_t Anker_Endstop_Debounce::armed_at;
+
+/**
+ * @brief  DWT cycle counter and the debounce timer, before the EXTIs are attached.
+ *         One-pulse mode: the counter stops on its own at the update event, an edge
+ *         only has to clear and enable it.
+ * @retval None
+ */
+void Anker_Endstop_Debounce::init() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  HAL_timer_start(ENDSTOP_TIMER_NUM, 1000000UL / (ENDSTOP_DEBOUNCE_US));
+  tim = timer_instance[ENDSTOP_TIMER_NUM]->getHandle()->Instance;
+  tim->CR1 |= TIM_CR1_OPM;
+  reset();
+}
+
+/**
+ * @brief  An endstop with a pin, from setup_endstop_interrupts()
+ * @param  e endstop
+ * @param  level pin level now
+ * @param  name for the report
+ * @retval None
+ */
+void Anker_Endstop_Debounce::attach(const EndstopEnum e, const bool level, const char *name) {
+  stat[e].name = name;
+  burst[e].n = 0;
+  burst[e].level = burst[e].stable = level;
+}
+
+/**
+ * @brief  Timer, the lines have been quiet for ENDSTOP_DEBOUNCE_US, or chattered
+ *         for ENDSTOP_DEBOUNCE_MAX_US: the pins are read at their level of the moment
+ * @retval None
+ */
+void Anker_Endstop_Debounce::settle() {
+  armed = false;
+  const Endstops::endstop_mask_t was = endstops.trigger_state();
+  endstops.update();
+  const bool stopped = (endstops.trigger_state() & ~was) != 0;
+  const uint32_t now = DWT->CYCCNT;
+  if (stopped) stops++;
+
+  LOOP_L_N(e, NUM_ENDSTOP_STATES) {
+    es_burst_t &b = burst[e];
+    if (!b.n) continue;
+    es_pin_stat_t &s = stat[e];
+    if (b.level == b.stable)
+      s.glitches++;                         // Back where it started, update() saw nothing
+    else {
+      if (b.n > 1) s.bounces++;
+      b.stable = b.level;
+      if (stopped) {
+        s.latency = now - b.first;
+        NOLESS(s.latency_max, s.latency);
+      }
+    }
+    b.n = 0;
+  }
+}
+
+void Anker_Endstop_Debounce::reset() {
+  CRITICAL_SECTION_START();
+  LOOP_L_N(e, NUM_ENDSTOP_STATES) {
+    es_pin_stat_t &s = stat[e];
+    s.edges = s.glitches = s.bounces = 0;
+    s.min_pulse = UINT32_MAX;
+    s.latency = s.latency_max = 0;
+  }
+  stops = 0;
+  CRITICAL_SECTION_END();
+}
+
+/**
+ * @brief  Per pin edges, glitches, bounces, shortest pulse and first edge to stop latency
+ * @retval None
+ */
+void Anker_Endstop_Debounce::report() {
+  SERIAL_ECHOLNPAIR("Endstop debounce us:", ENDSTOP_DEBOUNCE_US, " max:", ENDSTOP_DEBOUNCE_MAX_US, " stops:", stops);
+  LOOP_L_N(e, NUM_ENDSTOP_STATES) {
+    const es_pin_stat_t &s = stat[e];
+    if (!s.name) continue;
+    SERIAL_ECHOPAIR(" ", s.name, " edges:", s.edges);
+    SERIAL_ECHOPAIR(" glitches:", s.glitches, " bounces:", s.bounces);
+    if (s.min_pulse != UINT32_MAX) SERIAL_ECHOPAIR_F(" min pulse us:", s.min_pulse / DEBOUNCE_TICKS_PER_US, 2);
+    SERIAL_ECHOPAIR_F(" latency us:", s.latency / DEBOUNCE_TICKS_PER_US, 2);
+    SERIAL_ECHOLNPAIR_F(" max:", s.latency_max / DEBOUNCE_TICKS_PER_US, 2);
+  }
+}
+
+HAL_ENDSTOP_TIMER_ISR() {
+  HAL_timer_isr_prologue(ENDSTOP_TIMER_NUM);
+  es_debounce.settle();
+  HAL_timer_isr_epilogue(ENDSTOP_TIMER_NUM);
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * @Author       : winter
+ * @Date         : 2026-10-18 17:21:36
+ * @LastEditors  : winter
+ * @LastEditTime : 2026-10-18 17:21:36
+ * @Description  : Endstop EXTI edges stamped per pin, debounced by a one-shot timer, glitch statistics
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+
+#include "../../module/endstops.h"
+
+/**
+ * Every endstop pin has its own EXTI handler (HAL/STM32/endstop_interrupts.h), which stamps
+ * the edge with the DWT cycle counter into the burst of that pin and restarts a one-shot
+ * timer. The timer fires once the lines have been quiet for ENDSTOP_DEBOUNCE_US and runs
+ * endstops.update() a single time for the whole burst:
+ *   edge()   : EXTI, stamp, count, restart the timer. Not past ENDSTOP_DEBOUNCE_MAX_US
+ *              from the first edge since the last settle(), so chatter can't hold it off
+ *   settle() : timer, endstops.update(), then per pin: a burst back to the level it started
+ *              from is a glitch, one that moved it in several edges a bounce
+ * The EXTI and the timer share a priority, neither preempts the other. Nothing runs while
+ * the pins are quiet, endstops.poll() only counts down the homing blanking.
+ */
+#define ENDSTOP_DEBOUNCE_US 20  // (us) Quiet time after the last edge before the pins are read
+#define ENDSTOP_DEBOUNCE_MAX_US 100 // (us) Longest a burst may delay the read, from its first edge
+#define ENDSTOP_DEBOUNCE_MAX_CYCLES ((ENDSTOP_DEBOUNCE_MAX_US) * (F_CPU / 1000000UL))
+
+typedef struct {
+  uint32_t first, last;   // Cycle stamps of the first and last edge of the burst
+  uint8_t n;              // Edges in the burst, 0 when settled
+  bool level, stable;     // Pin level at the last edge / after the last settled burst
+} es_burst_t;
+
+typedef struct {
+  const char *name;       // Set by attach(), nullptr for an endstop without a pin
+  uint32_t edges, glitches, bounces;
+  uint32_t min_pulse;     // Shortest time between two edges, cycles
+  uint32_t latency, latency_max; // First edge to the stop, cycles
+} es_pin_stat_t;
+
+class Anker_Endstop_Debounce {
+  public:
+    static es_pin_stat_t stat[NUM_ENDSTOP_STATES];
+    static uint32_t stops;
+
+    static void init();
+    static void attach(const EndstopEnum e, const bool level, const char *name);
+    static void settle();
+    static void reset();
+    static void report();
+
+    // EXTI of the endstop pin
+    FORCE_INLINE static void edge(const EndstopEnum e, const bool level) {
+      const uint32_t t = DWT->CYCCNT;
+      es_burst_t &b = burst[e];
+      if (b.n) NOMORE(stat[e].min_pulse, t - b.last);
+      else b.first = t;
+      b.last = t;
+      b.level = level;
+      if (b.n < 255) b.n++;
+      stat[e].edges++;
+      if (!armed) { armed = true; armed_at = t; }
+      if (t - armed_at < ENDSTOP_DEBOUNCE_MAX_CYCLES) tim->CNT = 0; // Else let it run out
+      tim->CR1 |= TIM_CR1_CEN;
+    }
+
+    // Stamp of the edge that update() is looking at, for the probe capture
+    FORCE_INLINE static uint32_t stamp(const EndstopEnum e) {
+      return burst[e].n ? burst[e].first : DWT->CYCCNT;
+    }
+
+  private:
+    static es_burst_t burst[NUM_ENDSTOP_STATES];
+    static TIM_TypeDef *tim;
+    static bool armed;            // An edge since the last settle()
+    static uint32_t armed_at;     // Its cycle stamp
+};
+
+extern Anker_Endstop_Debounce es_debounce;
+
+#endif
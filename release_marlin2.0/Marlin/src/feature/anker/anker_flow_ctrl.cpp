@@ -0,0 +1,90 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 20:03:12
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 20:03:12
+ * @Description  : Planner lookahead in ms, starvation events and the host backpressure report
+ */
+#include "anker_flow_ctrl.h"
+
+#if ENABLED(ANKER_FLOW_CTRL)
+
+#include "../../core/serial.h"
+#include "../../gcode/queue.h"
+#include "../../module/planner.h"
+
+Anker_Flow_Ctrl anker_flow;
+
+uint16_t Anker_Flow_Ctrl::target_ms = FLOW_TARGET_MS;
+uint32_t Anker_Flow_Ctrl::starves, Anker_Flow_Ctrl::blocks;
+uint16_t Anker_Flow_Ctrl::drain_bps, Anker_Flow_Ctrl::lookahead_min;
+volatile bool Anker_Flow_Ctrl::dry, Anker_Flow_Ctrl::expected;
+millis_t Anker_Flow_Ctrl::dry_at;
+flow_starve_t Anker_Flow_Ctrl::event[FLOW_EVENTS];
+uint8_t Anker_Flow_Ctrl::event_head;
+uint32_t Anker_Flow_Ctrl::window_blocks;
+millis_t Anker_Flow_Ctrl::window_start;
+uint16_t Anker_Flow_Ctrl::window_min = UINT16_MAX;
+
+// Stepper ISR, the planner got a block again after running dry
+void Anker_Flow_Ctrl::gap() {
+  dry = false;
+  const millis_t ms = millis() - dry_at;
+  if (ms > FLOW_GAP_MAX_MS) return;
+  flow_starve_t &e = event[event_head];
+  e.at = dry_at;
+  e.gap_ms = ms;
+  e.commands = _MIN(queue.ring_buffer.length, 255U);
+  if (++event_head >= FLOW_EVENTS) event_head = 0;
+  starves++;
+}
+
+uint16_t Anker_Flow_Ctrl::lookahead_ms() {
+  return planner.block_buffer_runtime();
+}
+
+/**
+ * @brief  Drain rate and lowest lookahead, every FLOW_POLL_MS from anker_sched
+ * @retval None
+ */
+void Anker_Flow_Ctrl::poll() {
+  if (planner.has_blocks_queued()) NOMORE(window_min, lookahead_ms());
+
+  const millis_t ms = millis();
+  if (ms - window_start < FLOW_RATE_MS) return;
+  const uint32_t b = blocks;
+  drain_bps = ((b - window_blocks) * 1000UL) / (ms - window_start);
+  lookahead_min = window_min == UINT16_MAX ? 0 : window_min;
+  window_blocks = b;
+  window_start = ms;
+  window_min = UINT16_MAX;
+}
+
+// With +ringbuf, see report_buf_free_size()
+void Anker_Flow_Ctrl::report_host() {
+  MYSERIAL2.printLine("+flow:%d,%d,%d,%d\n", (int)lookahead_ms(), (int)target_ms, (int)drain_bps, (int)starves);
+}
+
+/**
+ * @brief  Lookahead, drain rate and the last starves, oldest first
+ * @retval None
+ */
+void Anker_Flow_Ctrl::report() {
+  SERIAL_ECHOLNPAIR("Flow lookahead ms:", lookahead_ms(), " min:", lookahead_min, " target:", target_ms);
+  SERIAL_ECHOLNPAIR(" blocks:", blocks, " per s:", drain_bps, " starves:", starves);
+  LOOP_L_N(i, FLOW_EVENTS) {
+    const flow_starve_t &e = event[(event_head + i) % FLOW_EVENTS];
+    if (!e.at) continue;
+    SERIAL_ECHOLNPAIR(" starve at ms:", e.at, " gap ms:", e.gap_ms, " commands:", e.commands);
+  }
+}
+
+void Anker_Flow_Ctrl::reset() {
+  CRITICAL_SECTION_START();
+  starves = 0;
+  ZERO(event);
+  event_head = 0;
+  CRITICAL_SECTION_END();
+}
+
+#endif
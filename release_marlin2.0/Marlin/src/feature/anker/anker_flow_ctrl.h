@@ -0,0 +1,82 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 20:03:12
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 20:03:12
+ * @Description  : Planner lookahead in ms, starvation events and the host backpressure report
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_FLOW_CTRL)
+
+/**
+ * The host paces the '@' packs on the "+flow:<lookahead ms>,<target ms>,<blocks/s>,<starves>"
+ * line sent with +ringbuf after every command: it sends while the lookahead is under the target
+ * and at least as fast as the planner drains blocks.
+ *   lookahead : motion time of the blocks waiting in the planner, block_buffer_runtime()
+ *   starve    : the stepper finished a block and found the planner empty, while nothing had
+ *               asked for it (planner.synchronize() of M400, G4, M109, G28...). Timed until
+ *               the next block, kept with the commands that were waiting in the ring buffer:
+ *               none means the host was late, some means the MCU was.
+ * A gap over FLOW_GAP_MAX_MS is a pause or the end of the print, not a starve.
+ */
+#define FLOW_TARGET_MS      300   // Default lookahead asked of the host
+#define FLOW_GAP_MAX_MS     2000
+#define FLOW_EVENTS         8     // Last starves kept for M4906
+#define FLOW_POLL_MS        100   // anker_sched period of poll()
+#define FLOW_RATE_MS        1000  // Drain rate window
+
+typedef struct {
+  millis_t at;                    // millis() when the planner ran dry
+  uint16_t gap_ms;                // Until the next block
+  uint8_t commands;               // Commands in the ring buffer meanwhile
+} flow_starve_t;
+
+class Anker_Flow_Ctrl {
+  public:
+    static uint16_t target_ms;
+    static uint32_t starves, blocks;
+    static uint16_t drain_bps;    // Blocks per second, last FLOW_RATE_MS
+    static uint16_t lookahead_min; // Lowest lookahead seen while moving, last FLOW_RATE_MS
+
+    static uint16_t lookahead_ms();
+    static void poll();
+    static void report_host();
+    static void report();
+    static void reset();
+
+    // planner.synchronize(), the planner is emptied on purpose
+    static void sync() { expected = true; }
+
+    // Stepper ISR, a block done and discarded
+    FORCE_INLINE static void block_done(const bool empty) {
+      blocks++;
+      if (empty && !expected) {
+        dry = true;
+        dry_at = millis();
+      }
+    }
+
+    // Stepper ISR, a block taken from the planner
+    FORCE_INLINE static void block_start() {
+      expected = false;
+      if (dry) gap();
+    }
+
+  private:
+    static volatile bool dry, expected;
+    static millis_t dry_at;
+    static flow_starve_t event[FLOW_EVENTS];
+    static uint8_t event_head;
+    static uint32_t window_blocks;
+    static millis_t window_start;
+    static uint16_t window_min;
+
+    static void gap();
+};
+
+extern Anker_Flow_Ctrl anker_flow;
+
+#endif
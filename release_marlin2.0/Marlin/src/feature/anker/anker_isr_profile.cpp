@@ -0,0 +1,79 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 10:02:15
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 10:02:15
+ * @Description  : Cycle counter based execution time statistics for ISRs and hot paths
+ */
+#include "anker_isr_profile.h"
+
+#if ENABLED(ANKER_ISR_PROFILE)
+
+#include "../../core/serial.h"
+
+ISR_Profile isr_profile;
+
+isr_profile_stat_t ISR_Profile::stat[PROF_COUNT];
+
+static const char * const isr_profile_name[PROF_COUNT] = {
+  "stepper_isr", "pulse_phase", "block_phase", "temperature_isr", "motion_track_isr", "populate_block", "level_z"
+};
+
+#if ISR_PROFILE_HOST
+  #define PROF_TICKS_PER_US 1000.0f
+#else
+  #define PROF_TICKS_PER_US (float(F_CPU) / 1000000.0f)
+#endif
+
+/**
+  * @brief  Start the DWT cycle counter and clear the table
+  * @param  None
+  * @retval None
+  */
+void ISR_Profile::init()
+{
+  #if !ISR_PROFILE_HOST
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  #endif
+  reset();
+}
+
+void ISR_Profile::reset()
+{
+  CRITICAL_SECTION_START();
+  LOOP_L_N(i, PROF_COUNT) {
+    ZERO(stat[i]);
+    stat[i].min = UINT32_MAX;
+  }
+  CRITICAL_SECTION_END();
+}
+
+/**
+  * @brief  Print min/mean/max in us and the histogram counts of every probe
+  * @param  None
+  * @retval None
+  */
+void ISR_Profile::report()
+{
+  SERIAL_ECHOLNPAIR("echo:isr profile, histogram buckets from <", 1UL << (PROF_HIST_SHIFT + 1), " ticks, x2 each, ", PROF_TICKS_PER_US, " ticks/us");
+  LOOP_L_N(i, PROF_COUNT) {
+    isr_profile_stat_t s;
+    CRITICAL_SECTION_START();
+    s = stat[i];
+    CRITICAL_SECTION_END();
+
+    SERIAL_ECHOPAIR("echo:", isr_profile_name[i], " n:", s.count);
+    if (s.count) {
+      SERIAL_ECHOPAIR_F(" min:", s.min / PROF_TICKS_PER_US, 2);
+      SERIAL_ECHOPAIR_F(" mean:", float(s.sum / s.count) / PROF_TICKS_PER_US, 2);
+      SERIAL_ECHOPAIR_F(" max:", s.max / PROF_TICKS_PER_US, 2);
+      SERIAL_ECHOPGM("us hist:");
+      LOOP_L_N(h, PROF_HIST_LEN) { SERIAL_CHAR(' '); SERIAL_ECHO(s.hist[h]); }
+    }
+    SERIAL_EOL();
+  }
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 10:02:15
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 10:02:15
+ * @Description  : Cycle counter based execution time statistics for ISRs and hot paths
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_ISR_PROFILE)
+
+#if defined(__PLAT_LINUX__) || defined(__PLAT_NATIVE_SIM__)
+  #include <chrono>
+  #define ISR_PROFILE_HOST 1
+#endif
+
+enum isr_profile_probe_t : uint8_t {
+  PROF_STEPPER_ISR,
+  PROF_PULSE_PHASE,
+  PROF_BLOCK_PHASE,
+  PROF_TEMPERATURE_ISR,
+  PROF_MOTION_TRACK_ISR,
+  PROF_POPULATE_BLOCK,
+  PROF_LEVEL_Z,
+  PROF_COUNT
+};
+
+// Log2 histogram of ticks: [0] < 2^(SHIFT+1), [n] < 2^(SHIFT+n+1), the last bucket is open-ended
+#define PROF_HIST_LEN   8
+#define PROF_HIST_SHIFT 7   // [0] < 256 cycles (1.5us @168MHz), [7] >= 16384 cycles (97us)
+
+typedef struct {
+  uint32_t min, max;
+  uint32_t count;
+  uint64_t sum;
+  uint32_t hist[PROF_HIST_LEN];
+} isr_profile_stat_t;
+
+class ISR_Profile {
+  public:
+    static isr_profile_stat_t stat[PROF_COUNT];
+
+    static void init();
+    static void reset();
+    static void report();
+
+    // Free-running tick counter: CPU cycles on the MCU, nanoseconds on host builds
+    static inline uint32_t ticks() {
+      #if ISR_PROFILE_HOST
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch()).count();
+      #else
+        return DWT->CYCCNT;
+      #endif
+    }
+
+    static inline void record(const isr_profile_probe_t p, const uint32_t start) {
+      const uint32_t t = ticks() - start;
+      isr_profile_stat_t &s = stat[p];
+      if (t < s.min) s.min = t;
+      if (t > s.max) s.max = t;
+      s.count++;
+      s.sum += t;
+      const int8_t b = t ? int8_t(31 - __builtin_clz(t)) - PROF_HIST_SHIFT : 0;
+      s.hist[b <= 0 ? 0 : _MIN(b, PROF_HIST_LEN - 1)]++;
+    }
+};
+
+// Scope guard: times from construction to the end of the enclosing block
+class ISR_Profile_Scope {
+  const isr_profile_probe_t probe;
+  const uint32_t start;
+  public:
+    ISR_Profile_Scope(const isr_profile_probe_t p) : probe(p), start(ISR_Profile::ticks()) {}
+    ~ISR_Profile_Scope() { ISR_Profile::record(probe, start); }
+};
+
+extern ISR_Profile isr_profile;
+
+#define ISR_PROFILE(P) ISR_Profile_Scope _isr_profile_scope(P)
+
+#else
+
+#define ISR_PROFILE(P) NOOP
+
+#endif
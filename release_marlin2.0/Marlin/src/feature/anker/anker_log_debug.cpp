@@ -10,16 +10,9 @@
 int anker_debug_flag;
 
 
+// Runs every 5s from the anker_sched timer wheel
 void anker_check_block_buf(void)
 {
-  millis_t ms = millis();
-  static millis_t next_report_ms = millis() + 5000;
-
-  ms = millis();
-  if(ms > next_report_ms)
-  {
-    next_report_ms = millis() + 5000;
-    SERIAL_ECHOLNPAIR("next_report_ms:",next_report_ms);
     SERIAL_ECHOLNPAIR("anker_debug_flag:",anker_debug_flag);
     if(queue.ring_buffer.empty() && anker_debug_flag)
     {
@@ -29,7 +22,6 @@ void anker_check_block_buf(void)
     {
       SERIAL_ECHOLN("current_block NULL");
     }
-   }
 }
 void set_anker_debug_flag(int value)
 {
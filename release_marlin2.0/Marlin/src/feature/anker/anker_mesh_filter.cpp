@@ -0,0 +1,253 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 15:06:31
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 15:06:31
+ * @Description  : Leveling mesh cleanup, outlier rejection, smoothing, plane / quadric fit
+ */
+#include "anker_mesh_filter.h"
+
+#if ENABLED(ANKER_FILTER_LEVEL_GRID) && ENABLED(AUTO_BED_LEVELING_BILINEAR)
+
+#include "../../core/serial.h"
+#include "../../libs/least_squares_fit.h"
+
+#define MESH_X GRID_MAX_POINTS_X
+#define MESH_Y GRID_MAX_POINTS_Y
+
+static_assert(MESH_X >= 3 && MESH_Y >= 3, "ANKER_FILTER_LEVEL_GRID needs a grid of 3x3 or more.");
+
+Anker_Mesh_Filter anker_mesh_filter;
+
+float Anker_Mesh_Filter::noise = MESH_FILTER_NOISE;
+float Anker_Mesh_Filter::edge_noise = MESH_FILTER_EDGE_NOISE;
+float Anker_Mesh_Filter::mad_k = MESH_FILTER_MAD_K;
+
+// Grid index to -1..1
+#define MESH_U(i, N) (float(2 * (i)) / ((N) - 1) - 1.0f)
+
+// Median of a short list, sorts it in place
+static float median(float *v, const uint8_t n) {
+  for (uint8_t i = 1; i < n; i++) {
+    const float t = v[i];
+    uint8_t j = i;
+    for (; j && v[j - 1] > t; j--) v[j] = v[j - 1];
+    v[j] = t;
+  }
+  return (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) * 0.5f;
+}
+
+// Median of the 3x3 neighbours of a point, the point itself left out
+static float neighbour_median(const bed_mesh_t &z, const uint8_t x, const uint8_t y) {
+  const uint8_t x0 = x ? x - 1 : 0, x1 = x < MESH_X - 1 ? x + 1 : x,
+                y0 = y ? y - 1 : 0, y1 = y < MESH_Y - 1 ? y + 1 : y;
+  float v[8];
+  uint8_t n = 0;
+  for (uint8_t i = x0; i <= x1; i++)
+    for (uint8_t j = y0; j <= y1; j++)
+      if ((i != x || j != y) && !isnan(z[i][j])) v[n++] = z[i][j];
+  return n ? median(v, n) : z[x][y];
+}
+
+/**
+ * @brief  Replace the points far from the median of their neighbours by that median.
+ *         The scale is the MAD of all the residuals, so a bed with a real bow or a noisy
+ *         probe raises the threshold instead of flattening the mesh.
+ * @param  z mesh, unprobed (NAN) points are left alone
+ * @param  flagged if given, set for the points replaced and cleared for the others
+ * @retval number of points replaced
+ */
+uint8_t Anker_Mesh_Filter::reject_outliers(bed_mesh_t &z, mesh_flags_t *flagged/*=nullptr*/) {
+  float ref[MESH_X][MESH_Y], res[MESH_X * MESH_Y];
+  uint8_t n = 0;
+  if (flagged) ZERO(*flagged);
+  GRID_LOOP(x, y) {
+    ref[x][y] = neighbour_median(z, x, y);
+    if (!isnan(z[x][y])) res[n++] = ABS(z[x][y] - ref[x][y]);
+  }
+  if (n < 3) return 0;
+
+  const float sigma = 1.4826f * median(res, n); // MAD as a standard deviation
+  uint8_t replaced = 0;
+  GRID_LOOP(x, y) {
+    const bool edge = x == 0 || y == 0 || x == MESH_X - 1 || y == MESH_Y - 1;
+    const float limit = _MAX(mad_k * sigma, edge ? edge_noise : noise);
+    if (!isnan(z[x][y]) && ABS(z[x][y] - ref[x][y]) > limit) {
+      z[x][y] = ref[x][y];
+      if (flagged) (*flagged)[x][y] = true;
+      replaced++;
+    }
+  }
+  return replaced;
+}
+
+/**
+ * @brief  Limit how far the outer step of a replaced edge point bends away from the step inside it.
+ *         With EXTRAPOLATE_BEYOND_GRID the leveling carries the outer step on past the grid, and
+ *         the neighbour median of an edge point only has 5 points, most of them on the edge too.
+ *         A measured edge point is the bed itself and is never moved.
+ * @param  z mesh
+ * @param  flagged the points reject_outliers() replaced
+ * @retval number of points changed
+ */
+uint8_t Anker_Mesh_Filter::refine_edges(bed_mesh_t &z, const mesh_flags_t &flagged) {
+  #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
+    uint8_t changed = 0;
+    auto bend = [&](const uint8_t x, const uint8_t y, const float in1, const float in2) {
+      if (!flagged[x][y]) return;
+      float &outer = z[x][y];
+      const float expect = 2.0f * in1 - in2, d = outer - expect;
+      if (isnan(d) || ABS(d) <= MESH_FILTER_EDGE_SLOPE) return;
+      outer = expect + (d > 0 ? MESH_FILTER_EDGE_SLOPE : -MESH_FILTER_EDGE_SLOPE);
+      changed++;
+    };
+    LOOP_L_N(y, MESH_Y) {
+      bend(0, y, z[1][y], z[2][y]);
+      bend(MESH_X - 1, y, z[MESH_X - 2][y], z[MESH_X - 3][y]);
+    }
+    LOOP_L_N(x, MESH_X) {
+      bend(x, 0, z[x][1], z[x][2]);
+      bend(x, MESH_Y - 1, z[x][MESH_Y - 2], z[x][MESH_Y - 3]);
+    }
+    return changed;
+  #else
+    UNUSED(z); UNUSED(flagged);
+    return 0;
+  #endif
+}
+
+/**
+ * @brief  Separable 1-2-1 smoothing, Y then X. The edges repeat the outer point.
+ * @param  z mesh
+ * @retval None
+ */
+void Anker_Mesh_Filter::smooth(bed_mesh_t &z) {
+  // Along Y, a column is contiguous in bed_mesh_t
+  LOOP_L_N(x, MESH_X) {
+    float *c = z[x], prev = c[0];
+    LOOP_L_N(y, MESH_Y) {
+      const float cur = c[y], next = c[y < MESH_Y - 1 ? y + 1 : y];
+      c[y] = (prev + 2.0f * cur + next) * 0.25f;
+      prev = cur;
+    }
+  }
+
+  // Along X, a whole column at a time
+  float prev[MESH_Y], cur[MESH_Y];
+  COPY(prev, z[0]);
+  LOOP_L_N(x, MESH_X) {
+    COPY(cur, z[x]);
+    const float *next = x < MESH_X - 1 ? z[x + 1] : cur;
+    LOOP_L_N(y, MESH_Y) z[x][y] = (prev[y] + 2.0f * cur[y] + next[y]) * 0.25f;
+    COPY(prev, cur);
+  }
+}
+
+/**
+ * @brief  Least squares plane, libs/least_squares_fit
+ * @param  z mesh
+ * @param  c fit, c[3..5] are 0
+ * @retval true if the fit is valid
+ */
+bool Anker_Mesh_Filter::fit_plane(const bed_mesh_t &z, float c[6]) {
+  linear_fit_data lsf;
+  incremental_LSF_reset(&lsf);
+  GRID_LOOP(x, y) if (!isnan(z[x][y])) incremental_LSF(&lsf, MESH_U(x, MESH_X), MESH_U(y, MESH_Y), z[x][y]);
+  if (finish_incremental_LSF(&lsf)) return false;
+  // The fit is A*x + B*y + z + D = 0
+  c[0] = -lsf.D; c[1] = -lsf.A; c[2] = -lsf.B;
+  c[3] = c[4] = c[5] = 0;
+  return true;
+}
+
+/**
+ * @brief  Least squares quadric, the 6x6 normal equations by Gaussian elimination
+ * @param  z mesh
+ * @param  c fit
+ * @retval true if the fit is valid
+ */
+bool Anker_Mesh_Filter::fit_quadric(const bed_mesh_t &z, float c[6]) {
+  float m[6][7] = { { 0 } };
+  GRID_LOOP(x, y) {
+    if (isnan(z[x][y])) continue;
+    const float u = MESH_U(x, MESH_X), v = MESH_U(y, MESH_Y),
+                phi[6] = { 1.0f, u, v, u * u, u * v, v * v };
+    LOOP_L_N(r, 6) {
+      LOOP_S_L_N(k, r, 6) m[r][k] += phi[r] * phi[k];
+      m[r][6] += phi[r] * z[x][y];
+    }
+  }
+  LOOP_L_N(r, 6) LOOP_L_N(k, r) m[r][k] = m[k][r];
+
+  LOOP_L_N(p, 6) {
+    uint8_t best = p;
+    LOOP_S_L_N(r, p + 1, 6) if (ABS(m[r][p]) > ABS(m[best][p])) best = r;
+    if (ABS(m[best][p]) < 1e-6f) return false;
+    if (best != p) LOOP_L_N(k, 7) { const float t = m[p][k]; m[p][k] = m[best][k]; m[best][k] = t; }
+    LOOP_S_L_N(r, p + 1, 6) {
+      const float f = m[r][p] / m[p][p];
+      LOOP_S_L_N(k, p, 7) m[r][k] -= f * m[p][k];
+    }
+  }
+  for (int8_t r = 5; r >= 0; r--) {
+    float s = m[r][6];
+    LOOP_S_L_N(k, r + 1, 6) s -= m[r][k] * c[k];
+    c[r] = s / m[r][r];
+  }
+  return true;
+}
+
+/**
+ * @brief  RMS and peak to valley of the mesh minus a fit
+ * @param  z mesh
+ * @param  c fit
+ * @param  pv peak to valley (mm)
+ * @retval RMS (mm)
+ */
+float Anker_Mesh_Filter::fit_residual(const bed_mesh_t &z, const float c[6], float &pv) {
+  float sum = 0, lo = 0, hi = 0;
+  uint8_t n = 0;
+  GRID_LOOP(x, y) {
+    if (isnan(z[x][y])) continue;
+    const float u = MESH_U(x, MESH_X), v = MESH_U(y, MESH_Y),
+                r = z[x][y] - (c[0] + c[1] * u + c[2] * v + c[3] * u * u + c[4] * u * v + c[5] * v * v);
+    if (!n || r < lo) lo = r;
+    if (!n || r > hi) hi = r;
+    sum += sq(r);
+    n++;
+  }
+  pv = hi - lo;
+  return n ? SQRT(sum / n) : 0;
+}
+
+/**
+ * @brief  Cleanup after G29
+ * @param  z mesh
+ * @retval number of points changed
+ */
+uint8_t Anker_Mesh_Filter::process(bed_mesh_t &z) {
+  mesh_flags_t flagged;
+  const uint8_t outliers = reject_outliers(z, &flagged), edges = refine_edges(z, flagged);
+  if (outliers || edges) SERIAL_ECHOLNPAIR("Mesh filter outliers:", outliers, " edges:", edges);
+  return outliers + edges;
+}
+
+// Tilt and bow of the bed, over half the grid
+void Anker_Mesh_Filter::report(const bed_mesh_t &z) {
+  float c[6], pv;
+  if (fit_plane(z, c)) {
+    SERIAL_ECHOPAIR_F("Mesh plane tilt x:", c[1], 3);
+    SERIAL_ECHOPAIR_F(" y:", c[2], 3);
+    SERIAL_ECHOPAIR_F(" rms:", fit_residual(z, c, pv), 3);
+    SERIAL_ECHOLNPAIR_F(" pv:", pv, 3);
+  }
+  if (fit_quadric(z, c)) {
+    SERIAL_ECHOPAIR_F("Mesh quadric bow xx:", c[3], 3);
+    SERIAL_ECHOPAIR_F(" xy:", c[4], 3);
+    SERIAL_ECHOPAIR_F(" yy:", c[5], 3);
+    SERIAL_ECHOPAIR_F(" rms:", fit_residual(z, c, pv), 3);
+    SERIAL_ECHOLNPAIR_F(" pv:", pv, 3);
+  }
+}
+
+#endif
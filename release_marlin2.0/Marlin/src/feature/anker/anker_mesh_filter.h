@@ -0,0 +1,46 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 15:06:31
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 15:06:31
+ * @Description  : Leveling mesh cleanup, outlier rejection, smoothing, plane / quadric fit
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_FILTER_LEVEL_GRID) && ENABLED(AUTO_BED_LEVELING_BILINEAR)
+
+#include "../bedlevel/bedlevel.h"
+
+#define MESH_FILTER_MAD_K       3.0f  // A point is an outlier over MAD_K robust sigmas from its neighbours...
+#define MESH_FILTER_NOISE       0.3f  // (mm) ...and over this from them
+#define MESH_FILTER_EDGE_NOISE  0.35f // (mm) Same for the outer ring, it has fewer neighbours
+#define MESH_FILTER_EDGE_SLOPE  0.1f  // (mm) Largest bend of the outer step of an outlier, EXTRAPOLATE_BEYOND_GRID carries it past the grid
+
+typedef bool mesh_flags_t[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
+
+/**
+ * Every pass works on z_values in place with no allocation, row by row over bed_mesh_t.
+ * process() is the cleanup after G29: outliers, then the edge outliers the leveling extrapolates.
+ * Fits use -1..1 grid coordinates: z = c[0] + c[1]x + c[2]y + c[3]x^2 + c[4]xy + c[5]y^2
+ */
+class Anker_Mesh_Filter {
+  public:
+    static float noise, edge_noise, mad_k;
+
+    static uint8_t reject_outliers(bed_mesh_t &z, mesh_flags_t *flagged=nullptr);
+    static uint8_t refine_edges(bed_mesh_t &z, const mesh_flags_t &flagged);
+    static void smooth(bed_mesh_t &z);
+
+    static bool fit_plane(const bed_mesh_t &z, float c[6]);
+    static bool fit_quadric(const bed_mesh_t &z, float c[6]);
+    static float fit_residual(const bed_mesh_t &z, const float c[6], float &pv);
+
+    static uint8_t process(bed_mesh_t &z);
+    static void report(const bed_mesh_t &z);
+};
+
+extern Anker_Mesh_Filter anker_mesh_filter;
+
+#endif
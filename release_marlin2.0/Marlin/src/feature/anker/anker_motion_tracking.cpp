@@ -12,6 +12,7 @@
 #include "../../core/serial.h"
 #include "../../module/planner.h"
 #include "../../module/stepper.h"
+#include "anker_isr_profile.h"
 
 #ifdef DEBUG_TP172
   #define TP172_INIT()    pinMode(DEBUG_TP172, OUTPUT)
@@ -124,13 +125,21 @@ Motion_Track motion_track;
   * @retval None
   */
 HAL_MOTION_TRACK_ISR() { // Consume time = 750ns 
+  ISR_PROFILE(PROF_MOTION_TRACK_ISR);
   TP173_HIGH();
   HAL_timer_isr_prologue(MOTION_TRACK_TIMER_NUM);
   if(m_track.count < POS_LEN-1){
-    m_track.p.pos[m_track.head].x =  stepper.position(X_AXIS);//16909060;//
-    m_track.p.pos[m_track.head].y =  stepper.position(Y_AXIS);//84281096;//
-    m_track.p.pos[m_track.head].z =  stepper.position(Z_AXIS);//151653132;//
-    m_track.p.pos[m_track.head].e =  stepper.position(E_AXIS);//270544960;//
+    #if ENABLED(ANKER_STEPPER_SNAPSHOT)
+      // One stepper isr run for all four axes, this isr can preempt it between two of them
+      stepper_snapshot_t snap;
+      stepper.snapshot(snap);
+      m_track.p.pos[m_track.head] = snap.pos;
+    #else
+      m_track.p.pos[m_track.head].x =  stepper.position(X_AXIS);//16909060;//
+      m_track.p.pos[m_track.head].y =  stepper.position(Y_AXIS);//84281096;//
+      m_track.p.pos[m_track.head].z =  stepper.position(Z_AXIS);//151653132;//
+      m_track.p.pos[m_track.head].e =  stepper.position(E_AXIS);//270544960;//
+    #endif
     m_track.ms_tick++;//0xf0f0f0f0;//
     m_track.p.ms[m_track.head] = m_track.ms_tick;
     m_track.head = (m_track.head + 1) % POS_LEN;
@@ -146,15 +155,24 @@ void Motion_Track::block_info_record(const void* ptr) { // 800NS
     if(PLR_TRACK == m_track.mode && m_track.count < PLR_LEN-1){// Trigger and close block information record by G0_1 W<active>
       const block_t* currentbBlock = (const block_t*)ptr; // To convert a `void*` pointer to a `const block_t*` pointer
       planner_track_t* pbuff = &(m_track.l[m_track.head]);
-      pbuff->nominal_speed_sqr = currentbBlock->nominal_speed_sqr;
-      pbuff->entry_speed_sqr = currentbBlock->entry_speed_sqr;
-      pbuff->max_entry_speed_sqr = currentbBlock->max_entry_speed_sqr;
-      pbuff->millimeters = currentbBlock->millimeters;
-      pbuff->acceleration = currentbBlock->acceleration;
-      pbuff->la_advance_rate = currentbBlock->la_advance_rate;
-      pbuff->max_adv_steps = currentbBlock->max_adv_steps;
-      pbuff->final_adv_steps = currentbBlock->final_adv_steps;
-      pbuff->la_current = currentbBlock->la_segment;
+      const block_plan_t &plan = planner.plan_of(currentbBlock);
+      pbuff->nominal_speed_sqr = plan.nominal_speed_sqr;
+      pbuff->entry_speed_sqr = plan.entry_speed_sqr;
+      pbuff->max_entry_speed_sqr = plan.max_entry_speed_sqr;
+      pbuff->millimeters = plan.millimeters;
+      pbuff->acceleration = plan.acceleration;
+      if (currentbBlock->la_version >= LIN_ADV_VERSION_2) {
+        pbuff->la_advance_rate = currentbBlock->la_advance_rate;
+        pbuff->max_adv_steps = currentbBlock->max_adv_steps_v1;
+        pbuff->final_adv_steps = currentbBlock->final_adv_steps_v1;
+        pbuff->la_current = currentbBlock->la_segment;
+      }
+      else {
+        pbuff->la_advance_rate = 0;
+        pbuff->max_adv_steps = currentbBlock->max_adv_steps;
+        pbuff->final_adv_steps = currentbBlock->final_adv_steps;
+        LA_CLEAR_SEGMENT(pbuff->la_current);
+      }
       pbuff->nominal_rate = currentbBlock->nominal_rate;
       pbuff->initial_rate = currentbBlock->initial_rate;
       pbuff->final_rate = currentbBlock->final_rate;
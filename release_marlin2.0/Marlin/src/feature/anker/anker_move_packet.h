@@ -0,0 +1,70 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 17:58:40
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 17:58:40
+ * @Description  : Move packet format, shared by the firmware and the host G-code prepass
+ */
+#pragma once
+
+/**
+ * Plain C++ with no Marlin configuration, the host prepass (feature/anker/prepass) builds
+ * the packets with it and anker_move_stream reads them.
+ *
+ * Frame, on uart1 next to the '@' command packs and the '#' step pages:
+ *   '%' <records> <len lo> <len hi> <payload[len]> <crc hi> <crc lo>
+ * crc16 of the multi packs over records..payload. The '%' opens a frame only at the start of
+ * a line: first char, or after an EOL or another frame, see GCodeQueue::multi_pack_recv().
+ *
+ * Payload, little endian, positions in MOVE_PACKET_UNITS of native machine coordinates:
+ *   header : start[XYZE] int32, zlev int32, end[XYZE] int32
+ *            start and end are current_position before and after the packet, unleveled.
+ *            The moves start from the leveled position, start with zlev added to Z. The
+ *            firmware checks zlev against its own leveling at start, see anker_move_stream.h.
+ *   record : <flags> then, in this order, for each flag set
+ *            MOVE_X..MOVE_E : int32 delta of the leveled position
+ *            MOVE_FR        : uint16 feedrate in 0.1 mm/s, kept for the next records
+ *            MOVE_MM        : uint32 length of the unleveled segment for the planner
+ * The host has done the units, relative / absolute modes, G92, arcs, the leveled segments and
+ * the leveling itself. The moves go to planner.buffer_segment() as they are.
+ */
+#include <stdint.h>
+
+#define MOVE_PACKET_SYNC      '%'
+#define MOVE_PACKET_MAX       512     // Payload bytes
+#define MOVE_PACKET_UNITS     10000.0f // Position units per mm
+#define MOVE_PACKET_FR_UNITS  10.0f   // Feedrate units per mm/s
+#define MOVE_PACKET_HEADER    36
+
+enum MovePacketFlag : uint8_t {
+  MOVE_X  = 1 << 0,
+  MOVE_Y  = 1 << 1,
+  MOVE_Z  = 1 << 2,
+  MOVE_E  = 1 << 3,
+  MOVE_FR = 1 << 4,
+  MOVE_MM = 1 << 5
+};
+
+// The multi pack crc16 of gcode/queue.cpp
+static inline uint16_t move_packet_crc(uint16_t crc, const uint8_t *buf, uint16_t count) {
+  static const uint16_t table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+  };
+  while (count--) {
+    crc = (crc << 4) ^ table[(crc >> 12) ^ (*buf >> 4)];
+    crc = (crc << 4) ^ table[(crc >> 12) ^ (*buf & 0x0F)];
+    buf++;
+  }
+  return crc;
+}
+
+static inline void move_packet_put(uint8_t *&p, const uint32_t v, const uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; i++) *p++ = uint8_t(v >> (8 * i));
+}
+
+static inline uint32_t move_packet_get(const uint8_t *&p, const uint8_t bytes) {
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < bytes; i++) v |= uint32_t(*p++) << (8 * i);
+  return v;
+}
@@ -0,0 +1,223 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 17:58:40
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 17:58:40
+ * @Description  : Pre-leveled, pre-segmented move packets from the host, straight into the planner
+ */
+#include "anker_move_stream.h"
+
+#if BOTH(ANKER_MOVE_PACKET, ANKER_MULTIORDER_PACK)
+
+#include "../../core/serial.h"
+#include "../../gcode/queue.h"
+#include "../../module/motion.h"
+#include "../../module/planner.h"
+#include "../../module/temperature.h"
+
+#if IS_KINEMATIC
+  #error "ANKER_MOVE_PACKET is for Cartesian machines, the host prepass does no kinematics."
+#elif DISABLED(SEGMENT_LEVELED_MOVES) || DISABLED(ARC_SUPPORT)
+  #error "ANKER_MOVE_PACKET needs SEGMENT_LEVELED_MOVES and ARC_SUPPORT, the host prepass does both."
+#endif
+
+Anker_Move_Stream anker_move_stream;
+
+uint32_t Anker_Move_Stream::frames, Anker_Move_Stream::errors,
+         Anker_Move_Stream::mismatches, Anker_Move_Stream::moves,
+         Anker_Move_Stream::packets, Anker_Move_Stream::rejects;
+MoveStreamError Anker_Move_Stream::error;
+Anker_Move_Stream::move_slot_t Anker_Move_Stream::slot[MOVE_STREAM_SLOTS];
+volatile uint8_t Anker_Move_Stream::head, Anker_Move_Stream::tail, Anker_Move_Stream::count;
+Anker_Move_Stream::FrameState Anker_Move_Stream::state = FRAME_IDLE;
+uint16_t Anker_Move_Stream::len, Anker_Move_Stream::received, Anker_Move_Stream::crc, Anker_Move_Stream::crc_rx;
+bool Anker_Move_Stream::bad;
+millis_t Anker_Move_Stream::last_ms;
+
+// The stream stops on e, the host is told and has to resync with M4904 S
+void Anker_Move_Stream::halt(const MoveStreamError e) {
+  error = e;
+  rejects++;
+  MYSERIAL2.printLine("+moveerr:%d,%d\n", (int)e, (int)packets);
+}
+
+// A good frame takes its slot and queues the M4904 that runs it, none while halted
+void Anker_Move_Stream::finish(bool ok, const int port) {
+  UNUSED(port);
+  state = FRAME_IDLE;
+  if (ok && error) { halt(error); return; }
+  if (ok) ok = queue.ring_buffer.enqueue("M4904", true OPTARG(HAS_MULTI_SERIAL, serial_index_t(port)));
+  if (ok) {
+    if (++head >= MOVE_STREAM_SLOTS) head = 0;
+    count++;
+    frames++;
+  }
+  else {
+    errors++;
+    MYSERIAL2.printLine("Request retry\r\n");
+  }
+}
+
+/**
+ * @brief  Move frame receiver, fed every uart1 char outside of a '@' pack
+ * @param  c received char
+ * @param  sync c is at the start of a line, only there a '%' opens a frame ("M117 50% done" stays text)
+ * @param  port serial port of the frame, for the queued M4904
+ * @retval true if the char belongs to a move frame
+ */
+bool Anker_Move_Stream::recv(const int c, const bool sync, const int port) {
+  if (state != FRAME_IDLE && ELAPSED(millis(), last_ms + MOVE_STREAM_TIMEOUT_MS)) {
+    MYSERIAL2.printLine("Move frame timeout\r\n");
+    finish(false, port);
+  }
+  if (c < 0) return false;
+  if (state == FRAME_IDLE && (!sync || c != MOVE_PACKET_SYNC)) return false;
+  last_ms = millis();
+
+  const uint8_t b = c;
+  if (state < FRAME_CRC_H && state != FRAME_IDLE) crc = move_packet_crc(crc, &b, 1);
+
+  move_slot_t &s = slot[head];
+  switch (state) {
+    case FRAME_IDLE:
+      crc = 0;
+      state = FRAME_RECORDS;
+      break;
+    case FRAME_RECORDS:
+      s.records = b;
+      state = FRAME_LEN_L;
+      break;
+    case FRAME_LEN_L:
+      len = b;
+      state = FRAME_LEN_H;
+      break;
+    case FRAME_LEN_H:
+      len |= uint16_t(b) << 8;
+      received = 0;
+      // No free slot: the frame is read and dropped, the host waits for +movebuf
+      bad = count >= MOVE_STREAM_SLOTS || len <= MOVE_PACKET_HEADER || len > MOVE_PACKET_MAX;
+      s.len = len;
+      state = FRAME_DATA;
+      break;
+    case FRAME_DATA:
+      if (!bad) s.buf[received] = b;
+      if (++received >= len) state = FRAME_CRC_H;
+      break;
+    case FRAME_CRC_H:
+      crc_rx = uint16_t(b) << 8;
+      state = FRAME_CRC_L;
+      break;
+    case FRAME_CRC_L:
+      crc_rx |= b;
+      finish(!bad && crc_rx == crc, port);
+      break;
+  }
+  return true;
+}
+
+/**
+ * @brief  M4904, the records of the oldest slot into the planner
+ * @retval None
+ */
+void Anker_Move_Stream::run() {
+  if (!count) return;
+
+  const move_slot_t &s = slot[tail];
+  const uint8_t *p = s.buf, * const p_end = s.buf + s.len;
+  int32_t pos[XYZE], end[XYZE];
+  xyze_pos_t start;
+  LOOP_L_N(i, XYZE) {
+    pos[i] = move_packet_get(p, 4);
+    start[i] = pos[i] / MOVE_PACKET_UNITS;
+  }
+  const int32_t zlev = move_packet_get(p, 4);
+  pos[Z_AXIS] += zlev;
+  LOOP_L_N(i, XYZE) end[i] = move_packet_get(p, 4);
+
+  // The host leveled the moves, it must have done it as the firmware does now
+  if (!error) {
+    xyz_pos_t lev = start;
+    planner.apply_leveling(lev);
+    if (ABS(lev.z - start.z - zlev / MOVE_PACKET_UNITS) > MOVE_STREAM_ZLEV_TOLERANCE) error = MOVE_ERR_LEVELING;
+  }
+  if (error) {
+    halt(error);
+    if (++tail >= MOVE_STREAM_SLOTS) tail = 0;
+    count--;
+    return;
+  }
+
+  bool ok = true;
+  abce_pos_t target;
+
+  // Not where the host thought, travel to the start with E set there
+  bool off = false;
+  LOOP_L_N(i, XYZE) if (ABS(start[i] - current_position[i]) > MOVE_STREAM_TOLERANCE) off = true;
+  if (off) {
+    mismatches++;
+    LOOP_L_N(i, XYZE) target[i] = pos[i] / MOVE_PACKET_UNITS;
+    planner.set_e_position_mm(target.e);
+    ok = planner.buffer_segment(target, MMS_SCALED(feedrate_mm_s), active_extruder);
+  }
+
+  // PREVENT_COLD_EXTRUSION of prepare_line_to_destination(), the E moves are skipped
+  const bool cold = TERN0(PREVENT_COLD_EXTRUSION, !DEBUGGING(DRYRUN) && thermalManager.tooColdToExtrude(active_extruder));
+  bool cold_msg = false;
+
+  feedRate_t fr_mm_s = feedrate_mm_s;
+  for (uint8_t r = 0; ok && r < s.records && p < p_end; r++) {
+    const uint8_t flags = *p++;
+    LOOP_L_N(i, XYZE) if (TEST(flags, i)) pos[i] += int32_t(move_packet_get(p, 4));
+    if (flags & MOVE_FR) fr_mm_s = move_packet_get(p, 2) / MOVE_PACKET_FR_UNITS;
+    const float mm = (flags & MOVE_MM) ? move_packet_get(p, 4) / MOVE_PACKET_UNITS : 0.0f;
+    if (p > p_end) { errors++; break; }                 // CRC good but the host wrote it wrong
+
+    LOOP_L_N(i, XYZE) target[i] = pos[i] / MOVE_PACKET_UNITS;
+    if (cold && (flags & MOVE_E)) {
+      if (!cold_msg) { cold_msg = true; SERIAL_ECHO_MSG(STR_ERR_COLD_EXTRUDE_STOP); }
+      planner.set_e_position_mm(target.e);
+    }
+    if (!planner.buffer_segment(target, MMS_SCALED(fr_mm_s), active_extruder, mm)) { ok = false; break; } // Quick stop, the position is resynced there
+    moves++;
+  }
+
+  if (ok) {
+    LOOP_L_N(i, XYZE) current_position[i] = end[i] / MOVE_PACKET_UNITS;
+    feedrate_mm_s = fr_mm_s;
+    packets++;
+  }
+
+  if (++tail >= MOVE_STREAM_SLOTS) tail = 0;
+  count--;
+}
+
+// GCodeQueue::clear(), the slots go with the M4904s that would have run them
+void Anker_Move_Stream::clear() {
+  head = tail = count = 0;
+  state = FRAME_IDLE;
+}
+
+void Anker_Move_Stream::report() {
+  MYSERIAL2.printLine("+movebuf:%d,%d,%d,%d\n", free_slots(), MOVE_STREAM_SLOTS, (int)errors, (int)error);
+}
+
+/**
+ * @brief  M4904 C, what the host prepass has to do like the firmware, read by its --config:
+ *         "+moveconf:<segment mm>,<arc min mm>,<arc max mm>,<circle segments>,<soft endstops>,
+ *         <min x>,<min y>,<min z>,<max x>,<max y>,<max z>,<leveling>,<fade height>,<fade hold>"
+ * @retval None
+ */
+void Anker_Move_Stream::report_config() {
+  xyz_pos_t lo{0}, hi{0};
+  #if HAS_SOFTWARE_ENDSTOPS
+    lo = soft_endstop.min;
+    hi = soft_endstop.max;
+  #endif
+  MYSERIAL2.printLine("+moveconf:%.3f,%.3f,%.3f,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.3f,%.3f\n",
+    float(LEVELED_SEGMENT_LENGTH), float(MIN_ARC_SEGMENT_MM), float(MAX_ARC_SEGMENT_MM), MIN_CIRCLE_SEGMENTS,
+    (int)soft_endstop.enabled(), lo.x, lo.y, lo.z, hi.x, hi.y, hi.z,
+    (int)TERN0(HAS_LEVELING, planner.leveling_active), TERN0(ENABLE_LEVELING_FADE_HEIGHT, planner.z_fade_height),
+    float(TERN0(ANKER_LEVEING_FADE, LEVELING_FADE_HOLD_Z)));
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 17:58:40
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 17:58:40
+ * @Description  : Pre-leveled, pre-segmented move packets from the host, straight into the planner
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if BOTH(ANKER_MOVE_PACKET, ANKER_MULTIORDER_PACK)
+
+#include "anker_move_packet.h"
+
+/**
+ * The host prepass (feature/anker/prepass) turns G0-G3 into move packets, see anker_move_packet.h.
+ * A frame is unpacked straight into a free slot, then M4904 is queued behind the commands
+ * already received, so the moves keep their place among the '@' commands. M4904 hands the
+ * records of the oldest slot to planner.buffer_segment(), the G-code parser, the leveling,
+ * the arc and segment loops are not run for them.
+ * Free slots go back with the "+movebuf:<free>,<total>,<bad frames>,<error>" line of the ring
+ * buffer report, error is the MoveStreamError that halted the stream, 0 while it runs.
+ * A packet that does not start at current_position travels to its start first, E is set there
+ * and nothing is extruded on the way, then it runs.
+ * A packet leveled otherwise than the firmware would (its zlev against planner.apply_leveling()
+ * at the start: a stale mesh, leveling or fade changed by G28, G29, M420) halts the stream. The
+ * host gets "+moveerr:<error>,<packets run>" for it and for every frame after, none of them
+ * runs until the host has dealt with it and sent M4904 S, from the packet after the last run.
+ */
+#define MOVE_STREAM_SLOTS       4
+#define MOVE_STREAM_TIMEOUT_MS  180
+#define MOVE_STREAM_TOLERANCE   0.001f  // (mm) start of a packet against current_position
+#define MOVE_STREAM_ZLEV_TOLERANCE 0.005f // (mm) leveling of the host against the firmware at the start
+
+enum MoveStreamError : uint8_t {
+  MOVE_ERR_NONE,
+  MOVE_ERR_LEVELING         // zlev is not the firmware leveling at the start of the packet
+};
+
+class Anker_Move_Stream {
+  public:
+    static uint32_t frames, errors, mismatches, moves, packets, rejects;
+    static MoveStreamError error;
+
+    static bool recv(const int c, const bool sync, const int port);
+    static bool busy() { return state != FRAME_IDLE; }
+    static void run();
+    static void clear();
+    static void resync() { error = MOVE_ERR_NONE; }
+    static uint8_t free_slots() { return MOVE_STREAM_SLOTS - count; }
+    static void report();
+    static void report_config();
+
+  private:
+    enum FrameState : uint8_t {
+      FRAME_IDLE, FRAME_RECORDS, FRAME_LEN_L, FRAME_LEN_H, FRAME_DATA, FRAME_CRC_H, FRAME_CRC_L
+    };
+
+    typedef struct {
+      uint8_t buf[MOVE_PACKET_MAX];
+      uint16_t len;
+      uint8_t records;
+    } move_slot_t;
+
+    static move_slot_t slot[MOVE_STREAM_SLOTS];
+    static volatile uint8_t head, tail, count;
+
+    static FrameState state;
+    static uint16_t len, received, crc, crc_rx;
+    static bool bad;
+    static millis_t last_ms;
+
+    static void finish(const bool ok, const int port);
+    static void halt(const MoveStreamError e);
+};
+
+extern Anker_Move_Stream anker_move_stream;
+
+#endif
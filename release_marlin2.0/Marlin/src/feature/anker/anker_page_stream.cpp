@@ -0,0 +1,133 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:02:17
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:02:17
+ * @Description  : Direct stepping pages from the host over the multi pack uart
+ */
+#include "anker_page_stream.h"
+
+#if BOTH(DIRECT_STEPPING, ANKER_MULTIORDER_PACK)
+
+#include "../direct_stepping.h"
+#include "../../core/serial.h"
+
+// gcode/queue.cpp, the multi pack checksum
+extern unsigned short crc16(unsigned short initval, void *pdata, unsigned int count);
+
+static_assert(DirectStepping::Config::NUM_PAGES <= 256, "The page frame has a 1 byte page index.");
+
+#define PAGE_BYTES DirectStepping::Config::PAGE_SIZE
+#define PAGE_FRAME_MAX (PAGE_BYTES + PAGE_BYTES / 128 + 1)  // Largest payload, PackBits of a page of literals
+
+Anker_Page_Stream anker_page_stream;
+
+uint32_t Anker_Page_Stream::frames, Anker_Page_Stream::errors;
+Anker_Page_Stream::FrameState Anker_Page_Stream::state = FRAME_IDLE;
+uint8_t Anker_Page_Stream::page_idx, Anker_Page_Stream::codec, *Anker_Page_Stream::page;
+uint16_t Anker_Page_Stream::len, Anker_Page_Stream::count, Anker_Page_Stream::out,
+         Anker_Page_Stream::run, Anker_Page_Stream::crc, Anker_Page_Stream::crc_rx;
+bool Anker_Page_Stream::repeat, Anker_Page_Stream::bad;
+millis_t Anker_Page_Stream::last_ms;
+
+// One payload byte into the page, bad is set on an overrun
+void Anker_Page_Stream::unpack(const uint8_t c) {
+  auto put = [](const uint8_t b) {
+    if (out < PAGE_BYTES) page[out++] = b; else bad = true;
+  };
+
+  if (codec == PAGE_CODEC_RAW) { put(c); return; }
+
+  if (run) {                  // Inside a literal or waiting for the repeated byte
+    if (repeat) {
+      while (run) { put(c); run--; }
+    }
+    else {
+      put(c);
+      run--;
+    }
+  }
+  else if (c < 128) {
+    run = c + 1;
+    repeat = false;
+  }
+  else if (c > 128) {
+    run = 257 - c;
+    repeat = true;
+  }
+}
+
+// A rejected frame leaves its page FAIL for the host to send again. A page still in use keeps its state.
+void Anker_Page_Stream::finish(const bool ok) {
+  if (page) page_manager.end_write(page_idx, ok);
+  else if (state > FRAME_PAGE) MYSERIAL2.printLine("Page frame %d dropped, page in use\r\n", page_idx);
+  if (ok) frames++; else errors++;
+  page = nullptr;
+  state = FRAME_IDLE;
+}
+
+/**
+ * @brief  Page frame receiver, fed every uart1 char outside of a '@' pack
+ * @param  c received char
+ * @param  sync c is at the start of a line, only there a '#' opens a frame
+ * @retval true if the char belongs to a page frame
+ */
+bool Anker_Page_Stream::recv(const int c, const bool sync) {
+  if (state != FRAME_IDLE && ELAPSED(millis(), last_ms + PAGE_STREAM_TIMEOUT_MS)) {
+    MYSERIAL2.printLine("Page frame timeout\r\n");
+    finish(false);
+  }
+  if (c < 0) return false;
+  if (state == FRAME_IDLE && (!sync || c != '#')) return false;
+  last_ms = millis();
+
+  uint8_t b = c;
+  if (state < FRAME_CRC_H && state != FRAME_IDLE) crc = crc16(crc, &b, 1);
+
+  switch (state) {
+    case FRAME_IDLE:
+      crc = 0;
+      state = FRAME_PAGE;
+      break;
+    case FRAME_PAGE:
+      // Even a bad frame takes its page, to FAIL it. A page still queued or stepping is never
+      // overwritten, the frame is read and dropped.
+      page_idx = b;
+      page = (uint8_t*)page_manager.begin_write(page_idx);
+      state = FRAME_CODEC;
+      break;
+    case FRAME_CODEC:
+      codec = b;
+      state = FRAME_LEN_L;
+      break;
+    case FRAME_LEN_L:
+      len = b;
+      state = FRAME_LEN_H;
+      break;
+    case FRAME_LEN_H:
+      len |= uint16_t(b) << 8;
+      count = out = run = 0;
+      bad = !page || codec > PAGE_CODEC_PACKBITS || !len || len > PAGE_FRAME_MAX;
+      if (len > PAGE_FRAME_MAX) {
+        finish(false);            // No end to wait for, the next '#' line resyncs
+        break;
+      }
+      state = len ? FRAME_DATA : FRAME_CRC_H;
+      break;
+    case FRAME_DATA:
+      if (!bad) unpack(b);
+      if (++count >= len) state = FRAME_CRC_H;
+      break;
+    case FRAME_CRC_H:
+      crc_rx = uint16_t(b) << 8;
+      state = FRAME_CRC_L;
+      break;
+    case FRAME_CRC_L:
+      crc_rx |= b;
+      finish(!bad && !run && out == PAGE_BYTES && crc_rx == crc);
+      break;
+  }
+  return true;
+}
+
+#endif
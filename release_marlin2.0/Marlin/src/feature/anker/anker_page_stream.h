@@ -0,0 +1,60 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:02:17
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:02:17
+ * @Description  : Direct stepping pages from the host over the multi pack uart
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if BOTH(DIRECT_STEPPING, ANKER_MULTIORDER_PACK)
+
+/**
+ * The host plans the moves, shaping and pressure advance included, and sends step pages.
+ * A page frame shares uart1 with the '@' command packs and the '%' move frames:
+ *   '#' <page> <codec> <len lo> <len hi> <payload[len]> <crc hi> <crc lo>
+ * The '#' opens a frame only at the start of a line, see GCodeQueue::multi_pack_recv().
+ * crc16 of the multi packs over page..payload. Codec 0 is the raw page, 1 is PackBits:
+ *   header n < 128 : n + 1 literal bytes follow
+ *   header n > 128 : the next byte repeats 257 - n times
+ * Idle axes are runs of zero, a page usually shrinks several times.
+ * The payload is unpacked straight into the page, there is no frame buffer.
+ * Page states go back with the usual '!' responses, the free page count with M2021.
+ * A frame is only OK with a full PAGE_SIZE page and a good crc. Any other frame leaves its page
+ * FAIL, a FAIL page is sent again, G6 then steps it as a normal page. A frame for a page still in
+ * use is dropped with a "Page frame <n> dropped" line and the page keeps its state.
+ */
+#define PAGE_STREAM_TIMEOUT_MS 180
+
+enum PageCodec : uint8_t {
+  PAGE_CODEC_RAW = 0,
+  PAGE_CODEC_PACKBITS = 1
+};
+
+class Anker_Page_Stream {
+  public:
+    static uint32_t frames, errors;
+
+    static bool recv(const int c, const bool sync);
+    static bool busy() { return state != FRAME_IDLE; }
+
+  private:
+    enum FrameState : uint8_t {
+      FRAME_IDLE, FRAME_PAGE, FRAME_CODEC, FRAME_LEN_L, FRAME_LEN_H, FRAME_DATA, FRAME_CRC_H, FRAME_CRC_L
+    };
+
+    static FrameState state;
+    static uint8_t page_idx, codec, *page;
+    static uint16_t len, count, out, run, crc, crc_rx;
+    static bool repeat, bad;
+    static millis_t last_ms;
+
+    static void unpack(const uint8_t c);
+    static void finish(const bool ok);
+};
+
+extern Anker_Page_Stream anker_page_stream;
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 16:48:05
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 16:48:05
+ * @Description  : Probe trigger timestamp and the Z between the steps around it
+ */
+#include "anker_probe_capture.h"
+
+#if ENABLED(ANKER_PROBE_CAPTURE)
+
+#include "../../core/serial.h"
+#include "../../module/planner.h"
+#include "../../module/stepper.h"
+
+static_assert(IS_POWER_OF_2(PROBE_CAPTURE_STEPS), "PROBE_CAPTURE_STEPS must be a power of 2.");
+
+#define CAPTURE_TICKS_PER_US (float(F_CPU) / 1000000.0f)
+
+Anker_Probe_Capture probe_capture;
+
+uint32_t Anker_Probe_Capture::captures, Anker_Probe_Capture::late;
+float Anker_Probe_Capture::latency_us, Anker_Probe_Capture::latency_max_us;
+float Anker_Probe_Capture::overshoot, Anker_Probe_Capture::overshoot_max;
+
+probe_capture_step_t Anker_Probe_Capture::ring[PROBE_CAPTURE_STEPS];
+volatile uint32_t Anker_Probe_Capture::head;
+volatile bool Anker_Probe_Capture::armed, Anker_Probe_Capture::level,
+              Anker_Probe_Capture::edge_valid, Anker_Probe_Capture::stopped;
+volatile uint32_t Anker_Probe_Capture::edge_t, Anker_Probe_Capture::stop_t;
+bool Anker_Probe_Capture::valid;
+float Anker_Probe_Capture::trigger_steps;
+int32_t Anker_Probe_Capture::stop_steps;
+
+// Start the DWT cycle counter, shared with ANKER_ISR_PROFILE
+void Anker_Probe_Capture::init() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  reset();
+}
+
+/**
+ * @brief  Clear the step log and wait for the edge, call before the probe move
+ * @retval None
+ */
+void Anker_Probe_Capture::arm() {
+  CRITICAL_SECTION_START();
+  head = 0;
+  level = edge_valid = stopped = false;
+  valid = false;
+  armed = true;
+  CRITICAL_SECTION_END();
+}
+
+/**
+ * @brief  Interpolate the trigger between the logged steps, call after the probe move
+ * @param  triggered the move ended on the probe
+ * @retval None
+ */
+void Anker_Probe_Capture::finish(const bool triggered) {
+  armed = false;
+  valid = false;
+  if (!triggered || !edge_valid || !stopped) return;
+
+  const uint32_t h = head, n = _MIN(h, uint32_t(PROBE_CAPTURE_STEPS));
+  if (!n) return;
+  auto at = [&](const uint32_t k) -> const probe_capture_step_t& { return ring[(h - 1 - k) & (PROBE_CAPTURE_STEPS - 1)]; };
+
+  // Newest step at or before the edge
+  uint32_t k = 0;
+  while (k < n && int32_t(edge_t - at(k).t) < 0) k++;
+  if (k == n) { late++; return; }
+
+  const probe_capture_step_t &a = at(k);
+  if (k) {                        // Between this step and the next one
+    const probe_capture_step_t &b = at(k - 1);
+    trigger_steps = a.z + float(edge_t - a.t) / float(_MAX(b.t - a.t, 1UL)) * (b.z - a.z);
+  }
+  else                            // After the newest step, no step was taken past it
+    trigger_steps = a.z;
+  stop_steps = stepper.position(Z_AXIS);
+  overshoot = ABS(stop_steps - trigger_steps);
+  latency_us = (stop_t - edge_t) / CAPTURE_TICKS_PER_US;
+  NOLESS(overshoot_max, overshoot);
+  NOLESS(latency_max_us, latency_us);
+  captures++;
+  valid = true;
+}
+
+/**
+ * @brief  Z of the probe trigger
+ * @param  stop_z Z where the steppers stopped, current_position.z after the probe move
+ * @retval the interpolated trigger Z, stop_z if the last probe had no capture
+ */
+float Anker_Probe_Capture::trigger_z(const_float_t stop_z) {
+  return valid ? stop_z + (trigger_steps - stop_steps) * planner.steps_to_mm[Z_AXIS] : stop_z;
+}
+
+void Anker_Probe_Capture::reset() {
+  captures = late = 0;
+  latency_us = latency_max_us = overshoot = overshoot_max = 0;
+}
+
+void Anker_Probe_Capture::report() {
+  SERIAL_ECHOPAIR("Probe capture:", captures, " late:", late);
+  SERIAL_ECHOPAIR_F(" latency us:", latency_us, 2);
+  SERIAL_ECHOPAIR_F(" max:", latency_max_us, 2);
+  SERIAL_ECHOPAIR_F(" overshoot mm:", overshoot * planner.steps_to_mm[Z_AXIS], 5);
+  SERIAL_ECHOLNPAIR_F(" max:", overshoot_max * planner.steps_to_mm[Z_AXIS], 5);
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 16:48:05
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 16:48:05
+ * @Description  : Probe trigger timestamp and the Z between the steps around it
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_PROBE_CAPTURE)
+
+/**
+ * The probe input EXTI (ENDSTOP_INTERRUPTS_FEATURE) runs endstops.update() on the edge,
+ * which stamps it with the DWT cycle counter. While armed, the stepper isr logs the time
+ * and count of the last Z steps. After the move the trigger Z is interpolated between the
+ * two steps around the edge, or taken at the newest step when the edge came after it,
+ * instead of the count where the steppers stopped.
+ *   main  : arm() before the probe move
+ *   isr   : edge() from endstops.update(), step() from the pulse phase, stop() on the hit
+ *   main  : finish() after the move, trigger_z() for the measurement
+ * The probe pins of the V8110 boards (PD1, PA13) have no timer channel, so the EXTI
+ * stamp stands in for an input capture, its latency is fixed and well under 1us.
+ */
+#define PROBE_CAPTURE_STEPS 8   // Power of 2, Z steps kept around the edge
+
+typedef struct {
+  uint32_t t;
+  int32_t z;
+} probe_capture_step_t;
+
+class Anker_Probe_Capture {
+  public:
+    static uint32_t captures, late;             // Interpolated / edge older than the step log
+    static float latency_us, latency_max_us;    // Edge to stop, last and worst
+    static float overshoot, overshoot_max;      // Steps between the trigger and the stop
+
+    static void init();
+    static void arm();
+    static void finish(const bool triggered);
+    static float trigger_z(const_float_t stop_z);
+    static void reset();
+    static void report();
+
+    static inline uint32_t ticks() { return DWT->CYCCNT; }
+
+    // Stepper isr, every Z step
+    FORCE_INLINE static void step(const int32_t z) {
+      if (!armed) return;
+      probe_capture_step_t &s = ring[head++ & (PROBE_CAPTURE_STEPS - 1)];
+      s.t = ticks();
+      s.z = z;
+    }
+
+    // endstops.update(), probe input level, t the stamp of the edge if it was taken earlier
+    FORCE_INLINE static void edge(const bool on, const uint32_t t=ticks()) {
+      if (!armed || on == level) return;
+      level = on;
+      if (on) { edge_t = t; edge_valid = true; }
+      else if (!stopped) edge_valid = false;      // A glitch, wait for the next edge
+    }
+
+    // endstops.update(), the probe hit stops the steppers
+    FORCE_INLINE static void stop() {
+      if (!armed || stopped) return;
+      stop_t = ticks();
+      stopped = true;
+      armed = false;
+    }
+
+  private:
+    static probe_capture_step_t ring[PROBE_CAPTURE_STEPS];
+    static volatile uint32_t head;
+    static volatile bool armed, level, edge_valid, stopped;
+    static volatile uint32_t edge_t, stop_t;
+    static bool valid;
+    static float trigger_steps;
+    static int32_t stop_steps;
+};
+
+extern Anker_Probe_Capture probe_capture;
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:05:30
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:05:30
+ * @Description  : Periodic idle() tasks on the soft_timer wheel, with per task run time
+ */
+#include "anker_sched.h"
+
+#if ENABLED(ANKER_MAKE_API)
+
+#include "../../core/serial.h"
+#include "../../gcode/gcode.h"
+#include "../../module/stepper.h"
+
+#if HAS_AUTO_REPORTING
+  #include "../../gcode/queue.h"
+  #include "../../module/motion.h"
+  #include "../../module/temperature.h"
+  #if ENABLED(AUTO_REPORT_SD_STATUS)
+    #include "../../sd/cardreader.h"
+  #endif
+#endif
+
+#if ENABLED(HANDSHAKE)
+  #include "handshake.h"
+#endif
+#if ENABLED(NO_MOTION_BEFORE_HOMING)
+  #include "anker_homing.h"
+#endif
+#if ENABLED(ANKER_TMC_POLL)
+  #include "anker_tmc_poll.h"
+#endif
+#if ENABLED(ANKER_LOG_DEBUG)
+  #include "anker_log_debug.h"
+#endif
+#if ENABLED(ANKER_FLOW_CTRL)
+  #include "anker_flow_ctrl.h"
+#endif
+
+Anker_Sched anker_sched;
+
+#if ENABLED(HANDSHAKE)
+  static soft_timer_t sched_handshake;
+  static void sched_handshake_task() { hand_shake.check(); }
+#endif
+
+#if ENABLED(NO_MOTION_BEFORE_HOMING)
+  static soft_timer_t sched_motion_pin;
+  static void sched_motion_pin_task() { anker_homing.anker_disable_motton_before_check(); }
+#endif
+
+#if ENABLED(ANKER_TMC_POLL)
+  static soft_timer_t sched_tmc_poll;
+  static void sched_tmc_poll_task() { anker_tmc_poll.polling(); }
+#endif
+
+static soft_timer_t sched_status;
+static void sched_status_task() { stepper.current_status_polling(); }
+
+#if HAS_AUTO_REPORTING
+  // Each reporter keeps its own M155/M27/M154 interval, this only bounds how often they are checked
+  static soft_timer_t sched_autoreport;
+  static void sched_autoreport_task() {
+    if (gcode.autoreport_paused) return;
+    TERN_(AUTO_REPORT_TEMPERATURES, thermalManager.auto_reporter.tick());
+    TERN_(AUTO_REPORT_SD_STATUS, card.auto_reporter.tick());
+    TERN_(AUTO_REPORT_POSITION, position_auto_reporter.tick());
+    TERN_(BUFFER_MONITORING, queue.auto_report_buffer_statistics());
+  }
+#endif
+
+#if ENABLED(ANKER_LOG_DEBUG)
+  static soft_timer_t sched_block_buf;
+#endif
+
+#if ENABLED(ANKER_FLOW_CTRL)
+  static soft_timer_t sched_flow;
+  static void sched_flow_task() { anker_flow.poll(); }
+#endif
+
+static void sched_add(soft_timer_t &timer, const char * const name, const soft_timer_prio_t prio,
+                      const uint32_t period_ms, void (*task)())
+{
+  soft_timer_init_ex(&timer, name, prio, period_ms, SOFT_TIMER_REPEAT_FOREVER, task);
+  soft_timer_start(&timer);
+}
+
+void Anker_Sched::init()
+{
+  TERN_(HANDSHAKE, sched_add(sched_handshake, "handshake", SOFT_TIMER_PRIO_HIGH, HANDSHAKE_TIME, sched_handshake_task));
+  TERN_(NO_MOTION_BEFORE_HOMING, sched_add(sched_motion_pin, "motion_pin", SOFT_TIMER_PRIO_NORMAL, 10, sched_motion_pin_task));
+  TERN_(ANKER_TMC_POLL, sched_add(sched_tmc_poll, "tmc_poll", SOFT_TIMER_PRIO_NORMAL, ANKER_TMC_POLL_INTERVAL_MS, sched_tmc_poll_task));
+  sched_add(sched_status, "status", SOFT_TIMER_PRIO_LOW, 1000, sched_status_task);
+  TERN_(HAS_AUTO_REPORTING, sched_add(sched_autoreport, "autoreport", SOFT_TIMER_PRIO_LOW, 100, sched_autoreport_task));
+  TERN_(ANKER_LOG_DEBUG, sched_add(sched_block_buf, "block_buf", SOFT_TIMER_PRIO_LOW, 5000, anker_check_block_buf));
+  TERN_(ANKER_FLOW_CTRL, sched_add(sched_flow, "flow", SOFT_TIMER_PRIO_NORMAL, FLOW_POLL_MS, sched_flow_task));
+}
+
+/**
+  * @brief  Print every registered task: period, priority, runs and callback run time
+  * @param  None
+  * @retval None
+  */
+void Anker_Sched::report()
+{
+  static const char prio_name[SOFT_TIMER_PRIO_COUNT] = { 'H', 'N', 'L' };
+  SERIAL_ECHOLNPGM("echo:sched tasks, run time in us");
+  for (soft_timer_t *t = soft_timer_list(); t; t = t->all) {
+    soft_timer_t s;
+    CRITICAL_SECTION_START();
+    s = *t;
+    CRITICAL_SECTION_END();
+    SERIAL_ECHOPAIR("echo:", s.name, " period:", s.timeout_ms, "ms prio:", AS_CHAR(prio_name[s.prio]), " runs:", s.runs);
+    if (s.runs) {
+      SERIAL_ECHOPAIR(" mean:", uint32_t(s.run_us_sum / s.runs), " max:", s.run_us_max);
+      SERIAL_ECHOPAIR(" total:", uint32_t(s.run_us_sum / 1000), "ms");
+    }
+    SERIAL_EOL();
+  }
+}
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:05:30
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:05:30
+ * @Description  : Periodic idle() tasks on the soft_timer wheel, with per task run time
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_MAKE_API)
+
+extern "C" {
+  #include "../interactive/soft_timer.h"
+}
+
+class Anker_Sched {
+  public:
+    // Register the periodic tasks, after the modules they call are initialized
+    static void init();
+
+    // Called once per idle(), expires and runs the due tasks
+    static inline void loop() { soft_timer_loop(); }
+
+    static void report();
+    static void reset() { soft_timer_stats_reset(); }
+};
+
+extern Anker_Sched anker_sched;
+
+#endif
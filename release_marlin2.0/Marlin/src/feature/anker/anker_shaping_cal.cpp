@@ -0,0 +1,154 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 14:20:05
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 14:20:05
+ * @Description  : Input shaping resonance sweep, TMC2209 StallGuard load as the response
+ */
+#include "anker_shaping_cal.h"
+
+#if ENABLED(ANKER_SHAPING_CAL) && ENABLED(INPUT_SHAPING)
+
+#include "../../MarlinCore.h"
+#include "../../module/motion.h"
+#include "../../module/planner.h"
+#include "../../module/stepper.h"
+#include "../../module/stepper/trinamic.h"
+#include "../tmc_util.h"
+
+Anker_Shaping_Cal anker_shaping_cal;
+
+static uint16_t shaping_cal_sg_result(const AxisEnum axis) {
+  switch (axis) {
+    #if AXIS_DRIVER_TYPE(X, TMC2209)
+      case X_AXIS: return stepperX.SG_RESULT();
+    #endif
+    #if AXIS_DRIVER_TYPE(Y, TMC2209)
+      case Y_AXIS: return stepperY.SG_RESULT();
+    #endif
+    default: return 0;
+  }
+}
+
+#if USE_SENSORLESS
+  // SG_RESULT only updates while TSTEP <= TCOOLTHRS, so open StallGuard to every speed of the sweep
+  static bool shaping_cal_stallguard(const AxisEnum axis, const bool enable, const bool restore_stealth=false) {
+    switch (axis) {
+      #if AXIS_DRIVER_TYPE(X, TMC2209)
+        case X_AXIS: if (enable) return tmc_enable_stallguard(stepperX); tmc_disable_stallguard(stepperX, restore_stealth); break;
+      #endif
+      #if AXIS_DRIVER_TYPE(Y, TMC2209)
+        case Y_AXIS: if (enable) return tmc_enable_stallguard(stepperY); tmc_disable_stallguard(stepperY, restore_stealth); break;
+      #endif
+      default: break;
+    }
+    return false;
+  }
+#endif
+
+float Anker_Shaping_Cal::sweep(const AxisEnum axis, const float f_start, const float f_end, const float f_step,
+                               const float accel, const uint8_t cycles)
+{
+  const shaping_params_t * const sp = stepper.get_shaping(axis);
+  if (!sp || f_step <= 0 || f_end < f_start || accel <= 0 || !cycles) return 0;
+  if (homing_needed_error(_BV(axis))) return 0;
+
+  planner.synchronize();
+  while (!stepper.shaping_idle()) idle();
+
+  // Measure the bare axis, with the same acceleration in every move
+  const shaping_params_t saved = *sp;
+  stepper.set_shaping(axis, SHAPER_NONE, saved.frequency, saved.zeta);
+
+  const float saved_travel_accel = planner.settings.travel_acceleration;
+  planner.settings.travel_acceleration = accel;
+  #ifdef XY_FREQUENCY_LIMIT
+    const int8_t saved_freq_limit = planner.xy_freq_limit_hz;
+    planner.xy_freq_limit_hz = 0;
+  #endif
+
+  // Shake toward the bed center so the moves stay inside the travel
+  const float center = axis == X_AXIS ? X_CENTER : Y_CENTER;
+  const float dir = current_position[axis] < center ? 1.0f : -1.0f;
+  const xyze_pos_t start = current_position;
+  const float full_step_mm = float(axis == X_AXIS ? X_MICROSTEPS : Y_MICROSTEPS) / planner.settings.axis_steps_per_mm[axis];
+
+  SERIAL_ECHOLNPAIR("echo:shaping sweep ", AS_CHAR(axis_codes[axis]), " accel:", accel, " cycles:", cycles);
+
+  #if USE_SENSORLESS
+    const bool stealth_was_enabled = shaping_cal_stallguard(axis, true);
+  #endif
+
+  float best_freq = 0, best_sg = 0;
+  bool complete = true;
+  for (float f = f_start; f <= f_end + 0.001f; f += f_step) {
+    // Amplitude and mean speed (d in 1 / 2f) of the shake, in full steps
+    const float d = accel / (16.0f * sq(f)), d_steps = d / full_step_mm, rate = d_steps * 2.0f * f;
+    if (d_steps < SHAPING_CAL_MIN_FULL_STEPS || rate < SHAPING_CAL_MIN_FSTEP_RATE) {
+      SERIAL_ECHOPAIR("echo:f:", f);
+      SERIAL_ECHOPAIR_F(" amplitude:", d_steps, 1);
+      SERIAL_ECHOPAIR_F(" full steps, ", rate, 0);
+      SERIAL_ECHOLNPGM(" full steps/s, too small, skipped");
+      complete = false;
+      continue;
+    }
+
+    // Feedrate above the triangle peak sqrt(accel * d) so the moves never cruise
+    const feedRate_t fr = _MIN(2.0f * SQRT(accel * d), planner.settings.max_feedrate_mm_s[axis]);
+    xyze_pos_t out = start;
+    out[axis] += dir * d;
+    LOOP_L_N(c, cycles) {
+      planner.buffer_line(out, fr, active_extruder);
+      planner.buffer_line(start, fr, active_extruder);
+    }
+
+    // Each SG_RESULT read is one UART transaction, so this samples every few ms
+    uint32_t sum = 0;
+    uint16_t n = 0;
+    while (planner.has_blocks_queued()) {
+      if (stepper.axis_is_moving(axis)) { sum += shaping_cal_sg_result(axis); n++; }
+      idle();
+    }
+    planner.synchronize();
+
+    // Reads closer together than a full step see the same SG_RESULT again
+    const uint16_t distinct = _MIN(n, uint16_t(2.0f * cycles * d_steps));
+    const float mean = n ? float(sum) / n : 0;
+    SERIAL_ECHOPAIR("echo:f:", f);
+    SERIAL_ECHOPAIR_F(" amplitude:", d, 3);
+    SERIAL_ECHOPAIR_F("mm sg:", mean, 1);
+    SERIAL_ECHOPAIR(" n:", distinct);
+    if (distinct < SHAPING_CAL_MIN_SAMPLES) {
+      SERIAL_ECHOLNPGM(" too few samples, skipped");
+      complete = false;
+      continue;
+    }
+    SERIAL_EOL();
+
+    if (!best_freq || mean < best_sg) { best_freq = f; best_sg = mean; }
+  }
+
+  #if USE_SENSORLESS
+    shaping_cal_stallguard(axis, false, stealth_was_enabled);
+  #endif
+
+  planner.settings.travel_acceleration = saved_travel_accel;
+  #ifdef XY_FREQUENCY_LIMIT
+    planner.xy_freq_limit_hz = saved_freq_limit;
+  #endif
+  stepper.set_shaping(axis, saved.type, saved.frequency, saved.zeta);
+
+  if (!best_freq) {
+    SERIAL_ECHOLNPGM("echo:shaping sweep got no samples");
+    return 0;
+  }
+  SERIAL_ECHOLNPAIR("echo:shaping ", AS_CHAR(axis_codes[axis]), " resonance:", best_freq, "Hz sg:", best_sg);
+  if (!complete) {
+    // Raise A, or narrow B..E to where the shake is large and fast enough
+    SERIAL_ECHOLNPGM("echo:shaping sweep incomplete, not applied");
+    return 0;
+  }
+  return best_freq;
+}
+
+#endif
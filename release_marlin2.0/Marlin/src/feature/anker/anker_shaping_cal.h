@@ -0,0 +1,47 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 14:20:05
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 14:20:05
+ * @Description  : Input shaping resonance sweep, TMC2209 StallGuard load as the response
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_SHAPING_CAL) && ENABLED(INPUT_SHAPING)
+
+  #define SHAPING_CAL_FREQ_START  20  // (Hz) Default sweep range
+  #define SHAPING_CAL_FREQ_END    80
+  #define SHAPING_CAL_FREQ_STEP    2
+  #define SHAPING_CAL_CYCLES      10  // Back and forth moves per frequency
+  #define SHAPING_CAL_MAX_CYCLES  ((BLOCK_BUFFER_SIZE) / 2 - 1)
+
+  // SG_RESULT changes once per full step and each read is a UART transaction of a few ms,
+  // so a frequency is only measured when the motion gives StallGuard something to see
+  #define SHAPING_CAL_MIN_FULL_STEPS   4  // Amplitude of the shake, full steps
+  #define SHAPING_CAL_MIN_FSTEP_RATE 200  // (full steps/s) Mean speed of the shake, 1 rev/s of a 200 step motor
+  #define SHAPING_CAL_MIN_SAMPLES     16  // SG_RESULT reads per frequency, at most one per full step moved
+
+  class Anker_Shaping_Cal {
+    public:
+      /**
+       * @brief  Shake one axis through a range of frequencies and report the mean SG_RESULT of each.
+       *         The axis shaper is switched off for the sweep and restored afterwards.
+       *         A triangular move of accel / (16 * f^2) mm there and back takes exactly 1 / f,
+       *         and the lowest SG_RESULT (highest load) marks the resonance.
+       *         A frequency below SHAPING_CAL_MIN_FULL_STEPS, SHAPING_CAL_MIN_FSTEP_RATE or
+       *         SHAPING_CAL_MIN_SAMPLES is reported and skipped, and the sweep is then incomplete.
+       * @param  axis : X_AXIS or Y_AXIS, must be homed
+       * @param  f_start, f_end, f_step : sweep range (Hz)
+       * @param  accel : excitation acceleration (mm/s^2)
+       * @param  cycles : back and forth moves per frequency
+       * @retval the resonance frequency, 0 if the sweep did not run or skipped a frequency
+       */
+      static float sweep(const AxisEnum axis, const float f_start, const float f_end, const float f_step,
+                         const float accel, const uint8_t cycles);
+  };
+
+  extern Anker_Shaping_Cal anker_shaping_cal;
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 19:26:51
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 19:26:51
+ * @Description  : Stepper ISR multistepping with hysteresis, smoothing budget from the measured ISR load
+ */
+#include "anker_step_sched.h"
+
+#if ENABLED(ANKER_STEP_SCHED)
+
+#include "../../core/serial.h"
+
+#if ENABLED(DISABLE_MULTI_STEPPING)
+  #error "ANKER_STEP_SCHED schedules the multistepping, it can't be used with DISABLE_MULTI_STEPPING."
+#endif
+
+Anker_Step_Sched step_sched;
+
+uint8_t Anker_Step_Sched::idx;
+uint32_t Anker_Step_Sched::switches, Anker_Step_Sched::blocks, Anker_Step_Sched::overruns;
+uint8_t Anker_Step_Sched::load, Anker_Step_Sched::load_peak;
+uint32_t Anker_Step_Sched::cycles_per_isr;
+uint8_t Anker_Step_Sched::backoff;
+uint32_t Anker_Step_Sched::busy, Anker_Step_Sched::calls, Anker_Step_Sched::window_start,
+         Anker_Step_Sched::limit_rate = MIN_STEP_ISR_FREQUENCY;
+
+// Highest step rate of each multistepping factor, the limit[] of calc_timer_interval() unshifted
+static const uint32_t rate_limit[8] = {
+  MAX_STEP_ISR_FREQUENCY_1X,  MAX_STEP_ISR_FREQUENCY_2X,  MAX_STEP_ISR_FREQUENCY_4X,  MAX_STEP_ISR_FREQUENCY_8X,
+  MAX_STEP_ISR_FREQUENCY_16X, MAX_STEP_ISR_FREQUENCY_32X, MAX_STEP_ISR_FREQUENCY_64X, MAX_STEP_ISR_FREQUENCY_128X
+};
+
+void Anker_Step_Sched::init() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  window_start = DWT->CYCCNT;
+  reset();
+}
+
+/**
+ * @brief  Multistepping of the step rate, from calc_timer_interval()
+ * @param  step_rate steps per second, oversampling included
+ * @retval log2 of the steps per ISR
+ */
+uint8_t Anker_Step_Sched::select(const uint32_t step_rate) {
+  uint8_t i = idx;
+  while (i < 7 && step_rate > rate_limit[i]) i++;
+  while (i > 0 && step_rate <= rate_limit[i - 1] - (rate_limit[i - 1] >> (STEP_SCHED_HYST_SHIFT))) i--;
+  if (i != idx) {
+    idx = i;
+    switches++;
+  }
+  return i;
+}
+
+/**
+ * @brief  New block in the stepper, after the oversampling has been chosen
+ * @param  peak_rate nominal rate of the block, oversampling included
+ * @retval None
+ */
+void Anker_Step_Sched::block_start(const uint32_t peak_rate) {
+  uint8_t c = 0;
+  while (c < 7 && peak_rate > rate_limit[c]) c++;
+  if (idx > c) {                                      // The block never needs more, no hysteresis to wait out
+    idx = c;
+    switches++;
+  }
+  blocks++;
+}
+
+/**
+ * @brief  End of a load window, from the stepper ISR
+ * @retval None
+ */
+void Anker_Step_Sched::window() {
+  const uint32_t now = DWT->CYCCNT, elapsed = now - window_start;
+  load = _MIN(100U, uint32_t((uint64_t(busy) * 100U) / elapsed));
+  NOLESS(load_peak, load);
+  cycles_per_isr = calls ? busy / calls : 0;
+
+  if (load > STEP_SCHED_LOAD_HIGH) {
+    if (backoff < STEP_SCHED_BACKOFF_MAX) backoff++;
+  }
+  else if (backoff && load < (STEP_SCHED_LOAD_TARGET) / 2)
+    backoff--;
+
+  // The ISR rate that costs STEP_SCHED_LOAD_TARGET at the cycles measured per call
+  uint32_t rate = MIN_STEP_ISR_FREQUENCY;
+  if (cycles_per_isr) NOMORE(rate, uint32_t(F_CPU) / 100U * (STEP_SCHED_LOAD_TARGET) / cycles_per_isr);
+  limit_rate = rate >> backoff;
+
+  busy = calls = 0;
+  window_start = now;
+}
+
+void Anker_Step_Sched::reset() {
+  CRITICAL_SECTION_START();
+  switches = blocks = overruns = 0;
+  load_peak = 0;
+  CRITICAL_SECTION_END();
+}
+
+/**
+ * @brief  Multistepping, ISR load and smoothing budget
+ * @retval None
+ */
+void Anker_Step_Sched::report() {
+  SERIAL_ECHOLNPAIR("Step sched multistep:", 1 << idx, " switches:", switches, " blocks:", blocks);
+  SERIAL_ECHOLNPAIR(" isr load%:", load, " peak:", load_peak, " cycles/isr:", cycles_per_isr);
+  SERIAL_ECHOLNPAIR(" smoothing isr limit:", limit_rate, " backoff:", backoff, " overruns:", overruns);
+}
+
+#endif
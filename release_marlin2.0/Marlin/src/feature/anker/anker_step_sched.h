@@ -0,0 +1,66 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 19:26:51
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 19:26:51
+ * @Description  : Stepper ISR multistepping with hysteresis, smoothing budget from the measured ISR load
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_STEP_SCHED)
+
+#include "../../module/stepper.h"
+
+/**
+ * calc_timer_interval(step_rate, loops) used to pick the multistepping from scratch on every
+ * call, a rate sitting on a limit toggled 1x/2x from one acceleration tick to the next.
+ *   select()      : the factor only goes down once the rate is STEP_SCHED_HYST_SHIFT below
+ *                   the lower limit, it goes up as soon as the rate needs it
+ *   block_start() : a factor over what the block's peak rate needs is dropped at once, the
+ *                   block never runs coarser than its own peak needs
+ *   isr_done()    : cycles in Stepper::isr() against the time between calls, per window
+ *   isr_limit()   : the ISR rate ADAPTIVE_STEP_SMOOTHING may use for the next block, the rate
+ *                   that gives STEP_SCHED_LOAD_TARGET at the measured cycles per ISR. Halved
+ *                   while the load is over STEP_SCHED_LOAD_HIGH, so it backs off before overrun.
+ */
+#define STEP_SCHED_HYST_SHIFT   3   // Down a factor only 1/8 below the limit
+#define STEP_SCHED_WINDOW_MS    10  // Load measured over this much time
+#define STEP_SCHED_LOAD_TARGET  50  // (%) Stepper ISR load the smoothing is planned for
+#define STEP_SCHED_LOAD_HIGH    75  // (%) Measured load that halves the smoothing budget
+#define STEP_SCHED_BACKOFF_MAX  4
+
+class Anker_Step_Sched {
+  public:
+    static uint8_t idx;                   // log2 of the steps per ISR
+    static uint32_t switches, blocks, overruns;
+    static uint8_t load, load_peak;       // (%) last window, highest window
+    static uint32_t cycles_per_isr;
+    static uint8_t backoff;
+
+    static void init();
+    static void reset();
+    static void report();
+
+    static uint8_t select(const uint32_t step_rate);
+    static void block_start(const uint32_t peak_rate);
+    static void window();
+
+    static uint32_t isr_limit() { return limit_rate; }
+
+    // End of Stepper::isr(), start is DWT->CYCCNT at its entry
+    FORCE_INLINE static void isr_done(const uint32_t start) {
+      busy += DWT->CYCCNT - start;
+      calls++;
+      if (start - window_start >= WINDOW_CYCLES) window();
+    }
+
+  private:
+    static constexpr uint32_t WINDOW_CYCLES = uint32_t(F_CPU) / 1000UL * (STEP_SCHED_WINDOW_MS);
+    static uint32_t busy, calls, window_start, limit_rate;
+};
+
+extern Anker_Step_Sched step_sched;
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 09:12:40
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 09:12:40
+ * @Description  : Time-sliced TMC2209 UART access: shadowed writes and round-robin status polling
+ */
+#include "anker_tmc_poll.h"
+
+#if ENABLED(ANKER_TMC_POLL)
+
+#include "../../module/stepper/trinamic.h"
+#include "../../libs/hex_print.h"
+
+Anker_TMC_Poll anker_tmc_poll;
+
+bool Anker_TMC_Poll::enable = true;
+uint8_t Anker_TMC_Poll::shadow_sgthrs[ANKER_TMC_COUNT];
+uint8_t Anker_TMC_Poll::pending_sgthrs[ANKER_TMC_COUNT];
+uint8_t Anker_TMC_Poll::shadow_valid, Anker_TMC_Poll::shadow_dirty;
+uint8_t Anker_TMC_Poll::next_read;
+uint32_t Anker_TMC_Poll::transactions, Anker_TMC_Poll::skipped_writes;
+volatile uint8_t Anker_TMC_Poll::active_slot;
+anker_tmc_status_t Anker_TMC_Poll::status[ANKER_TMC_COUNT][2];
+
+static_assert(ANKER_TMC_COUNT <= 8, "ANKER_TMC_POLL tracks at most 8 drivers.");
+
+static TMC2209Stepper& anker_tmc_driver(const Anker_TMC_Driver drv) {
+  switch (drv) {
+    default:
+    #if AXIS_DRIVER_TYPE(X, TMC2209)
+      case ANKER_TMC_X: return stepperX;
+    #endif
+    #if AXIS_DRIVER_TYPE(Y, TMC2209)
+      case ANKER_TMC_Y: return stepperY;
+    #endif
+    #if AXIS_DRIVER_TYPE(Z, TMC2209)
+      case ANKER_TMC_Z: return stepperZ;
+    #endif
+    #if AXIS_DRIVER_TYPE(Z2, TMC2209)
+      case ANKER_TMC_Z2: return stepperZ2;
+    #endif
+    #if AXIS_DRIVER_TYPE(E0, TMC2209)
+      case ANKER_TMC_E0: return stepperE0;
+    #endif
+  }
+}
+
+static const char * const anker_tmc_name[ANKER_TMC_COUNT] = {
+  #if AXIS_DRIVER_TYPE(X, TMC2209)
+    "X",
+  #endif
+  #if AXIS_DRIVER_TYPE(Y, TMC2209)
+    "Y",
+  #endif
+  #if AXIS_DRIVER_TYPE(Z, TMC2209)
+    "Z1",
+  #endif
+  #if AXIS_DRIVER_TYPE(Z2, TMC2209)
+    "Z2",
+  #endif
+  #if AXIS_DRIVER_TYPE(E0, TMC2209)
+    "E0",
+  #endif
+};
+
+void Anker_TMC_Poll::init()
+{
+  shadow_valid = shadow_dirty = 0;
+  next_read = 0;
+  active_slot = 0;
+  ZERO(status);
+}
+
+void Anker_TMC_Poll::write_sgthrs(const Anker_TMC_Driver drv, const uint8_t value)
+{
+  anker_tmc_driver(drv).SGTHRS(value);
+  shadow_sgthrs[drv] = value;
+  shadow_valid |= _BV(drv);
+  shadow_dirty &= ~_BV(drv);
+  transactions++;
+}
+
+void Anker_TMC_Poll::set_sgthrs(const Anker_TMC_Driver drv, int16_t value, const bool now)
+{
+  value = constrain(value, 0, 255);
+  if (TEST(shadow_valid, drv) && shadow_sgthrs[drv] == value) {
+    shadow_dirty &= ~_BV(drv);  // The chip already holds it, a pending deferred write is superseded
+    skipped_writes++;
+    return;
+  }
+  if (now)
+    write_sgthrs(drv, value);
+  else {
+    pending_sgthrs[drv] = value;
+    shadow_dirty |= _BV(drv);
+  }
+}
+
+void Anker_TMC_Poll::flush()
+{
+  LOOP_L_N(i, ANKER_TMC_COUNT)
+    if (TEST(shadow_dirty, i)) write_sgthrs((Anker_TMC_Driver)i, pending_sgthrs[i]);
+}
+
+bool Anker_TMC_Poll::get_status(const Anker_TMC_Driver drv, anker_tmc_status_t &out)
+{
+  out = status[drv][TEST(active_slot, drv)];
+  return out.ms != 0;
+}
+
+/**
+ * Called from idle(). Does at most one UART transaction per ANKER_TMC_POLL_INTERVAL_MS:
+ * a pending shadow write first, otherwise the next DRV_STATUS / SG_RESULT read in turn.
+ * A full sweep of all drivers takes ANKER_TMC_COUNT * 2 intervals.
+ */
+// Runs every ANKER_TMC_POLL_INTERVAL_MS from the anker_sched timer wheel
+void Anker_TMC_Poll::polling()
+{
+  if (shadow_dirty) {
+    LOOP_L_N(i, ANKER_TMC_COUNT)
+      if (TEST(shadow_dirty, i)) { write_sgthrs((Anker_TMC_Driver)i, pending_sgthrs[i]); return; }
+  }
+
+  if (!enable) return;
+
+  const Anker_TMC_Driver drv = (Anker_TMC_Driver)(next_read >> 1);
+  const bool read_sg = TEST(next_read, 0);
+  if (++next_read >= ANKER_TMC_COUNT * 2) next_read = 0;
+
+  const uint8_t cur = TEST(active_slot, drv), nxt = !cur;
+  anker_tmc_status_t &s = status[drv][nxt];
+  s = status[drv][cur];
+  if (read_sg)
+    s.sg_result = anker_tmc_driver(drv).SG_RESULT();
+  else
+    s.drv_status = anker_tmc_driver(drv).DRV_STATUS();
+  s.ms = millis() ?: 1;
+  transactions++;
+
+  // Publish the new slot. Only polling() writes active_slot, so a plain toggle is enough.
+  TBI(active_slot, drv);
+}
+
+void Anker_TMC_Poll::report()
+{
+  SERIAL_ECHOLNPAIR("echo:tmc poll:", enable, " interval:", ANKER_TMC_POLL_INTERVAL_MS, "ms transactions:", transactions, " skipped writes:", skipped_writes);
+  const millis_t ms = millis();
+  LOOP_L_N(i, ANKER_TMC_COUNT) {
+    anker_tmc_status_t s;
+    SERIAL_ECHOPAIR("echo:", anker_tmc_name[i], " sgthrs:", get_sgthrs((Anker_TMC_Driver)i));
+    if (get_status((Anker_TMC_Driver)i, s)) {
+      SERIAL_ECHOPAIR(" sg_result:", s.sg_result, " drv_status:");
+      print_hex_long(s.drv_status, ':');
+      SERIAL_ECHOLNPAIR(" age:", ms - s.ms, "ms");
+    }
+    else
+      SERIAL_ECHOLNPGM(" not polled");
+  }
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 09:12:40
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 09:12:40
+ * @Description  : Time-sliced TMC2209 UART access: shadowed writes and round-robin status polling
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_TMC_POLL)
+
+  #ifndef ANKER_TMC_POLL_INTERVAL_MS
+    #define ANKER_TMC_POLL_INTERVAL_MS 100 // One UART transaction per interval (~8ms each at 19200 baud)
+  #endif
+
+  enum Anker_TMC_Driver : uint8_t {
+    #if AXIS_DRIVER_TYPE(X, TMC2209)
+      ANKER_TMC_X,
+    #endif
+    #if AXIS_DRIVER_TYPE(Y, TMC2209)
+      ANKER_TMC_Y,
+    #endif
+    #if AXIS_DRIVER_TYPE(Z, TMC2209)
+      ANKER_TMC_Z,
+    #endif
+    #if AXIS_DRIVER_TYPE(Z2, TMC2209)
+      ANKER_TMC_Z2,
+    #endif
+    #if AXIS_DRIVER_TYPE(E0, TMC2209)
+      ANKER_TMC_E0,
+    #endif
+    ANKER_TMC_COUNT
+  };
+
+  // Last polled driver status. Written by polling() only, read anywhere through get_status()
+  typedef struct {
+    uint32_t drv_status;  // DRV_STATUS raw value
+    uint16_t sg_result;   // SG_RESULT (StallGuard load, 0..510)
+    millis_t ms;          // Time of the last update, 0 if never read
+  } anker_tmc_status_t;
+
+  class Anker_TMC_Poll {
+    public:
+      static bool enable;   // Round-robin status polling on/off
+
+      static void init();
+      static void polling();
+
+      /**
+       * @brief  Set SGTHRS through the shadow copy. The UART write is skipped if the chip already holds the value.
+       * @param  drv : driver index
+       * @param  value : new threshold, constrained to 0..255
+       * @param  now : write immediately (homing) or leave it dirty for polling() to flush
+       */
+      static void set_sgthrs(const Anker_TMC_Driver drv, int16_t value, const bool now=true);
+      static uint8_t get_sgthrs(const Anker_TMC_Driver drv) { return TEST(shadow_dirty, drv) ? pending_sgthrs[drv] : shadow_sgthrs[drv]; }
+
+      // Write all dirty shadows out now
+      static void flush();
+
+      // Forget the shadow so the next set_sgthrs() always writes (register changed behind our back)
+      static void invalidate(const Anker_TMC_Driver drv) { shadow_valid &= ~_BV(drv); }
+      // Every driver, after a driver (re)init: reset_stepper_drivers(), restore_stepper_drivers(), M914
+      static void invalidate_all() { shadow_valid = 0; }
+
+      /**
+       * @brief  Copy out a consistent status snapshot. Safe from ISR context.
+       * @retval false if the driver was never polled
+       */
+      static bool get_status(const Anker_TMC_Driver drv, anker_tmc_status_t &out);
+
+      static void report();
+
+    private:
+      static uint8_t shadow_sgthrs[ANKER_TMC_COUNT];   // Last value written to the chip
+      static uint8_t pending_sgthrs[ANKER_TMC_COUNT];  // Deferred value, for polling() to write
+      static uint8_t shadow_valid, shadow_dirty;
+      static uint8_t next_read;     // Round-robin cursor: driver * 2 + register
+      static uint32_t transactions, skipped_writes;
+
+      // Double buffered per driver: polling() fills the inactive slot then flips the bit,
+      // so an ISR reader never sees a half-written record.
+      static volatile uint8_t active_slot;
+      static anker_tmc_status_t status[ANKER_TMC_COUNT][2];
+
+      static void write_sgthrs(const Anker_TMC_Driver drv, const uint8_t value);
+  };
+
+  extern Anker_TMC_Poll anker_tmc_poll;
+
+#endif
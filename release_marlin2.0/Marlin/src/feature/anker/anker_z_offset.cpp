@@ -789,6 +789,7 @@ void Anker_Zoffset::update_offset(void)
 #include "../interactive/uart_nozzle_rx.h"
 #include "../../gcode/gcode.h"
 #include "../../module/probe.h"
+#include "../../MarlinCore.h"
     Anker_Probe_set anker_probe_set;
     uint16_t Anker_Probe_set::homing_value=HOMING_PROBE_VALUE;
     uint16_t Anker_Probe_set::leveing_value=LEVEING_PROBE_VALUE;
@@ -797,18 +798,81 @@ void Anker_Zoffset::update_offset(void)
     bool Anker_Probe_set::auto_run_flag=false;
     bool Anker_Probe_set::point_test_flag=false;
     xy_pos_t Anker_Probe_set::xy[5];
+    #if ENABLED(ANKER_PROBE_ACK)
+    uint16_t Anker_Probe_set::settle_last=0;
+    uint16_t Anker_Probe_set::settle_max=0;
+    uint32_t Anker_Probe_set::settle_sum=0;
+    uint16_t Anker_Probe_set::settle_count=0;
+    uint16_t Anker_Probe_set::ack_timeouts=0;
+    #endif
+    millis_t Anker_Probe_set::arm_ms=0;
+    uint16_t Anker_Probe_set::arm_value=0;
 
     void Anker_Probe_set::probe_start(uint16_t value)
     {
        #if ADAPT_DETACHED_NOZZLE
+       #if DISABLED(ANKER_PROBE_ACK)
        safe_delay(anker_probe_set.delay);
+       #endif
+       probe_arm(value);
+       probe_wait_armed();
+       #else
+       MYSERIAL1.printf("M2012 S%d\n",value);
+       #endif
+    }
+    /**
+      * @brief  Send the probe threshold to the nozzle board and return at once,
+      *         so the board can settle while the carriage is still moving
+      * @param  value : probe threshold
+      * @retval None
+      */
+    void Anker_Probe_set::probe_arm(uint16_t value)
+    {
+       #if ADAPT_DETACHED_NOZZLE
+       anker_probe_set.arm_ms = millis();
+       anker_probe_set.arm_value = value;
+       #if ENABLED(ANKER_PROBE_ACK)
+       // Matched to this arm for as long as probe_wait_armed() can wait, and the reply time on top
+       uart_nozzle_probe_arm(value, 2UL * anker_probe_set.delay + UART_NOZZLE_REPLY_MS);
+       #else
        uart_nozzle_tx_probe_val(value);
-       TERN_(ANKER_PROBE_SET, safe_delay(anker_probe_set.delay));
-       SERIAL_ECHO("probe_start\r\n");
+       #endif
        #else
        MYSERIAL1.printf("M2012 S%d\n",value);
        #endif
     }
+    /**
+      * @brief  Wait for the nozzle board armed by probe_arm, the time already spent since then counts
+      * @param  None
+      * @retval None
+      */
+    void Anker_Probe_set::probe_wait_armed()
+    {
+       #if ADAPT_DETACHED_NOZZLE && ENABLED(ANKER_PROBE_ACK)
+       // The nozzle board ACKs once the threshold is applied and its adc baseline has settled.
+       // An old nozzle firmware never ACKs, then the timeout is the same dead time as the fixed delays.
+       const millis_t start_ms = anker_probe_set.arm_ms, timeout_ms = start_ms + 2UL * anker_probe_set.delay;
+       while (!probe_ack.acked && PENDING(millis(), timeout_ms)) idle();
+
+       const uint16_t settle = millis() - start_ms;
+       if (probe_ack.acked)
+       {
+          anker_probe_set.settle_last = settle;
+          NOLESS(anker_probe_set.settle_max, settle);
+          anker_probe_set.settle_sum += settle;
+          anker_probe_set.settle_count++;
+       }
+       else
+       {
+          anker_probe_set.ack_timeouts++;
+          SERIAL_ECHOLNPAIR("probe_start ack timeout:", settle, "ms");
+       }
+       #elif ADAPT_DETACHED_NOZZLE
+       const millis_t armed_ms = anker_probe_set.arm_ms + anker_probe_set.delay;
+       while (PENDING(millis(), armed_ms)) idle();
+       SERIAL_ECHO("probe_start\r\n");
+       #endif
+    }
     void Anker_Probe_set::reset_value()
     {
        anker_probe_set.homing_value=HOMING_PROBE_VALUE;
@@ -821,8 +885,19 @@ void Anker_Zoffset::update_offset(void)
         SERIAL_ECHO("\r\nanker probe leveing value: ");
         SERIAL_ECHO(anker_probe_set.leveing_value);
         SERIAL_ECHO("\r\n");
+        #if ENABLED(ANKER_PROBE_ACK)
+        SERIAL_ECHOPAIR("anker probe arm last:", anker_probe_set.settle_last, "ms max:", anker_probe_set.settle_max);
+        SERIAL_ECHOPAIR("ms mean:", anker_probe_set.settle_count ? anker_probe_set.settle_sum / anker_probe_set.settle_count : 0);
+        SERIAL_ECHOPAIR("ms nozzle last:", probe_ack.settle_ms);
+        SERIAL_ECHO("ms acks:");
+        SERIAL_ECHO(anker_probe_set.settle_count);
+        SERIAL_ECHO(" timeouts:");
+        SERIAL_ECHO(anker_probe_set.ack_timeouts);
+        SERIAL_ECHO("\r\n");
+        #endif
     }
     
+    // Fire and forget: no GCP_CMD_40 reply layout is defined on this side, the nozzle board reports it
     void Anker_Probe_set::get_probe_value()
     {
        uart_nozzle_tx_probe_val_get();
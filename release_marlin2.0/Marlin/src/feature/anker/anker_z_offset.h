@@ -70,7 +70,16 @@ extern Anker_Zoffset anker_z_offset;
 	   static bool auto_run_flag;
        static xy_pos_t xy[5];
 	   static bool point_test_flag;
+	   #if ENABLED(ANKER_PROBE_ACK)
+	   static uint16_t settle_last, settle_max;  // Observed arm time per probe point (ms)
+	   static uint32_t settle_sum;
+	   static uint16_t settle_count, ack_timeouts;
+	   #endif
+	   static millis_t arm_ms;      // When probe_arm sent the threshold
+	   static uint16_t arm_value;
        void probe_start(uint16_t value);
+       void probe_arm(uint16_t value);
+       void probe_wait_armed();
 	   void reset_value();
 	   void report_value();
 	   void get_probe_value();
@@ -14,14 +14,24 @@
    #include "anker_nozzle_board.h"
  #endif
 
+ #if ENABLED(ANKER_TMC_POLL)
+   #include "anker_tmc_poll.h"
+   // Go through the shadow copy so an unchanged threshold costs no UART round trip
+   #define Z1_STALL_WRITE(V) anker_tmc_poll.set_sgthrs(ANKER_TMC_Z, V)
+   #define Z2_STALL_WRITE(V) anker_tmc_poll.set_sgthrs(ANKER_TMC_Z2, V)
+ #else
+   #define Z1_STALL_WRITE(V) stepperZ.anker_homing_threshold(V)
+   #define Z2_STALL_WRITE(V) stepperZ2.anker_homing_threshold(V)
+ #endif
+
  #if ENABLED(USE_Z_SENSORLESS)
   Use_Z_Sensorless use_z_sensorless;
   
    void Use_Z_Sensorless:: init()
    {
-      stepperZ.anker_homing_threshold(use_z_sensorless.z1_stall_value);
+      Z1_STALL_WRITE(use_z_sensorless.z1_stall_value);
       #ifdef ANKER_Z2_STALL_SENSITIVITY
-       stepperZ2.anker_homing_threshold(use_z_sensorless.z2_stall_value); 
+       Z2_STALL_WRITE(use_z_sensorless.z2_stall_value); 
       #endif
       
    }
@@ -36,13 +46,13 @@
    void Use_Z_Sensorless::set_z1_value(u_int16_t z1_value)
    {
        use_z_sensorless.z1_stall_value=z1_value;
-       stepperZ.anker_homing_threshold(use_z_sensorless.z1_stall_value);
+       Z1_STALL_WRITE(use_z_sensorless.z1_stall_value);
    }
    #ifdef ANKER_Z2_STALL_SENSITIVITY
    void Use_Z_Sensorless::set_z2_value(u_int16_t z2_value)
    {
        use_z_sensorless.z2_stall_value=z2_value;
-       stepperZ2.anker_homing_threshold(use_z_sensorless.z2_stall_value);
+       Z2_STALL_WRITE(use_z_sensorless.z2_stall_value);
    }
    #endif
    void Use_Z_Sensorless::report()
@@ -0,0 +1,161 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:42:10
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:42:10
+ * @Description  : Z StallGuard baseline learned during the homing move, SGTHRS set from its statistics
+ */
+#include "anker_z_stall.h"
+
+#if ENABLED(ANKER_Z_STALL_LEARN)
+
+#include "anker_tmc_poll.h"
+#include "anker_z_sensorless.h"
+#include "../../module/planner.h"
+#include "../../module/stepper.h"
+#include "../../module/stepper/trinamic.h"
+#include "../../MarlinCore.h"
+
+Anker_Z_Stall anker_z_stall;
+
+bool Anker_Z_Stall::enable = true;
+z_stall_stat_t Anker_Z_Stall::stat[Z_STALL_DRIVERS];
+int32_t Anker_Z_Stall::start_steps;
+uint8_t Anker_Z_Stall::cursor;
+
+static const Anker_TMC_Driver z_stall_tmc[Z_STALL_DRIVERS] = {
+  ANKER_TMC_Z
+  #ifdef ANKER_Z2_STALL_SENSITIVITY
+    , ANKER_TMC_Z2
+  #endif
+};
+
+static uint16_t z_stall_sg_result(const uint8_t i) {
+  #ifdef ANKER_Z2_STALL_SENSITIVITY
+    if (i) return stepperZ2.SG_RESULT();
+  #endif
+  UNUSED(i);
+  return stepperZ.SG_RESULT();
+}
+
+// The threshold set with M2003, restored after every move
+static uint8_t z_stall_fixed(const uint8_t i) {
+  #ifdef ANKER_Z2_STALL_SENSITIVITY
+    if (i) return use_z_sensorless.z2_stall_value;
+  #endif
+  UNUSED(i);
+  return use_z_sensorless.z1_stall_value;
+}
+
+static const char * const z_stall_name[] = { "Z1", "Z2" };
+
+/**
+ * @brief  Start of a Z homing move, before it is planned
+ * @retval None
+ */
+void Anker_Z_Stall::begin() {
+  LOOP_L_N(i, Z_STALL_DRIVERS) {
+    z_stall_stat_t &s = stat[i];
+    s.n = s.tracked = 0;
+    s.mean = s.m2 = 0;
+    s.decided = s.learned = false;
+    s.thrs = z_stall_fixed(i);
+    s.sg_min = UINT16_MAX;
+    anker_tmc_poll.set_sgthrs(z_stall_tmc[i], s.thrs);
+  }
+  start_steps = stepper.position(Z_AXIS);
+  cursor = 0;
+}
+
+// Threshold from the baseline, within Z_STALL_BAND of the fixed one. The fixed one if the
+// baseline is too short, too close to a stall or so far off that it was not a free move.
+void Anker_Z_Stall::decide(const uint8_t i) {
+  z_stall_stat_t &s = stat[i];
+  s.decided = true;
+  if (s.n < Z_STALL_MIN_SAMPLES) return;
+  const float level = s.mean - Z_STALL_SIGMA * sd(s);
+  if (level < 2 * Z_STALL_THRS_MIN) return;
+  const float fixed = z_stall_fixed(i), thrs = level * 0.5f;
+  if (!WITHIN(thrs, fixed * (1.0f - 2 * Z_STALL_BAND), fixed * (1.0f + 2 * Z_STALL_BAND))) return;
+  s.thrs = _MIN(constrain(thrs, fixed * (1.0f - Z_STALL_BAND), fixed * (1.0f + Z_STALL_BAND)), 255);
+  s.learned = true;
+  anker_tmc_poll.set_sgthrs(z_stall_tmc[i], s.thrs);
+}
+
+/**
+ * @brief  One SG_RESULT read, one UART transaction
+ * @param  i driver, 0 for Z1
+ * @param  mm distance from the start of the move
+ * @retval None
+ */
+void Anker_Z_Stall::sample(const uint8_t i, const float mm) {
+  if (mm < Z_STALL_SETTLE_MM) return;
+  if (TEST(stepper.get_z_lock(), i)) return;  // Stopped on its stall, SG_RESULT is the standstill value now
+
+  z_stall_stat_t &s = stat[i];
+  const uint16_t sg = z_stall_sg_result(i);
+
+  if (mm < Z_STALL_SETTLE_MM + Z_STALL_LEARN_MM) {
+    const float d = sg - s.mean;
+    s.n++;
+    s.mean += d / s.n;
+    s.m2 += d * (sg - s.mean);
+    return;
+  }
+
+  if (!s.decided) decide(i);
+
+  // Readings at the trigger level are the stall itself, not noise
+  if (sg > 2 * s.thrs) {
+    NOMORE(s.sg_min, sg);
+    s.tracked++;
+  }
+}
+
+/**
+ * @brief  planner.synchronize() of the Z homing move, the Z drivers are read by turns
+ * @retval None
+ */
+void Anker_Z_Stall::wait() {
+  while (planner.has_blocks_queued() || planner.cleaning_buffer_counter) {
+    if (enable) {
+      const float mm = ABS(stepper.position(Z_AXIS) - start_steps) * planner.steps_to_mm[Z_AXIS];
+      sample(cursor, mm);
+      if (++cursor >= Z_STALL_DRIVERS) cursor = 0;
+    }
+    idle();
+  }
+}
+
+/**
+ * @brief  End of the Z homing move, back to the fixed thresholds
+ * @retval None
+ */
+void Anker_Z_Stall::end() {
+  LOOP_L_N(i, Z_STALL_DRIVERS) anker_tmc_poll.set_sgthrs(z_stall_tmc[i], z_stall_fixed(i));
+  if (enable) report();
+}
+
+/**
+ * @brief  Baseline, threshold and margin of the last move. The margin is how far the
+ *         lowest reading before the stall stayed over the trigger level, in baseline sd.
+ * @retval None
+ */
+void Anker_Z_Stall::report() {
+  LOOP_L_N(i, Z_STALL_DRIVERS) {
+    const z_stall_stat_t &s = stat[i];
+    const float d = sd(s);
+    SERIAL_ECHOPAIR("echo:", z_stall_name[i], " stall n:", s.n);
+    SERIAL_ECHOPAIR_F(" base:", s.mean, 1);
+    SERIAL_ECHOPAIR_F(" sd:", d, 1);
+    SERIAL_ECHOPAIR(" thrs:", s.thrs);
+    SERIAL_ECHO(s.learned ? " learned" : " fixed");
+    SERIAL_ECHOPAIR(" tracked:", s.tracked);
+    if (s.tracked && d > 0)
+      SERIAL_ECHOLNPAIR_F(" margin:", (s.sg_min - 2.0f * s.thrs) / d, 1);
+    else
+      SERIAL_EOL();
+  }
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 16:42:10
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 16:42:10
+ * @Description  : Z StallGuard baseline learned during the homing move, SGTHRS set from its statistics
+ */
+#pragma once
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ANKER_Z_STALL_LEARN)
+
+  #define Z_STALL_SETTLE_MM    1.0f  // (mm) Skipped at the start of the move, acceleration and TCOOLTHRS
+  #define Z_STALL_LEARN_MM     3.0f  // (mm) Baseline window after that
+  #define Z_STALL_MIN_SAMPLES  8     // Per driver, fewer keeps the fixed threshold
+  #define Z_STALL_SIGMA        6.0f  // Stall level, standard deviations under the baseline
+  #define Z_STALL_THRS_MIN     20    // Lowest SGTHRS, a real stall must still pull SG_RESULT under 2 * SGTHRS
+  #define Z_STALL_BAND         0.3f  // Learned SGTHRS kept within this fraction of the M2003 one, past twice that the fixed one is used
+
+  #ifdef ANKER_Z2_STALL_SENSITIVITY
+    #define Z_STALL_DRIVERS 2
+  #else
+    #define Z_STALL_DRIVERS 1
+  #endif
+
+  typedef struct {
+    uint16_t n;         // Baseline samples
+    float mean, m2;     // Welford running mean and sum of squared deviations of the baseline
+    bool decided;       // Baseline window passed, thrs chosen
+    bool learned;       // thrs comes from the baseline, not the fixed value
+    uint8_t thrs;       // SGTHRS for the rest of the move
+    uint16_t tracked;   // Samples after the baseline, before the stall
+    uint16_t sg_min;    // Lowest of them
+  } z_stall_stat_t;
+
+  /**
+   * The TMC2209 raises DIAG when SG_RESULT <= 2 * SGTHRS, and the right threshold depends on
+   * the current, speed, lubrication and the bed load of each Z motor. Instead of a fixed value:
+   *   begin() : the homing move starts with the fixed thresholds of use_z_sensorless
+   *   wait()  : planner.synchronize() that reads SG_RESULT of the Z drivers by turns. After
+   *             Z_STALL_SETTLE_MM the readings of the next Z_STALL_LEARN_MM are the baseline,
+   *             then SGTHRS = (mean - Z_STALL_SIGMA * sd) / 2 for the rest of the move, kept
+   *             within Z_STALL_BAND of the fixed value
+   *   end()   : fixed thresholds back, the margin of each driver reported
+   * The DIAG pin still stops the motor, a UART read every few ms is far too slow for that.
+   * A stall inside the baseline window (Z already at the end, foreign object) meets the fixed
+   * threshold, as before.
+   */
+  class Anker_Z_Stall {
+    public:
+      static bool enable;
+      static z_stall_stat_t stat[Z_STALL_DRIVERS];
+
+      static void begin();
+      static void wait();
+      static void end();
+      static void report();
+
+      static float sd(const z_stall_stat_t &s) { return s.n > 1 ? SQRT(s.m2 / (s.n - 1)) : 0; }
+
+    private:
+      static int32_t start_steps;
+      static uint8_t cursor;
+
+      static void sample(const uint8_t i, const float mm);
+      static void decide(const uint8_t i);
+  };
+
+  extern Anker_Z_Stall anker_z_stall;
+
+#endif
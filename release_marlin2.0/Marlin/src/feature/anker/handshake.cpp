@@ -54,16 +54,10 @@
       // pinMode(HANDSHAKE_SDO,INPUT);
     }
 
+    // Runs every HANDSHAKE_TIME from the anker_sched timer wheel
     void HandShake::check()
     {
-      millis_t ms = millis();
-      static millis_t next_report_ms = millis() + HANDSHAKE_TIME;
-
-      ms = millis();
-      if(ms > next_report_ms)
-      {
-        next_report_ms = millis() + HANDSHAKE_TIME;
-         pinMode(HANDSHAKE_SDO,INPUT_FLOATING);
+        pinMode(HANDSHAKE_SDO,INPUT_FLOATING);
         if(digitalRead(HANDSHAKE_SDO))
           {
             digitalWrite(HEATER_EN_PIN,HEATER_EN_STATE);
@@ -77,7 +71,6 @@
             SERIAL_ECHO(digitalRead(HANDSHAKE_SDO));
             SERIAL_ECHO("\r\n");
           }
-      }
     }
 
 #endif
@@ -0,0 +1,51 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 21:12:40
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 21:12:40
+ * @Description  : Host build of anker_mesh_filter, the Marlin config without the HAL and a stdout serial
+ */
+#pragma once
+
+/**
+ * Forced ahead of every source of env:linux_mesh_filter (-include), with __MARLIN_DEPS__ so
+ * MarlinConfig.h reads the V8110 configuration and skips the HAL. What the HAL would have
+ * given the filter, serial.cpp and least_squares_fit.cpp is filled in here.
+ */
+#ifdef ANKER_MESH_FILTER_HOST
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../../inc/MarlinConfig.h"
+#include "../../../HAL/shared/progmem.h"
+
+#define sq(x) ((x)*(x))
+#define PGMSTR(NAM,STR) const char NAM[] = STR
+
+#include "../../../core/types.h"
+#include "../../../core/language.h"
+#include "../../../core/serial_base.h"
+
+// Every port to stdout
+struct HostSerial : public SerialBase<HostSerial> {
+  HostSerial() : SerialBase<HostSerial>(false) {}
+  void write(uint8_t c) { putchar(c); }
+  void msgDone() {}
+  void begin(const long) {}
+  void end() {}
+  int available(serial_index_t=0) const { return 0; }
+  int read(serial_index_t=0) { return -1; }
+  SerialFeature features(serial_index_t=0) const { return SerialFeature::None; }
+  bool connected() const { return true; }
+  void flush() {}
+};
+
+extern HostSerial host_serial;
+
+#define MYSERIAL1 host_serial
+#define MYSERIAL2 host_serial
+#define MYSERIAL3 host_serial
+
+#endif // ANKER_MESH_FILTER_HOST
@@ -0,0 +1,256 @@
+/*
+ * @Author       : Anan
+ * @Date         : 2026-10-18 21:12:40
+ * @LastEditors  : Anan
+ * @LastEditTime : 2026-10-18 21:12:40
+ * @Description  : anker_mesh_filter host tests and benchmark
+ */
+#ifdef ANKER_MESH_FILTER_HOST
+
+#include "../anker_mesh_filter.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+/**
+ * mesh_filter [--bench [iterations]]
+ *   Checks reject_outliers(), refine_edges(), process(), smooth() and the fits on synthetic GRID_MAX_POINTS meshes, exit
+ *   status 1 if any fails. --bench then times each of them per call, on a bowed noisy mesh.
+ * Built by env:linux_mesh_filter with the V8110 configuration.
+ */
+
+HostSerial host_serial;
+
+#define MESH_X GRID_MAX_POINTS_X
+#define MESH_Y GRID_MAX_POINTS_Y
+#define MESH_U(i, N) (float(2 * (i)) / ((N) - 1) - 1.0f)
+
+static_assert(MESH_X >= 7 && MESH_Y >= 7, "The test points need a 7x7 grid or more.");
+
+static uint16_t failures;
+
+#define CHECK(COND, ...) do{ if (!(COND)) { failures++; printf("FAIL %s:%d ", __func__, __LINE__); printf(__VA_ARGS__); putchar('\n'); } }while(0)
+#define CHECK_NEAR(A, B, TOL) CHECK(ABS((A) - (B)) <= (TOL), "%s = %f, expected %f", #A, double(A), double(B))
+
+// z = c[0] + c[1]x + c[2]y + c[3]x^2 + c[4]xy + c[5]y^2 over the -1..1 grid
+static void fill(bed_mesh_t &z, const float c[6]) {
+  GRID_LOOP(x, y) {
+    const float u = MESH_U(x, MESH_X), v = MESH_U(y, MESH_Y);
+    z[x][y] = c[0] + c[1] * u + c[2] * v + c[3] * u * u + c[4] * u * v + c[5] * v * v;
+  }
+}
+
+// Repeatable noise, -a..a
+static float noise(const float a) {
+  static uint32_t seed = 12345;
+  seed = seed * 1664525UL + 1013904223UL;
+  return a * (float(seed >> 8) / float(1UL << 23) - 1.0f);
+}
+
+static const float bowed[6] = { 0.1f, 0.05f, -0.08f, 0.06f, -0.02f, 0.04f };
+
+static void test_outliers() {
+  bed_mesh_t z, ref;
+
+  // A bowed bed keeps every point
+  fill(z, bowed);
+  COPY(ref, z);
+  CHECK(anker_mesh_filter.reject_outliers(z) == 0, "bowed mesh lost points");
+  GRID_LOOP(x, y) CHECK_NEAR(z[x][y], ref[x][y], 1e-6f);
+
+  // Also with probe noise well under the noise floor
+  GRID_LOOP(x, y) z[x][y] += noise(0.02f);
+  CHECK(anker_mesh_filter.reject_outliers(z) == 0, "noisy mesh lost points");
+
+  // An inner and an edge spike go back to their neighbours
+  fill(z, bowed);
+  z[3][3] += 1.0f;
+  z[0][2] -= 0.8f;
+  CHECK(anker_mesh_filter.reject_outliers(z) == 2, "spikes not replaced");
+  CHECK_NEAR(z[3][3], ref[3][3], 0.1f);
+  CHECK_NEAR(z[0][2], ref[0][2], 0.1f);
+
+  // Under the edge noise floor an edge step stays
+  fill(z, bowed);
+  z[0][2] += MESH_FILTER_EDGE_NOISE * 0.8f;
+  CHECK(anker_mesh_filter.reject_outliers(z) == 0, "edge step under the floor replaced");
+
+  // Unprobed points are neither replaced nor used
+  fill(z, bowed);
+  z[2][4] = NAN;
+  z[4][4] += 1.0f;
+  CHECK(anker_mesh_filter.reject_outliers(z) == 1, "spike next to a hole not replaced");
+  CHECK(isnan(z[2][4]), "hole filled");
+  CHECK_NEAR(z[4][4], ref[4][4], 0.1f);
+}
+
+static void test_refine_edges() {
+  const float plane[6] = { 0.1f, 0.2f, -0.3f, 0, 0, 0 };
+  bed_mesh_t z, ref;
+  mesh_flags_t flagged;
+  fill(ref, plane);
+
+  // Points the outlier test kept are never moved, however far off the line
+  COPY(z, ref);
+  z[0][3] += 0.5f;
+  z[MESH_X - 1][2] -= 0.5f;
+  ZERO(flagged);
+  CHECK(anker_mesh_filter.refine_edges(z, flagged) == 0, "unflagged edge points moved");
+  CHECK_NEAR(z[0][3], ref[0][3] + 0.5f, 1e-6f);
+  CHECK_NEAR(z[MESH_X - 1][2], ref[MESH_X - 1][2] - 0.5f, 1e-6f);
+
+  #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
+    // A flagged edge point bends at most EDGE_SLOPE off the line of the two inside it
+    flagged[0][3] = flagged[MESH_X - 1][2] = true;
+    CHECK(anker_mesh_filter.refine_edges(z, flagged) == 2, "flagged edge points not bent");
+    CHECK_NEAR(z[0][3], ref[0][3] + MESH_FILTER_EDGE_SLOPE, 1e-5f);
+    CHECK_NEAR(z[MESH_X - 1][2], ref[MESH_X - 1][2] - MESH_FILTER_EDGE_SLOPE, 1e-5f);
+
+    // Within the slope, or inside the grid, a flagged point stays
+    COPY(z, ref);
+    z[2][0] += MESH_FILTER_EDGE_SLOPE * 0.5f;
+    z[3][3] += 0.5f;
+    ZERO(flagged);
+    flagged[2][0] = flagged[3][3] = true;
+    CHECK(anker_mesh_filter.refine_edges(z, flagged) == 0, "flagged point in the slope or inside moved");
+    CHECK_NEAR(z[2][0], ref[2][0] + MESH_FILTER_EDGE_SLOPE * 0.5f, 1e-6f);
+    CHECK_NEAR(z[3][3], ref[3][3] + 0.5f, 1e-6f);
+  #else
+    flagged[0][3] = true;
+    CHECK(anker_mesh_filter.refine_edges(z, flagged) == 0, "edges bent without EXTRAPOLATE_BEYOND_GRID");
+  #endif
+}
+
+static void test_process() {
+  const float plane[6] = { 0.1f, 0.02f, -0.03f, 0, 0, 0 };
+  bed_mesh_t z, ref;
+
+  // A clean bowed bed goes through untouched
+  fill(z, bowed);
+  COPY(ref, z);
+  CHECK(anker_mesh_filter.process(z) == 0, "bowed mesh changed");
+  GRID_LOOP(x, y) CHECK_NEAR(z[x][y], ref[x][y], 1e-6f);
+
+  // So does a whole edge row drooping under the edge noise floor, that is the bed
+  fill(z, plane);
+  LOOP_L_N(y, MESH_Y) z[0][y] -= MESH_FILTER_EDGE_NOISE * 0.7f;
+  COPY(ref, z);
+  CHECK(anker_mesh_filter.process(z) == 0, "drooping edge changed");
+  GRID_LOOP(x, y) CHECK_NEAR(z[x][y], ref[x][y], 1e-6f);
+
+  // An edge spike is replaced and ends up on the line of the points inside it
+  fill(z, plane);
+  COPY(ref, z);
+  z[0][3] += 1.0f;
+  CHECK(anker_mesh_filter.process(z) >= 1, "edge spike kept");
+  CHECK_NEAR(z[0][3], ref[0][3], MESH_FILTER_EDGE_SLOPE + 1e-5f);
+  GRID_LOOP(x, y) if (x || y != 3) CHECK_NEAR(z[x][y], ref[x][y], 1e-6f);
+}
+
+static void test_smooth() {
+  bed_mesh_t z;
+
+  // A flat mesh stays flat
+  GRID_LOOP(x, y) z[x][y] = 0.25f;
+  anker_mesh_filter.smooth(z);
+  GRID_LOOP(x, y) CHECK_NEAR(z[x][y], 0.25f, 1e-6f);
+
+  // A plane keeps its inner points, 1-2-1 is exact on a line
+  const float plane[6] = { 0.1f, 0.2f, -0.3f, 0, 0, 0 };
+  bed_mesh_t ref;
+  fill(z, plane);
+  COPY(ref, z);
+  anker_mesh_filter.smooth(z);
+  LOOP_S_L_N(x, 1, MESH_X - 1) LOOP_S_L_N(y, 1, MESH_Y - 1) CHECK_NEAR(z[x][y], ref[x][y], 1e-5f);
+
+  // An impulse spreads into the 3x3 kernel, 4/16 in the middle
+  ZERO(z);
+  z[3][3] = 16.0f;
+  anker_mesh_filter.smooth(z);
+  CHECK_NEAR(z[3][3], 4.0f, 1e-5f);
+  CHECK_NEAR(z[2][3], 2.0f, 1e-5f);
+  CHECK_NEAR(z[3][4], 2.0f, 1e-5f);
+  CHECK_NEAR(z[2][2], 1.0f, 1e-5f);
+  CHECK_NEAR(z[4][4], 1.0f, 1e-5f);
+  CHECK_NEAR(z[1][3], 0.0f, 1e-6f);
+}
+
+static void test_fits() {
+  bed_mesh_t z;
+  float c[6], pv;
+
+  // A plane comes back from both fits
+  const float plane[6] = { 0.12f, 0.03f, -0.05f, 0, 0, 0 };
+  fill(z, plane);
+  CHECK(anker_mesh_filter.fit_plane(z, c), "plane fit failed");
+  LOOP_L_N(i, 6) CHECK_NEAR(c[i], plane[i], 1e-4f);
+  CHECK_NEAR(anker_mesh_filter.fit_residual(z, c, pv), 0.0f, 1e-4f);
+  CHECK_NEAR(pv, 0.0f, 1e-4f);
+  CHECK(anker_mesh_filter.fit_quadric(z, c), "quadric fit of a plane failed");
+  LOOP_L_N(i, 6) CHECK_NEAR(c[i], plane[i], 1e-4f);
+
+  // A quadric, with holes
+  fill(z, bowed);
+  z[1][5] = z[6][0] = NAN;
+  CHECK(anker_mesh_filter.fit_quadric(z, c), "quadric fit failed");
+  LOOP_L_N(i, 6) CHECK_NEAR(c[i], bowed[i], 1e-4f);
+  CHECK_NEAR(anker_mesh_filter.fit_residual(z, c, pv), 0.0f, 1e-4f);
+
+  // The plane fit leaves the bow as residual
+  CHECK(anker_mesh_filter.fit_plane(z, c), "plane fit of a quadric failed");
+  CHECK(anker_mesh_filter.fit_residual(z, c, pv) > 0.01f && pv > 0.05f, "bow not in the plane residual");
+
+  // A +-d checkerboard on a plane: RMS d, peak to valley 2d
+  const float d = 0.01f;
+  fill(z, plane);
+  GRID_LOOP(x, y) z[x][y] += ((x + y) & 1) ? d : -d;
+  const float rms = anker_mesh_filter.fit_residual(z, plane, pv);
+  CHECK_NEAR(rms, d, 1e-5f);
+  CHECK_NEAR(pv, 2 * d, 1e-5f);
+
+  // Too few points
+  GRID_LOOP(x, y) z[x][y] = NAN;
+  z[0][0] = z[1][1] = 0;
+  CHECK(!anker_mesh_filter.fit_quadric(z, c), "quadric fit of two points");
+}
+
+// Per call, over a copy of a bowed noisy mesh
+template <typename F>
+static void bench(const char *name, const uint32_t iterations, F f) {
+  bed_mesh_t base, z;
+  fill(base, bowed);
+  GRID_LOOP(x, y) base[x][y] += noise(0.05f);
+  base[2][5] += 0.7f;
+  volatile float sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++) {
+    COPY(z, base);
+    sink = sink + f(z);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+  printf("%-16s %9.1f ns/call\n", name, ns);
+}
+
+int main(int argc, char **argv) {
+  test_outliers();
+  test_refine_edges();
+  test_process();
+  test_smooth();
+  test_fits();
+  printf("mesh %dx%d: %s (%u failed)\n", MESH_X, MESH_Y, failures ? "FAIL" : "PASS", failures);
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    const uint32_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000;
+    float c[6], pv;
+    bench("copy", n, [](bed_mesh_t &) { return 0.0f; });
+    bench("reject_outliers", n, [](bed_mesh_t &z) { return float(anker_mesh_filter.reject_outliers(z)); });
+    bench("smooth", n, [](bed_mesh_t &z) { anker_mesh_filter.smooth(z); return z[3][3]; });
+    bench("fit_plane", n, [&](bed_mesh_t &z) { anker_mesh_filter.fit_plane(z, c); return c[0]; });
+    bench("fit_quadric", n, [&](bed_mesh_t &z) { anker_mesh_filter.fit_quadric(z, c); return c[0]; });
+    bench("fit_residual", n, [&](bed_mesh_t &z) { return anker_mesh_filter.fit_residual(z, bowed, pv); });
+  }
+  return failures ? 1 : 0;
+}
+
+#endif // ANKER_MESH_FILTER_HOST
@@ -0,0 +1,482 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 18:42:07
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 18:42:07
+ * @Description  : Host G-code prepass, G0-G3 into pre-leveled, pre-segmented move packets
+ */
+#ifdef ANKER_PREPASS_HOST
+
+#include "anker_prepass.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+enum { PX, PY, PZ, PE };
+
+// Worst case record: flags, 4 deltas, feedrate, length
+#define PREPASS_RECORD_MAX  (1 + 4 * PREPASS_AXES + 2 + 4)
+
+static inline int32_t quant(const double v) { return int32_t(lround(v * MOVE_PACKET_UNITS)); }
+
+/**
+ * @brief  The "+moveconf" line of M4904 C, as the firmware printed it
+ * @param  line the line, "+moveconf:" and all
+ * @param  cfg settings, the mesh is left alone
+ * @retval false if the line is not a complete one
+ */
+bool prepass_read_config(const char *line, prepass_config_t &cfg) {
+  const char *s = strstr(line, "+moveconf:");
+  if (!s) return false;
+  int circle, soft, level;
+  const bool ok = sscanf(s + 10, "%f,%f,%f,%d,%d,%f,%f,%f,%f,%f,%f,%d,%f,%f",
+                         &cfg.segment_mm, &cfg.arc_min_mm, &cfg.arc_max_mm, &circle, &soft,
+                         &cfg.soft_min[0], &cfg.soft_min[1], &cfg.soft_min[2],
+                         &cfg.soft_max[0], &cfg.soft_max[1], &cfg.soft_max[2],
+                         &level, &cfg.fade_height, &cfg.fade_hold) == 14;
+  if (!ok || cfg.segment_mm <= 0 || cfg.arc_min_mm <= 0 || cfg.arc_max_mm < cfg.arc_min_mm || circle <= 0) return false;
+  cfg.min_circle_segments = circle;
+  cfg.soft_endstops = soft != 0;
+  cfg.leveling = level != 0;
+  return true;
+}
+
+Anker_Prepass::Anker_Prepass(const prepass_config_t &c, text_sink_t text, frame_sink_t frame)
+  : cfg(c), text_out(text), frame_out(frame), leveling(c.leveling), fade_height(c.fade_height) {
+  memset(&current, 0, sizeof(current));
+}
+
+/**
+ * @brief  Position of the printer, from M114 or after homing. The moves go as packets again.
+ * @param  pos X, Y, Z, E in mm
+ * @retval None
+ */
+void Anker_Prepass::set_position(const float pos[PREPASS_AXES]) {
+  flush();
+  for (uint8_t i = 0; i < PREPASS_AXES; i++) current.v[i] = pos[i];
+  known = true;
+}
+
+/**
+ * @brief  One line of the print file
+ * @param  gcode the line as sliced, with or without N and *checksum
+ * @retval None
+ */
+void Anker_Prepass::line(const char *gcode) {
+  lines++;
+  std::string s(gcode);
+
+  const size_t comment = s.find(';');
+  if (comment != std::string::npos) s.erase(comment);
+  const size_t star = s.find('*');
+  if (star != std::string::npos) s.erase(star);
+
+  size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos) return;
+  if (toupper(s[b]) == 'N') {                         // Line number, the host frames the commands again
+    b++;
+    while (b < s.size() && (isdigit(s[b]) || s[b] == '-')) b++;
+    b = s.find_first_not_of(" \t", b);
+    if (b == std::string::npos) return;
+  }
+  const size_t e = s.find_last_not_of(" \t\r\n");
+  s = s.substr(b, e - b + 1);
+  command(&s[0]);
+}
+
+// Commands that move the head by themselves, the position is lost after them
+bool Anker_Prepass::moves_head(const char letter, const int code) const {
+  if (letter == 'T') return true;
+  if (letter == 'G') {
+    switch (code) {
+      case 0: case 1: case 2: case 3: case 4:
+      case 20: case 21: case 90: case 91: case 92:
+        return false;
+      default:
+        return true;
+    }
+  }
+  switch (code) {
+    case 18: case 84:                                 // Steppers off, HOME_AFTER_DEACTIVATE
+    case 112: case 125: case 410:
+    case 600: case 701: case 702: case 1000:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Anker_Prepass::can_pack() const {
+  return known && (!leveling || (cfg.grid_x >= 2 && cfg.grid_y >= 2 && cfg.z_values.size() >= size_t(cfg.grid_x) * cfg.grid_y));
+}
+
+void Anker_Prepass::command(char *s) {
+  // A '%' tape mark, Marlin runs nothing for it and at the start of a line it opens a frame
+  if (s[0] == MOVE_PACKET_SYNC) return;
+
+  const char letter = toupper(s[0]);
+  if (letter != 'G' && letter != 'M' && letter != 'T') {
+    flush();
+    text_out(s);
+    return;
+  }
+
+  char *p = s + 1;
+  const int code = strtol(p, &p, 10);
+  const bool subcode = *p == '.';
+
+  if (subcode || moves_head(letter, code)) {
+    flush();
+    text_out(s);
+    known = false;
+    return;
+  }
+
+  // Words of the command, A/B/C/D are X/Y/Z/E as in the multi packs
+  bool seen[26] = { false };
+  double val[26] = { 0 };
+  if (letter == 'G' || code == 420) {
+    while (*p) {
+      char w = toupper(*p++);
+      if (w < 'A' || w > 'Z') continue;
+      if (letter == 'G' && w >= 'A' && w <= 'D') w = "XYZE"[w - 'A'];
+      seen[w - 'A'] = true;
+      val[w - 'A'] = strtod(p, &p);
+    }
+  }
+  #define SEEN(L) seen[(L) - 'A']
+  #define VAL(L)  val[(L) - 'A']
+
+  if (letter == 'G') {
+    const double units = inches ? 25.4 : 1.0;
+    switch (code) {
+      case 0: case 1: case 2: case 3: {
+        if (SEEN('F') && VAL('F') > 0) feedrate = VAL('F') * units / 60.0;
+
+        pos_t dest = current;
+        bool any = false;
+        for (uint8_t i = 0; i < PREPASS_AXES; i++) {
+          const char w = "XYZE"[i];
+          if (!SEEN(w)) continue;
+          const double v = VAL(w) * units;
+          dest.v[i] = (i == PE ? relative_e : relative) ? current.v[i] + v : v;
+          any = true;
+        }
+
+        if (!can_pack() || (code < 2 && !any)) {
+          flush();
+          text_out(s);
+          if (!known) return;
+          text_moves++;
+          limits(dest);
+          current = dest;
+          return;
+        }
+
+        if (code < 2) {
+          line_to(dest);
+          return;
+        }
+
+        // G2/G3 in the IJ or R form, as G2_G3.cpp
+        double off_x = 0, off_y = 0;
+        if (SEEN('R')) {
+          const double r = VAL('R') * units;
+          if (r && (dest.v[PX] != current.v[PX] || dest.v[PY] != current.v[PY])) {
+            const double d2x = (dest.v[PX] - current.v[PX]) * 0.5, d2y = (dest.v[PY] - current.v[PY]) * 0.5,
+                         e = ((code == 2) ^ (r < 0)) ? -1 : 1,
+                         len = hypot(d2x, d2y),
+                         h2 = (r - len) * (r + len),
+                         h = h2 >= 0 ? sqrt(h2) : 0.0;
+            off_x = d2x - d2y / len * e * h;
+            off_y = d2y + d2x / len * e * h;
+          }
+        }
+        else {
+          if (SEEN('I')) off_x = VAL('I') * units;
+          if (SEEN('J')) off_y = VAL('J') * units;
+        }
+        if (!off_x && !off_y) {                       // Bad arc, the firmware reports it
+          flush();
+          text_out(s);
+          return;
+        }
+        arc_to(dest, off_x, off_y, code == 2);
+        return;
+      }
+
+      case 20: inches = true; break;
+      case 21: inches = false; break;
+      case 90: relative = relative_e = false; break;
+      case 91: relative = relative_e = true; break;
+      case 92:                                        // NO_WORKSPACE_OFFSETS, G92 sets the position
+        for (uint8_t i = 0; i < PREPASS_AXES; i++) {
+          const char w = "XYZE"[i];
+          if (SEEN(w)) current.v[i] = VAL(w) * units;
+        }
+        break;
+    }
+  }
+  else if (letter == 'M') {
+    switch (code) {
+      case 82: relative_e = false; break;
+      case 83: relative_e = true; break;
+      case 420:
+        if (SEEN('S')) leveling = VAL('S') != 0;
+        if (SEEN('Z')) fade_height = VAL('Z');
+        break;
+    }
+  }
+
+  flush();
+  text_out(s);
+}
+
+void Anker_Prepass::limits(pos_t &p) const {
+  if (!cfg.soft_endstops) return;
+  for (uint8_t i = 0; i < 3; i++) {
+    if (p.v[i] < cfg.soft_min[i]) p.v[i] = cfg.soft_min[i];
+    if (p.v[i] > cfg.soft_max[i]) p.v[i] = cfg.soft_max[i];
+  }
+}
+
+/**
+ * @brief  A G0/G1 as line_to_destination_cartesian() and segmented_line_to_destination()
+ * @param  target destination, unleveled
+ * @retval None
+ */
+void Anker_Prepass::line_to(const pos_t &target) {
+  pos_t dest = target;
+  limits(dest);
+  moves++;
+
+  if (!leveling || (fade_height && float(dest.v[PZ]) >= fade_height)) {
+    segment(dest, 0);
+    return;
+  }
+
+  pos_t diff;
+  for (uint8_t i = 0; i < PREPASS_AXES; i++) diff.v[i] = dest.v[i] - current.v[i];
+
+  // Only Z/E, not split
+  if (!diff.v[PX] && !diff.v[PY]) {
+    segment(dest, 0);
+    return;
+  }
+
+  double mm = sqrt(diff.v[PX] * diff.v[PX] + diff.v[PY] * diff.v[PY] + diff.v[PZ] * diff.v[PZ] + diff.v[PE] * diff.v[PE]);
+  if (mm < 0.000001) mm = fabs(diff.v[PE]);
+  if (mm < 0.000001) return;
+
+  uint16_t segments = uint16_t(mm / cfg.segment_mm);
+  if (segments < 1) segments = 1;
+  const float segment_mm = mm / segments;
+
+  pos_t raw = current;
+  for (uint16_t n = 1; n < segments; n++) {
+    for (uint8_t i = 0; i < PREPASS_AXES; i++) raw.v[i] += diff.v[i] / segments;
+    segment(raw, segment_mm);
+  }
+  segment(dest, segment_mm);
+}
+
+/**
+ * @brief  A G2/G3 in the XY plane as plan_arc(), the sin/cos of every segment worked out exactly
+ * @param  cart destination, unleveled
+ * @param  off_x, off_y center relative to the current position
+ * @param  clockwise G2
+ * @retval None
+ */
+void Anker_Prepass::arc_to(const pos_t &cart, const double off_x, const double off_y, const bool clockwise) {
+  const pos_t start = current;
+  const double rx = -off_x, ry = -off_y,
+               radius = hypot(rx, ry),
+               center_x = start.v[PX] - rx, center_y = start.v[PY] - ry,
+               rt_x = cart.v[PX] - center_x, rt_y = cart.v[PY] - center_y;
+
+  double angular_travel;
+  uint16_t min_segments;
+  if (fabs(start.v[PX] - cart.v[PX]) < 0.001 && fabs(start.v[PY] - cart.v[PY]) < 0.001) {
+    angular_travel = clockwise ? -2 * M_PI : 2 * M_PI;
+    min_segments = cfg.min_circle_segments;
+  }
+  else {
+    angular_travel = atan2(rx * rt_y - ry * rt_x, rx * rt_x + ry * rt_y);
+    if (!angular_travel) return;
+    if (angular_travel < 0 && !clockwise) angular_travel += 2 * M_PI;
+    else if (angular_travel > 0 && clockwise) angular_travel -= 2 * M_PI;
+    min_segments = uint16_t(ceil(cfg.min_circle_segments * fabs(angular_travel) / (2 * M_PI)));
+  }
+
+  const double travel_z = cart.v[PZ] - start.v[PZ], travel_e = cart.v[PE] - start.v[PE],
+               flat_mm = radius * fabs(angular_travel);
+  if (flat_mm < 0.0001 && travel_z < 0.0001) return;
+
+  moves++;
+
+  double nominal_segments = floor(flat_mm / cfg.arc_max_mm);
+  if (nominal_segments < min_segments) nominal_segments = min_segments;
+  double segment_mm = flat_mm / nominal_segments;
+  if (segment_mm < cfg.arc_min_mm) segment_mm = cfg.arc_min_mm;
+  if (segment_mm > cfg.arc_max_mm) segment_mm = cfg.arc_max_mm;
+
+  uint16_t segments = uint16_t(floor(flat_mm / segment_mm));
+  const double segmented_length = segment_mm * segments;
+  const bool tooshort = segmented_length < flat_mm - 0.0001;
+  const double proportion = tooshort ? segmented_length / flat_mm : 1.0;
+  const double theta = segments ? proportion * angular_travel / segments : 0,
+               per_z = segments ? proportion * travel_z / segments : 0,
+               per_e = segments ? proportion * travel_e / segments : 0;
+  if (tooshort) segments++;
+
+  pos_t raw = start;
+  for (uint16_t i = 1; i < segments; i++) {
+    const double c = cos(i * theta), s = sin(i * theta);
+    raw.v[PX] = center_x - off_x * c + off_y * s;
+    raw.v[PY] = center_y - off_x * s - off_y * c;
+    raw.v[PZ] += per_z;
+    raw.v[PE] += per_e;
+    pos_t seg = raw;
+    limits(seg);
+    segment(seg, 0);
+  }
+
+  raw = cart;
+  limits(raw);
+  segment(raw, 0);
+}
+
+float Anker_Prepass::fade(const float z) const {
+  if (!fade_height || z <= cfg.fade_hold) return 1;
+  if (z >= fade_height) return 0;
+  return 1 - z * (1.0f / fade_height);
+}
+
+/**
+ * @brief  The Catmull-Rom offset of bicubic_z_offset(), EXTRAPOLATE_BEYOND_GRID
+ * @param  x, y position in mm
+ * @retval Z offset in mm
+ */
+float Anker_Prepass::z_offset(const float x, const float y) {
+  const int8_t nx = cfg.grid_x, ny = cfg.grid_y;
+  float tx = (x - cfg.grid_start[0]) * (1.0f / cfg.grid_spacing[0]),
+        ty = (y - cfg.grid_start[1]) * (1.0f / cfg.grid_spacing[1]);
+  int8_t gx = int8_t(floorf(tx) < 0 ? 0 : floorf(tx) > nx - 2 ? nx - 2 : floorf(tx)),
+         gy = int8_t(floorf(ty) < 0 ? 0 : floorf(ty) > ny - 2 ? ny - 2 : floorf(ty));
+  tx -= gx;
+  ty -= gy;
+
+  if (gx != cell_x || gy != cell_y) {
+    cell_x = gx;
+    cell_y = gy;
+    const auto z = [&](const int8_t i, const int8_t j) { return cfg.z_values[i * ny + j]; };
+    cell.build([&](const int8_t i, const int8_t j) { return catmull_rom_grid(z, nx, ny, gx - 1 + i, gy - 1 + j); });
+  }
+
+  const float u = tx < 0 ? 0 : tx > 1 ? 1 : tx, v = ty < 0 ? 0 : ty > 1 ? 1 : ty;
+  float c[4];
+  cell.at_v(v, c);
+  float zo = catmull_rom_cell::poly(c, u);
+  if (tx != u) zo += (tx - u) * catmull_rom_cell::slope(c, u);
+  if (ty != v) zo += (ty - v) * cell.dv(u, v);
+  return zo;
+}
+
+// Packet header from the current position, the first record carries the feedrate
+void Anker_Prepass::open() {
+  uint8_t *p = buf;
+  for (uint8_t i = 0; i < PREPASS_AXES; i++) {
+    q_start[i] = q_last[i] = quant(current.v[i]);
+    move_packet_put(p, uint32_t(q_start[i]), 4);
+  }
+  double z = current.v[PZ];
+  if (leveling) {
+    const float f = fade(float(z));
+    if (f) z += f * z_offset(float(current.v[PX]), float(current.v[PY]));
+  }
+  q_last[PZ] = quant(z);
+  move_packet_put(p, uint32_t(q_last[PZ] - q_start[PZ]), 4);
+  p += 4 * PREPASS_AXES;                              // End, written by flush()
+  size = MOVE_PACKET_HEADER;
+  count = 0;
+}
+
+/**
+ * @brief  One planner move, buffer_line() on the MCU: leveled here, quantized, into the packet
+ * @param  raw target, unleveled
+ * @param  mm length for the planner, 0 to let it work it out
+ * @retval None
+ */
+void Anker_Prepass::segment(const pos_t &raw, const float mm) {
+  if (size && (size + PREPASS_RECORD_MAX > MOVE_PACKET_MAX || count == 255)) flush();
+  if (!size) open();
+
+  double lev[PREPASS_AXES] = { raw.v[PX], raw.v[PY], raw.v[PZ], raw.v[PE] };
+  if (leveling) {
+    const float f = fade(float(raw.v[PZ]));
+    if (f) lev[PZ] += f * z_offset(float(raw.v[PX]), float(raw.v[PY]));
+  }
+
+  uint8_t *flags = buf + size, *p = flags + 1;
+  *flags = 0;
+  for (uint8_t i = 0; i < PREPASS_AXES; i++) {
+    const int32_t q = quant(lev[i]);
+    if (q == q_last[i]) continue;
+    *flags |= 1 << i;
+    move_packet_put(p, uint32_t(q - q_last[i]), 4);
+    q_last[i] = q;
+  }
+  current = raw;
+  if (!*flags) return;                                // Less than a unit, the planner would drop it too
+
+  long f = lround(feedrate * MOVE_PACKET_FR_UNITS);
+  const uint16_t fr = f < 1 ? 1 : f > 0xFFFF ? 0xFFFF : uint16_t(f);
+  if (!count || fr != fr_last) {
+    *flags |= MOVE_FR;
+    move_packet_put(p, fr, 2);
+    fr_last = fr;
+  }
+  if (mm > 0 && (*flags & (MOVE_X | MOVE_Y | MOVE_Z))) {
+    *flags |= MOVE_MM;
+    move_packet_put(p, uint32_t(lround(mm * MOVE_PACKET_UNITS)), 4);
+  }
+
+  size = p - buf;
+  count++;
+  records++;
+}
+
+/**
+ * @brief  The pending packet out as a '%' frame. Before any text, to keep the order.
+ * @retval None
+ */
+void Anker_Prepass::flush() {
+  if (!size) return;
+  const uint16_t len = size;
+  size = 0;
+  if (!count) return;
+
+  uint8_t *p = buf + 4 * PREPASS_AXES + 4;
+  for (uint8_t i = 0; i < PREPASS_AXES; i++) move_packet_put(p, uint32_t(quant(current.v[i])), 4);
+
+  std::vector<uint8_t> frame;
+  frame.reserve(len + 6);
+  frame.push_back(MOVE_PACKET_SYNC);
+  frame.push_back(count);
+  frame.push_back(uint8_t(len));
+  frame.push_back(uint8_t(len >> 8));
+  frame.insert(frame.end(), buf, buf + len);
+  const uint16_t crc = move_packet_crc(0, &frame[1], len + 3);
+  frame.push_back(uint8_t(crc >> 8));
+  frame.push_back(uint8_t(crc));
+
+  frame_out(frame.data(), uint16_t(frame.size()));
+  packets++;
+  count = 0;
+}
+
+#endif // ANKER_PREPASS_HOST
@@ -0,0 +1,107 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 18:42:07
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 18:42:07
+ * @Description  : Host G-code prepass, G0-G3 into pre-leveled, pre-segmented move packets
+ */
+#pragma once
+
+/**
+ * Built for the host only (env:linux_prepass, -DANKER_PREPASS_HOST), empty in the firmware builds.
+ *
+ * The stages the MCU runs for every G0-G3, done once ahead of time on the host:
+ *  - A/B/C/D to X/Y/Z/E of the multi packs, N words, comments and checksums
+ *  - G20/G21, G90/G91, M82/M83, G92 and F
+ *  - software endstops, SEGMENT_LEVELED_MOVES and the G2/G3 segments of plan_arc()
+ *  - the Catmull-Rom bed leveling of ABL_BILINEAR_BICUBIC with the ANKER_LEVEING_FADE fade
+ * The moves leave as '%' frames for anker_move_stream, see anker_move_packet.h. Everything
+ * else leaves as text, in order. A command that moves the head on its own (G28, G29, T, M600...)
+ * loses the position: the moves after it go as text until set_position() gets the position back
+ * from the printer (M114).
+ * The MCU only takes a '%' at the start of a line for a frame: text lines never start with
+ * one (the '%' tape marks are dropped), a '%' inside one ("M117 50% done") stays text.
+ */
+#ifdef ANKER_PREPASS_HOST
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+#include "../anker_move_packet.h"
+#include "../../../libs/catmull_rom.h"
+
+#define PREPASS_AXES    4
+
+// The settings of the printer, from the "+moveconf" line of M4904 C, see prepass_main --config
+typedef struct {
+  float segment_mm = 0;                               // LEVELED_SEGMENT_LENGTH
+  float arc_min_mm = 0, arc_max_mm = 0;               // MIN_ARC_SEGMENT_MM, MAX_ARC_SEGMENT_MM
+  uint16_t min_circle_segments = 0;                   // MIN_CIRCLE_SEGMENTS
+  bool soft_endstops = false;                         // M211
+  float soft_min[3] = { 0 }, soft_max[3] = { 0 };     // soft_endstop.min / max
+
+  // The bed mesh, as M420 V prints it. Empty, the leveled moves go as text.
+  uint8_t grid_x = 0, grid_y = 0;
+  float grid_start[2] = { 0, 0 }, grid_spacing[2] = { 1, 1 };
+  std::vector<float> z_values;                        // z_values[x][y] at x * grid_y + y
+  bool leveling = false;                              // M420 S at the start of the print
+  float fade_height = 0, fade_hold = 0;               // M420 Z, LEVELING_FADE_HOLD_Z
+} prepass_config_t;
+
+bool prepass_read_config(const char *line, prepass_config_t &cfg);
+
+class Anker_Prepass {
+  public:
+    typedef std::function<void(const char *line)> text_sink_t;
+    typedef std::function<void(const uint8_t *frame, const uint16_t size)> frame_sink_t;
+
+    uint32_t lines = 0, moves = 0, packets = 0, records = 0, text_moves = 0;
+
+    Anker_Prepass(const prepass_config_t &cfg, text_sink_t text, frame_sink_t frame);
+
+    void line(const char *gcode);
+    void flush();
+    void set_position(const float pos[PREPASS_AXES]);
+    bool position_known() const { return known; }
+
+  private:
+    typedef struct { double v[PREPASS_AXES]; } pos_t;
+
+    prepass_config_t cfg;
+    text_sink_t text_out;
+    frame_sink_t frame_out;
+
+    pos_t current;                                    // current_position, unleveled
+    bool known = false;
+    bool inches = false, relative = false, relative_e = false;
+    float feedrate = 25;                              // mm/s
+    bool leveling;
+    float fade_height;
+
+    // Packet being filled
+    uint8_t buf[MOVE_PACKET_MAX];
+    uint16_t size = 0;
+    uint8_t count = 0;
+    int32_t q_start[PREPASS_AXES], q_last[PREPASS_AXES];
+    uint16_t fr_last = 0;
+
+    // Cell of the leveling surface
+    int8_t cell_x = -1, cell_y = -1;
+    catmull_rom_cell cell;
+
+    void command(char *s);
+    bool moves_head(const char letter, const int code) const;
+    bool can_pack() const;
+
+    void line_to(const pos_t &target);
+    void arc_to(const pos_t &dest, const double off_x, const double off_y, const bool clockwise);
+
+    void limits(pos_t &p) const;
+    float fade(const float z) const;
+    float z_offset(const float x, const float y);
+    void segment(const pos_t &raw, const float mm);
+    void open();
+};
+
+#endif // ANKER_PREPASS_HOST
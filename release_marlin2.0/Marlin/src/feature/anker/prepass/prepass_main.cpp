@@ -0,0 +1,122 @@
+/*
+ * @Author       : harley
+ * @Date         : 2026-10-18 18:42:07
+ * @LastEditors  : harley
+ * @LastEditTime : 2026-10-18 18:42:07
+ * @Description  : anker_prepass, a print file into text commands and move packets
+ */
+#ifdef ANKER_PREPASS_HOST
+
+#include "anker_prepass.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * anker_prepass --config <file> [options] <in.gcode> <out>
+ *   --config <file>      the "+moveconf" line M4904 C printed on this printer: segments, arcs,
+ *                        soft endstops, leveling on and fade height, the same as the firmware
+ *   --mesh <file>        grid_x grid_y start_x start_y spacing_x spacing_y, then the Z values
+ *                        one row per Y as M420 V prints them
+ *   --level              M420 S1 at the start of the print, over --config
+ *   --fade <mm>          fade height, over --config
+ *   --start X,Y,Z,E      position at the start, the moves go as text until then
+ *   --assume-home X,Y,Z  position after each G28, for files that G92 E0 after homing
+ * The output is what the Ingenic host streams: text commands one per line and '%' frames.
+ */
+
+static bool read_mesh(const char *path, prepass_config_t &cfg) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  int nx, ny;
+  bool ok = fscanf(f, "%d %d %f %f %f %f", &nx, &ny, &cfg.grid_start[0], &cfg.grid_start[1],
+                   &cfg.grid_spacing[0], &cfg.grid_spacing[1]) == 6 && nx >= 2 && ny >= 2 && nx < 128 && ny < 128;
+  if (ok) {
+    cfg.grid_x = nx;
+    cfg.grid_y = ny;
+    cfg.z_values.assign(nx * ny, 0);
+    for (int y = 0; ok && y < ny; y++)
+      for (int x = 0; ok && x < nx; x++)
+        ok = fscanf(f, "%f", &cfg.z_values[x * ny + y]) == 1;
+  }
+  fclose(f);
+  return ok;
+}
+
+static bool read_config(const char *path, prepass_config_t &cfg) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  bool ok = false;
+  while (!ok && fgets(line, sizeof(line), f)) ok = prepass_read_config(line, cfg);
+  fclose(f);
+  return ok;
+}
+
+static bool read_pos(const char *s, float *pos, const int n) {
+  for (int i = 0; i < n; i++) {
+    char *end;
+    pos[i] = strtof(s, &end);
+    if (end == s) return false;
+    s = *end == ',' ? end + 1 : end;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  prepass_config_t cfg;
+  float start[PREPASS_AXES] = { 0 }, home[PREPASS_AXES] = { 0 }, fade = -1;
+  bool have_config = false, have_start = false, have_home = false, level = false;
+  const char *in_path = nullptr, *out_path = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const bool more = i + 1 < argc;
+    if (!strcmp(a, "--config") && more) {
+      if (!(have_config = read_config(argv[++i], cfg))) { fprintf(stderr, "No +moveconf line in %s\n", argv[i]); return 1; }
+    }
+    else if (!strcmp(a, "--mesh") && more) {
+      if (!read_mesh(argv[++i], cfg)) { fprintf(stderr, "Bad mesh file %s\n", argv[i]); return 1; }
+    }
+    else if (!strcmp(a, "--level")) level = true;
+    else if (!strcmp(a, "--fade") && more) fade = strtof(argv[++i], nullptr);
+    else if (!strcmp(a, "--start") && more) have_start = read_pos(argv[++i], start, PREPASS_AXES);
+    else if (!strcmp(a, "--assume-home") && more) have_home = read_pos(argv[++i], home, 3);
+    else if (!in_path) in_path = a;
+    else if (!out_path) out_path = a;
+  }
+  if (!have_config || !in_path || !out_path) {
+    fprintf(stderr, "usage: %s --config file [--mesh file] [--level] [--fade mm] [--start X,Y,Z,E] [--assume-home X,Y,Z] in.gcode out\n", argv[0]);
+    return 1;
+  }
+  if (level) cfg.leveling = true;
+  if (fade >= 0) cfg.fade_height = fade;
+
+  FILE *in = fopen(in_path, "r"), *out = fopen(out_path, "wb");
+  if (!in || !out) { fprintf(stderr, "Can't open %s\n", in ? out_path : in_path); return 1; }
+
+  Anker_Prepass prepass(cfg,
+    [out](const char *line) { fputs(line, out); fputc('\n', out); },
+    [out](const uint8_t *frame, const uint16_t size) { fwrite(frame, 1, size, out); }
+  );
+  if (have_start) prepass.set_position(start);
+
+  char line[512];
+  while (fgets(line, sizeof(line), in)) {
+    prepass.line(line);
+    if (have_home && !prepass.position_known()) {
+      const char *g = line + strspn(line, " \t");
+      if ((g[0] == 'G' || g[0] == 'g') && atoi(g + 1) == 28) prepass.set_position(home);
+    }
+  }
+  prepass.flush();
+  fclose(in);
+  fclose(out);
+
+  fprintf(stderr, "lines:%u moves:%u packets:%u records:%u text moves:%u\n",
+          prepass.lines, prepass.moves, prepass.packets, prepass.records, prepass.text_moves);
+  return 0;
+}
+
+#endif // ANKER_PREPASS_HOST
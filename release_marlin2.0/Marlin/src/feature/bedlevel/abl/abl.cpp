@@ -35,6 +35,12 @@
   #include "../../../lcd/extui/ui_api.h"
 #endif
 
+#include "../../anker/anker_isr_profile.h"
+
+#if ENABLED(ABL_BILINEAR_BICUBIC)
+  #include "../../../libs/catmull_rom.h"
+#endif
+
 xy_pos_t bilinear_grid_spacing, bilinear_start;
 xy_float_t bilinear_grid_factor;
 bed_mesh_t z_values;
@@ -284,88 +290,146 @@ void refresh_bed_level() {
   #define ABL_BG_GRID(X,Y)  z_values[X][Y]
 #endif
 
+#if ENABLED(ABL_BILINEAR_BICUBIC)
+
+  // Polynomial of the grid cell at cached_g
+  static catmull_rom_cell cell_poly;
+
+  // Grid point, the grid continued in a straight line past its edges
+  static float grid_z(const int8_t x, const int8_t y) {
+    return catmull_rom_grid([](const int8_t i, const int8_t j) { return z_values[i][j]; }, GRID_MAX_POINTS_X, GRID_MAX_POINTS_Y, x, y);
+  }
+
+  static void cell_poly_refresh(const xy_int8_t &g) {
+    cell_poly.build([&](const int8_t i, const int8_t j) { return grid_z(g.x - 1 + i, g.y - 1 + j); });
+  }
+
+  /**
+   * Catmull-Rom Z adjustment. The surface passes through every probed point and its slope is
+   * continuous across the cell borders, so there are no facets at the grid lines.
+   * Beyond the grid it continues along the edge slope (EXTRAPOLATE_BEYOND_GRID) or holds the edge height.
+   */
+  static float bicubic_z_offset(const xy_pos_t &rel) {
+    xy_float_t t = rel * bilinear_grid_factor;
+    const xy_int8_t g = {
+      int8_t(constrain(FLOOR(t.x), 0, GRID_MAX_POINTS_X - 2)),
+      int8_t(constrain(FLOOR(t.y), 0, GRID_MAX_POINTS_Y - 2))
+    };
+    t.x -= g.x;
+    t.y -= g.y;
+
+    if (cached_g != g) {
+      cached_g = g;
+      cell_poly_refresh(g);
+    }
+
+    const float u = constrain(t.x, 0, 1), v = constrain(t.y, 0, 1);
+    float c[4];
+    cell_poly.at_v(v, c);
+    float z = catmull_rom_cell::poly(c, u);
+
+    #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
+      if (t.x != u) z += (t.x - u) * catmull_rom_cell::slope(c, u);
+      if (t.y != v) z += (t.y - v) * cell_poly.dv(u, v);
+    #endif
+
+    return z;
+  }
+
+#endif // ABL_BILINEAR_BICUBIC
+
 // Get the Z adjustment for non-linear bed leveling
 float bilinear_z_offset(const xy_pos_t &raw) {
 
-  static float z1, d2, z3, d4, L, D;
-
-  static xy_pos_t ratio;
+  ISR_PROFILE(PROF_LEVEL_Z);
 
-  // Whole units for the grid line indices. Constrained within bounds.
-  static xy_int8_t thisg, nextg;
+  #if ENABLED(ABL_BILINEAR_BICUBIC)
 
-  // XY relative to the probed area
-  xy_pos_t rel = raw - bilinear_start.asFloat();
+    return bicubic_z_offset(raw - bilinear_start.asFloat());
 
-  #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
-    #define FAR_EDGE_OR_BOX 2   // Keep using the last grid box
   #else
-    #define FAR_EDGE_OR_BOX 1   // Just use the grid far edge
-  #endif
 
-  if (cached_rel.x != rel.x) {
-    cached_rel.x = rel.x;
-    ratio.x = rel.x * ABL_BG_FACTOR(x);
-    const float gx = constrain(FLOOR(ratio.x), 0, ABL_BG_POINTS_X - (FAR_EDGE_OR_BOX));
-    ratio.x -= gx;      // Subtract whole to get the ratio within the grid box
+    static float z1, d2, z3, d4, L, D;
 
-    #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
-      // Beyond the grid maintain height at grid edges
-      NOLESS(ratio.x, 0); // Never <0 (>1 is ok when nextg.x==thisg.x)
-    #endif
+    static xy_pos_t ratio;
 
-    thisg.x = gx;
-    nextg.x = _MIN(thisg.x + 1, ABL_BG_POINTS_X - 1);
-  }
+    // Whole units for the grid line indices. Constrained within bounds.
+    static xy_int8_t thisg, nextg;
 
-  if (cached_rel.y != rel.y || cached_g.x != thisg.x) {
+    // XY relative to the probed area
+    xy_pos_t rel = raw - bilinear_start.asFloat();
+
+    #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
+      #define FAR_EDGE_OR_BOX 2   // Keep using the last grid box
+    #else
+      #define FAR_EDGE_OR_BOX 1   // Just use the grid far edge
+    #endif
 
-    if (cached_rel.y != rel.y) {
-      cached_rel.y = rel.y;
-      ratio.y = rel.y * ABL_BG_FACTOR(y);
-      const float gy = constrain(FLOOR(ratio.y), 0, ABL_BG_POINTS_Y - (FAR_EDGE_OR_BOX));
-      ratio.y -= gy;
+    if (cached_rel.x != rel.x) {
+      cached_rel.x = rel.x;
+      ratio.x = rel.x * ABL_BG_FACTOR(x);
+      const float gx = constrain(FLOOR(ratio.x), 0, ABL_BG_POINTS_X - (FAR_EDGE_OR_BOX));
+      ratio.x -= gx;      // Subtract whole to get the ratio within the grid box
 
       #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
         // Beyond the grid maintain height at grid edges
-        NOLESS(ratio.y, 0); // Never < 0.0. (> 1.0 is ok when nextg.y==thisg.y.)
+        NOLESS(ratio.x, 0); // Never <0 (>1 is ok when nextg.x==thisg.x)
       #endif
 
-      thisg.y = gy;
-      nextg.y = _MIN(thisg.y + 1, ABL_BG_POINTS_Y - 1);
+      thisg.x = gx;
+      nextg.x = _MIN(thisg.x + 1, ABL_BG_POINTS_X - 1);
     }
 
-    if (cached_g != thisg) {
-      cached_g = thisg;
-      // Z at the box corners
-      z1 = ABL_BG_GRID(thisg.x, thisg.y);       // left-front
-      d2 = ABL_BG_GRID(thisg.x, nextg.y) - z1;  // left-back (delta)
-      z3 = ABL_BG_GRID(nextg.x, thisg.y);       // right-front
-      d4 = ABL_BG_GRID(nextg.x, nextg.y) - z3;  // right-back (delta)
-    }
+    if (cached_rel.y != rel.y || cached_g.x != thisg.x) {
 
-    // Bilinear interpolate. Needed since rel.y or thisg.x has changed.
-                L = z1 + d2 * ratio.y;   // Linear interp. LF -> LB
-    const float R = z3 + d4 * ratio.y;   // Linear interp. RF -> RB
+      if (cached_rel.y != rel.y) {
+        cached_rel.y = rel.y;
+        ratio.y = rel.y * ABL_BG_FACTOR(y);
+        const float gy = constrain(FLOOR(ratio.y), 0, ABL_BG_POINTS_Y - (FAR_EDGE_OR_BOX));
+        ratio.y -= gy;
 
-    D = R - L;
-  }
+        #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
+          // Beyond the grid maintain height at grid edges
+          NOLESS(ratio.y, 0); // Never < 0.0. (> 1.0 is ok when nextg.y==thisg.y.)
+        #endif
 
-  const float offset = L + ratio.x * D;   // the offset almost always changes
+        thisg.y = gy;
+        nextg.y = _MIN(thisg.y + 1, ABL_BG_POINTS_Y - 1);
+      }
 
-  /*
-  static float last_offset = 0;
-  if (ABS(last_offset - offset) > 0.2) {
-    SERIAL_ECHOLNPAIR("Sudden Shift at x=", rel.x, " / ", bilinear_grid_spacing.x, " -> thisg.x=", thisg.x);
-    SERIAL_ECHOLNPAIR(" y=", rel.y, " / ", bilinear_grid_spacing.y, " -> thisg.y=", thisg.y);
-    SERIAL_ECHOLNPAIR(" ratio.x=", ratio.x, " ratio.y=", ratio.y);
-    SERIAL_ECHOLNPAIR(" z1=", z1, " z2=", z2, " z3=", z3, " z4=", z4);
-    SERIAL_ECHOLNPAIR(" L=", L, " R=", R, " offset=", offset);
-  }
-  last_offset = offset;
-  //*/
+      if (cached_g != thisg) {
+        cached_g = thisg;
+        // Z at the box corners
+        z1 = ABL_BG_GRID(thisg.x, thisg.y);       // left-front
+        d2 = ABL_BG_GRID(thisg.x, nextg.y) - z1;  // left-back (delta)
+        z3 = ABL_BG_GRID(nextg.x, thisg.y);       // right-front
+        d4 = ABL_BG_GRID(nextg.x, nextg.y) - z3;  // right-back (delta)
+      }
+
+      // Bilinear interpolate. Needed since rel.y or thisg.x has changed.
+                  L = z1 + d2 * ratio.y;   // Linear interp. LF -> LB
+      const float R = z3 + d4 * ratio.y;   // Linear interp. RF -> RB
+
+      D = R - L;
+    }
+
+    const float offset = L + ratio.x * D;   // the offset almost always changes
 
-  return offset;
+    /*
+    static float last_offset = 0;
+    if (ABS(last_offset - offset) > 0.2) {
+      SERIAL_ECHOLNPAIR("Sudden Shift at x=", rel.x, " / ", bilinear_grid_spacing.x, " -> thisg.x=", thisg.x);
+      SERIAL_ECHOLNPAIR(" y=", rel.y, " / ", bilinear_grid_spacing.y, " -> thisg.y=", thisg.y);
+      SERIAL_ECHOLNPAIR(" ratio.x=", ratio.x, " ratio.y=", ratio.y);
+      SERIAL_ECHOLNPAIR(" z1=", z1, " z2=", z2, " z3=", z3, " z4=", z4);
+      SERIAL_ECHOLNPAIR(" L=", L, " R=", R, " offset=", offset);
+    }
+    last_offset = offset;
+    //*/
+
+    return offset;
+
+  #endif
 }
 
 #if IS_CARTESIAN && DISABLED(SEGMENT_LEVELED_MOVES)
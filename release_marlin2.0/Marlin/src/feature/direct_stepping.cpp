@@ -199,6 +199,29 @@ namespace DirectStepping {
     SERIAL_EOL();
   }
 
+  // Take a FREE or FAIL page for writing, nullptr if it is still in use
+  template <typename Cfg>
+  uint8_t *SerialPageManager<Cfg>::begin_write(const page_idx_t page_idx) {
+    if (page_idx >= Cfg::NUM_PAGES) return nullptr;
+    const PageState s = page_states[page_idx];
+    if (s != PageState::FREE && s != PageState::FAIL) return nullptr;
+    set_page_state(page_idx, PageState::WRITING);
+    return pages[page_idx];
+  }
+
+  template <typename Cfg>
+  void SerialPageManager<Cfg>::end_write(const page_idx_t page_idx, const bool ok) {
+    set_page_state(page_idx, ok ? PageState::OK : PageState::FAIL);
+  }
+
+  template <typename Cfg>
+  uint8_t SerialPageManager<Cfg>::free_pages() {
+    uint8_t n = 0;
+    for (page_idx_t i = 0 ; i < Cfg::NUM_PAGES ; i++)
+      if (page_states[i] == PageState::FREE) n++;
+    return n;
+  }
+
   template <typename Cfg>
   FORCE_INLINE void SerialPageManager<Cfg>::set_page_state(const page_idx_t page_idx, const PageState page_state) {
     CHECK_PAGE(page_idx,);
@@ -61,6 +61,11 @@ namespace DirectStepping {
     static uint8_t *get_page(const page_idx_t page_idx);
     static void free_page(const page_idx_t page_idx);
 
+    // Page writers other than the rx isr, see anker_page_stream
+    static uint8_t *begin_write(const page_idx_t page_idx);
+    static void end_write(const page_idx_t page_idx, const bool ok);
+    static uint8_t free_pages();
+
   protected:
 
     typedef typename Cfg::write_byte_idx_t write_byte_idx_t;
@@ -178,7 +178,12 @@ void GcodeSuite::M3020()
         }
         return;
     }
-    uart_nozzle_tx_probe_leveling_val_get();
+
+    // The rx callback prints the value when the reply arrives
+    gcp_future_t reply;
+    uart_nozzle_tx_probe_leveling_val_get(&reply);
+    if (!uart_nozzle_wait_reply(&reply))
+        MYSERIAL2.printLine("echo:M3020 no reply\r\n");
 }
 
 #endif
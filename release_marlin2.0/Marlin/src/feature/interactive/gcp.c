@@ -52,6 +52,42 @@ int gcp_msg_check(gcp_msg_t *msg)
     return 0;
 }
 
+/**
+ * @brief    Pack the header of a frame whose content is already in place behind it
+ * @param    frame points at GCP_HEAD_LEN header bytes followed by content_len content bytes
+ * @param    type 消息类型
+ * @param    src_module 源模块ID
+ * @param    dst_module 目的模块ID
+ * @param    cmd 命令
+ * @param    content_len 消息内容长度
+ * @retval   消息包长度
+ */
+uint16_t gcp_head_pack(uint8_t *frame,
+                       uint8_t type,
+                       uint8_t src_module,
+                       uint8_t dst_module,
+                       uint8_t cmd,
+                       uint16_t content_len)
+{
+    uint16_t i;
+    uint8_t sum;
+
+    frame[0] = GCP_MAGIC0;
+    frame[1] = GCP_MAGIC1;
+    frame[2] = content_len & 0xFF;
+    frame[3] = content_len >> 8;
+    frame[4] = (type & 0x07) | (GCP_VERSION << 3);
+    frame[6] = (src_module & 0x0F) | (dst_module << 4);
+    frame[7] = cmd;
+
+    sum = frame[0] + frame[1] + frame[2] + frame[3] + frame[4] + frame[6] + frame[7];
+    for (i = 0; i < content_len; i++)
+        sum += frame[GCP_HEAD_LEN + i];
+    frame[5] = sum;
+
+    return content_len + GCP_HEAD_LEN;
+}
+
 /**
  * @brief    装载gcp消息包
  * @param    gcp_msg 消息包指针
@@ -16,7 +16,8 @@
 
 #define GCP_VERSION 0
 
-#define GCP_MSG_LEN(msg) (msg->content_len + 8)
+#define GCP_HEAD_LEN 8
+#define GCP_MSG_LEN(msg) (msg->content_len + GCP_HEAD_LEN)
 
 typedef struct
 {
@@ -43,6 +44,13 @@ uint8_t gcp_calc_check(gcp_msg_t *msg);
 
 int gcp_msg_check(gcp_msg_t *msg);
 
+uint16_t gcp_head_pack(uint8_t *frame,
+                       uint8_t type,
+                       uint8_t src_module,
+                       uint8_t dst_module,
+                       uint8_t cmd,
+                       uint16_t content_len);
+
 uint16_t gcp_msg_pack(gcp_msg_t *gcp_msg,
                       uint8_t type,
                       uint8_t src_module,
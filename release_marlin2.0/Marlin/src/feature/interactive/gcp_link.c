@@ -0,0 +1,224 @@
+#include "gcp_link.h"
+
+#include <string.h>
+
+#define GCP_LINK_TX_MASK (GCP_LINK_TX_SLOTS - 1)
+
+#define PENDING_FREE 0
+#define PENDING_WAIT 1
+#define PENDING_BUSY 2  // Being completed, owned by whoever moved it out of WAIT
+
+#define PENDING_ID(seq, index) (((int32_t)(seq) << 3) | (index))
+#define PENDING_INDEX(id)      ((id) & 0x07)
+#define PENDING_SEQ(id)        ((uint16_t)((id) >> 3))
+
+// The rx isr and the main loop both complete requests, only the one that wins the WAIT state does
+static bool pending_claim(gcp_link_pending_t *p, uint8_t to)
+{
+    uint8_t expected = PENDING_WAIT;
+    return __atomic_compare_exchange_n(&p->state, &expected, to, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+void gcp_link_init(gcp_link_t *link,
+                   uint8_t src_module,
+                   void (*send)(uint8_t *buf, uint16_t len),
+                   uint32_t (*get_time_ms)(void))
+{
+    link->src_module = src_module;
+    link->send = send;
+    link->get_time_ms = get_time_ms;
+}
+
+/**
+ * @brief  Reserve the next tx slot, the caller writes the content in place then calls gcp_link_tx_commit
+ * @param  link 链路指针
+ * @param  content_len 消息内容长度
+ * @retval content pointer, 0 if the queue is full or the content does not fit a slot
+ */
+uint8_t *gcp_link_tx_alloc(gcp_link_t *link, uint16_t content_len)
+{
+    gcp_link_slot_t *slot;
+
+    if ((uint8_t)(link->tx_head - link->tx_tail) >= GCP_LINK_TX_SLOTS || content_len > GCP_LINK_TX_CONTENT_MAX)
+    {
+        link->tx_dropped += 1;
+        return 0;
+    }
+
+    slot = &link->tx[link->tx_head & GCP_LINK_TX_MASK];
+    slot->len = content_len;
+    return &slot->frame[GCP_HEAD_LEN];
+}
+
+void gcp_link_tx_commit(gcp_link_t *link, uint8_t type, uint8_t dst_module, uint8_t cmd)
+{
+    gcp_link_slot_t *slot = &link->tx[link->tx_head & GCP_LINK_TX_MASK];
+
+    slot->len = gcp_head_pack(slot->frame, type, link->src_module, dst_module, cmd, slot->len);
+    link->tx_head += 1;
+}
+
+bool gcp_link_tx(gcp_link_t *link, uint8_t type, uint8_t dst_module, uint8_t cmd,
+                 const uint8_t *content, uint16_t content_len)
+{
+    uint8_t *p = gcp_link_tx_alloc(link, content_len);
+
+    if (p == 0)
+        return false;
+
+    if (content_len)
+        memcpy(p, content, content_len);
+    gcp_link_tx_commit(link, type, dst_module, cmd);
+    return true;
+}
+
+/**
+ * @brief  Wait for the next reply with the given cmd from the given module
+ *         Send the request frame after this, so a fast reply can not be missed.
+ * @param  link 链路指针
+ * @param  module 应答模块ID
+ * @param  cmd 应答命令
+ * @param  timeout_ms 超时时间
+ * @param  callback called with the reply, or with 0 on timeout, may be 0
+ * @param  ctx callback argument
+ * @param  future caller owned result, may be 0. Must stay valid until it leaves GCP_FUTURE_WAIT
+ *         or the request is cancelled.
+ * @retval request ID, -1 if all request slots are in use
+ */
+int32_t gcp_link_request(gcp_link_t *link, uint8_t module, uint8_t cmd, uint32_t timeout_ms,
+                         gcp_link_reply_t callback, void *ctx, gcp_future_t *future)
+{
+    uint8_t i;
+    gcp_link_pending_t *p;
+
+    for (i = 0; i < GCP_LINK_PENDING_MAX; i++)
+    {
+        p = &link->pending[i];
+        if (p->state != PENDING_FREE)
+            continue;
+
+        link->seq = (link->seq + 1) & 0x7FFF;
+        if (link->seq == 0)
+            link->seq = 1;
+
+        p->cmd = cmd;
+        p->module = module;
+        p->seq = link->seq;
+        p->deadline_ms = (link->get_time_ms ? link->get_time_ms() : 0) + timeout_ms;
+        p->callback = callback;
+        p->ctx = ctx;
+        p->future = future;
+        if (future)
+            future->state = GCP_FUTURE_WAIT;
+
+        __atomic_store_n(&p->state, PENDING_WAIT, __ATOMIC_RELEASE);
+        return PENDING_ID(p->seq, i);
+    }
+
+    if (future)
+        future->state = GCP_FUTURE_TIMEOUT;
+    return -1;
+}
+
+bool gcp_link_pending(gcp_link_t *link, int32_t id)
+{
+    gcp_link_pending_t *p;
+
+    if (id < 0 || PENDING_INDEX(id) >= GCP_LINK_PENDING_MAX)
+        return false;
+
+    p = &link->pending[PENDING_INDEX(id)];
+    return p->state != PENDING_FREE && p->seq == PENDING_SEQ(id);
+}
+
+void gcp_link_cancel(gcp_link_t *link, int32_t id)
+{
+    gcp_link_pending_t *p;
+
+    if (!gcp_link_pending(link, id))
+        return;
+
+    p = &link->pending[PENDING_INDEX(id)];
+    if (pending_claim(p, PENDING_FREE) && p->future)
+        p->future->state = GCP_FUTURE_TIMEOUT;
+}
+
+/**
+ * @brief  Complete the oldest request waiting for this reply, call from the parser callback
+ * @param  link 链路指针
+ * @param  msg 接收消息
+ * @retval None
+ */
+void gcp_link_rx_dispatch(gcp_link_t *link, gcp_msg_t *msg)
+{
+    uint8_t i;
+    gcp_link_pending_t *p, *oldest = 0;
+    gcp_future_t *f;
+
+    for (i = 0; i < GCP_LINK_PENDING_MAX; i++)
+    {
+        p = &link->pending[i];
+        if (p->state != PENDING_WAIT || p->cmd != msg->cmd || p->module != msg->src_module)
+            continue;
+        if (oldest == 0 || (int16_t)(p->seq - oldest->seq) < 0)
+            oldest = p;
+    }
+
+    if (oldest == 0 || !pending_claim(oldest, PENDING_BUSY))
+        return;
+
+    f = oldest->future;
+    if (f)
+    {
+        f->type = msg->type;
+        f->content_len = msg->content_len;
+        memcpy(f->content, msg->content, msg->content_len < GCP_FUTURE_CONTENT_MAX ? msg->content_len : GCP_FUTURE_CONTENT_MAX);
+        f->state = GCP_FUTURE_DONE;
+    }
+    if (oldest->callback)
+        oldest->callback(msg, oldest->ctx);
+
+    __atomic_store_n(&oldest->state, PENDING_FREE, __ATOMIC_RELEASE);
+}
+
+// Send every queued frame now, for callers that may not get back to the main loop
+void gcp_link_flush(gcp_link_t *link)
+{
+    gcp_link_slot_t *slot;
+
+    if (link->send == 0)
+        return;
+
+    while (link->tx_tail != link->tx_head)
+    {
+        slot = &link->tx[link->tx_tail & GCP_LINK_TX_MASK];
+        link->send(slot->frame, slot->len);
+        link->tx_tail += 1;
+    }
+}
+
+void gcp_link_poll(gcp_link_t *link)
+{
+    uint8_t i;
+    gcp_link_pending_t *p;
+    const uint32_t now_ms = link->get_time_ms ? link->get_time_ms() : 0;
+
+    gcp_link_flush(link);
+
+    for (i = 0; i < GCP_LINK_PENDING_MAX; i++)
+    {
+        p = &link->pending[i];
+        if (p->state != PENDING_WAIT || (int32_t)(now_ms - p->deadline_ms) < 0)
+            continue;
+        if (!pending_claim(p, PENDING_BUSY))
+            continue;
+
+        link->timeouts += 1;
+        if (p->future)
+            p->future->state = GCP_FUTURE_TIMEOUT;
+        if (p->callback)
+            p->callback(0, p->ctx);
+
+        __atomic_store_n(&p->state, PENDING_FREE, __ATOMIC_RELEASE);
+    }
+}
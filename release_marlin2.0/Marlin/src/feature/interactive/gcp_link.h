@@ -0,0 +1,101 @@
+#ifndef __GCP_LINK_H__
+#define __GCP_LINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gcp.h"
+
+/**
+ * GCP transport on top of gcp.c / gcp_parser.c
+ *
+ * TX: frames are built in place in a ring of fixed slots and sent from gcp_link_poll(),
+ *     so the caller never waits for the uart. Producers and gcp_link_poll() must run
+ *     in the same context (the main loop).
+ * Requests: a request remembers the cmd it waits for. The first reply from the same
+ *     module with that cmd completes it, there is no request ID on the wire so
+ *     requests for the same cmd complete in order. The result is handed to a
+ *     callback, a caller owned future, or both. Replies complete in the rx isr,
+ *     timeouts in gcp_link_poll().
+ */
+
+#define GCP_LINK_TX_SLOTS        8  // Power of 2
+#define GCP_LINK_TX_CONTENT_MAX 24  // Largest content of a queued frame
+#define GCP_LINK_PENDING_MAX     4  // Outstanding requests
+#define GCP_FUTURE_CONTENT_MAX  16  // Reply content kept in a future
+
+#define GCP_FUTURE_WAIT     0
+#define GCP_FUTURE_DONE     1
+#define GCP_FUTURE_TIMEOUT -1
+
+typedef struct
+{
+    uint16_t len;
+    uint8_t frame[GCP_HEAD_LEN + GCP_LINK_TX_CONTENT_MAX];
+} gcp_link_slot_t;
+
+typedef struct
+{
+    volatile int8_t state;  // GCP_FUTURE_WAIT until the reply or the timeout
+    uint8_t type;
+    uint16_t content_len;   // Full reply length, the copy is truncated to GCP_FUTURE_CONTENT_MAX
+    uint8_t content[GCP_FUTURE_CONTENT_MAX];
+} gcp_future_t;
+
+// msg is 0 on timeout
+typedef void (*gcp_link_reply_t)(gcp_msg_t *msg, void *ctx);
+
+typedef struct
+{
+    volatile uint8_t state;
+    uint8_t cmd;
+    uint8_t module;
+    uint16_t seq;
+    uint32_t deadline_ms;
+    gcp_link_reply_t callback;
+    void *ctx;
+    gcp_future_t *future;
+} gcp_link_pending_t;
+
+typedef struct
+{
+    gcp_link_slot_t tx[GCP_LINK_TX_SLOTS];
+    uint8_t tx_head;
+    uint8_t tx_tail;
+    uint32_t tx_dropped;
+
+    gcp_link_pending_t pending[GCP_LINK_PENDING_MAX];
+    uint16_t seq;
+    uint32_t timeouts;
+
+    uint8_t src_module;
+    void (*send)(uint8_t *buf, uint16_t len);
+    uint32_t (*get_time_ms)(void);
+} gcp_link_t;
+
+void gcp_link_init(gcp_link_t *link,
+                   uint8_t src_module,
+                   void (*send)(uint8_t *buf, uint16_t len),
+                   uint32_t (*get_time_ms)(void));
+
+uint8_t *gcp_link_tx_alloc(gcp_link_t *link, uint16_t content_len);
+
+void gcp_link_tx_commit(gcp_link_t *link, uint8_t type, uint8_t dst_module, uint8_t cmd);
+
+bool gcp_link_tx(gcp_link_t *link, uint8_t type, uint8_t dst_module, uint8_t cmd,
+                 const uint8_t *content, uint16_t content_len);
+
+int32_t gcp_link_request(gcp_link_t *link, uint8_t module, uint8_t cmd, uint32_t timeout_ms,
+                         gcp_link_reply_t callback, void *ctx, gcp_future_t *future);
+
+bool gcp_link_pending(gcp_link_t *link, int32_t id);
+
+void gcp_link_cancel(gcp_link_t *link, int32_t id);
+
+void gcp_link_rx_dispatch(gcp_link_t *link, gcp_msg_t *msg);
+
+void gcp_link_flush(gcp_link_t *link);
+
+void gcp_link_poll(gcp_link_t *link);
+
+#endif // __GCP_LINK_H__
@@ -29,24 +29,61 @@ void gcp_parser_disable(gcp_parser_t *gcp_parser)
     gcp_parser->parse_en = false;
 }
 
-void gcp_parser_fsm_process(gcp_parser_t *gcp_parser, uint8_t dat)
+/**
+ * @brief  Feed one received chunk to the parser
+ *         The clock is read once per chunk and content bytes are copied in bulk,
+ *         a frame split across chunks is resumed if the gap stays within max_interval_ms.
+ * @param  gcp_parser 解析器指针
+ * @param  buf 接收数据
+ * @param  len 接收长度
+ * @retval None
+ */
+void gcp_parser_process(gcp_parser_t *gcp_parser, const uint8_t *buf, uint16_t len)
 {
-    if (gcp_parser->parse_en == true)
+    uint16_t i = 0, n;
+    uint8_t dat;
+    gcp_msg_t *msg = gcp_parser->msg;
+    const uint32_t now_ms = gcp_parser->get_time_ms();
+
+    if (gcp_parser->parse_en != true)
+        return;
+
+    if (now_ms - gcp_parser->time_start_ms > gcp_parser->max_interval_ms)
     {
-        if (gcp_parser->get_time_ms() - gcp_parser->time_start_ms > gcp_parser->max_interval_ms)
+        gcp_parser->state = Parse_Magic0;
+    }
+    gcp_parser->time_start_ms = now_ms;
+
+    while (i < len)
+    {
+        if (gcp_parser->state == Parse_Content)
         {
-            gcp_parser->state = Parse_Magic0;
+            n = msg->content_len - gcp_parser->cnt;
+            if (n > len - i)
+                n = len - i;
+            while (n--)
+            {
+                dat = buf[i++];
+                msg->content[gcp_parser->cnt++] = dat;
+                gcp_parser->sum += dat;
+            }
+            if (gcp_parser->cnt == msg->content_len)
+            {
+                if (msg->check == gcp_parser->sum && gcp_parser->callback != 0)
+                    gcp_parser->callback(msg);
+                gcp_parser->state = Parse_Magic0;
+            }
+            continue;
         }
 
+        dat = buf[i++];
         switch (gcp_parser->state)
         {
         case Parse_Magic0:
             if (dat == GCP_MAGIC0)
             {
-                gcp_parser->msg->magic0 = dat;
-                gcp_parser->sum = 0;
-                gcp_parser->sum += dat;
-                gcp_parser->time_start_ms = gcp_parser->get_time_ms();
+                msg->magic0 = dat;
+                gcp_parser->sum = dat;
                 gcp_parser->state = Parse_Magic1;
             }
             break;
@@ -54,89 +91,72 @@ void gcp_parser_fsm_process(gcp_parser_t *gcp_parser, uint8_t dat)
         case Parse_Magic1:
             if (dat == GCP_MAGIC1)
             {
-                gcp_parser->msg->magic1 = dat;
+                msg->magic1 = dat;
                 gcp_parser->sum += dat;
-                gcp_parser->time_start_ms = gcp_parser->get_time_ms();
                 gcp_parser->state = Parse_Content_Len_L;
             }
             else
             {
-                gcp_parser->state = Parse_Magic0;
+                gcp_parser->state = (dat == GCP_MAGIC0) ? Parse_Magic1 : Parse_Magic0;
             }
             break;
 
         case Parse_Content_Len_L:
-            gcp_parser->msg->content_len = dat;
+            msg->content_len = dat;
             gcp_parser->sum += dat;
-            gcp_parser->time_start_ms = gcp_parser->get_time_ms();
             gcp_parser->state = Parse_Content_Len_H;
             break;
 
         case Parse_Content_Len_H:
-            gcp_parser->msg->content_len |= dat << 8;
+            msg->content_len |= dat << 8;
             gcp_parser->sum += dat;
-            gcp_parser->time_start_ms = gcp_parser->get_time_ms();
-            gcp_parser->state = Parse_Type_Version;
+            // A corrupted length would run past the receive buffer
+            gcp_parser->state = (msg->content_len > GCP_CONTENT_MAX_LEN) ? Parse_Magic0 : Parse_Type_Version;
             break;
 
         case Parse_Type_Version:
-            gcp_parser->msg->type = dat & 0x07;
-            gcp_parser->msg->version = (dat >> 3) & 0x1F;
+            msg->type = dat & 0x07;
+            msg->version = (dat >> 3) & 0x1F;
             gcp_parser->sum += dat;
-            gcp_parser->time_start_ms = gcp_parser->get_time_ms();
             gcp_parser->state = Parse_Check;
             break;
 
         case Parse_Check:
-            gcp_parser->msg->check = dat;
-            gcp_parser->time_start_ms = gcp_parser->get_time_ms();
+            msg->check = dat;
             gcp_parser->state = Parse_Src_Dst_Module;
             break;
 
         case Parse_Src_Dst_Module:
-            gcp_parser->msg->src_module = dat & 0x0F;
-            gcp_parser->msg->dst_module = (dat >> 4) & 0x0F;
+            msg->src_module = dat & 0x0F;
+            msg->dst_module = (dat >> 4) & 0x0F;
             gcp_parser->sum += dat;
-            gcp_parser->time_start_ms = gcp_parser->get_time_ms();
             gcp_parser->state = Parse_Cmd;
             break;
 
         case Parse_Cmd:
-            gcp_parser->msg->cmd = dat;
+            msg->cmd = dat;
             gcp_parser->sum += dat;
-            if (gcp_parser->msg->content_len == 0 && gcp_parser->msg->check == gcp_parser->sum)
+            if (msg->content_len == 0)
             {
-                if (gcp_parser->callback != 0)
-                    gcp_parser->callback(gcp_parser->msg);
-                gcp_parser->time_start_ms = gcp_parser->get_time_ms();
+                if (msg->check == gcp_parser->sum && gcp_parser->callback != 0)
+                    gcp_parser->callback(msg);
                 gcp_parser->state = Parse_Magic0;
             }
             else
             {
                 gcp_parser->cnt = 0;
-                gcp_parser->time_start_ms = gcp_parser->get_time_ms();
                 gcp_parser->state = Parse_Content;
             }
             break;
 
-        case Parse_Content:
-            gcp_parser->msg->content[gcp_parser->cnt++] = dat;
-            gcp_parser->sum += dat;
-            if (gcp_parser->cnt == gcp_parser->msg->content_len)
-            {
-                if (gcp_parser->msg->check == gcp_parser->sum)
-                {
-                    if (gcp_parser->callback != 0)
-                        gcp_parser->callback(gcp_parser->msg);
-                }
-                gcp_parser->time_start_ms = gcp_parser->get_time_ms();
-                gcp_parser->state = Parse_Magic0;
-            }
-            break;
-
         default:
             gcp_parser->state = Parse_Magic0;
             break;
         }
     }
 }
+
+void gcp_parser_fsm_process(gcp_parser_t *gcp_parser, uint8_t dat)
+{
+    gcp_parser_process(gcp_parser, &dat, 1);
+}
@@ -47,4 +47,6 @@ void gcp_parser_disable(gcp_parser_t *gcp_parser);
 
 void gcp_parser_fsm_process(gcp_parser_t *gcp_parser, uint8_t dat);
 
+void gcp_parser_process(gcp_parser_t *gcp_parser, const uint8_t *buf, uint16_t len);
+
 #endif // __GCP_PARSER_H__
@@ -43,4 +43,40 @@
 #define GCP_CMD_F3_LED_TEST               0xF3
 #define GCP_CMD_F4_HEATER_FAN_IO_CTRL     0xF4
 
+// Content layouts, little endian on both sides
+typedef struct __attribute__((packed))
+{
+    uint8_t on;
+    int16_t target;
+    uint16_t fan;
+} gcp_20_msg_get_ack_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t threshold;
+} gcp_21_probe_set_t;
+
+typedef struct __attribute__((packed))
+{
+    int16_t val;
+} gcp_33_leveling_val_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t temp;
+    uint16_t ncycles;
+} gcp_43_pid_autotune_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t point;
+    uint8_t type;
+} gcp_48_point_type_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t parm;
+    uint8_t mode;
+} gcp_49_production_mode_t;
+
 #endif /*__PROTOCOL_H__*/
@@ -1,88 +1,274 @@
 #include "soft_timer.h"
 
-static soft_timer_t *soft_timer_head = 0;
+#define WHEEL_MASK (SOFT_TIMER_WHEEL_SIZE - 1)
 
-int soft_timer_init(soft_timer_t *timer, uint32_t timeout_ms, uint32_t repeat, void (*callback)(void))
+#define STATE_IDLE    0
+#define STATE_ARMED   1 // In a wheel slot
+#define STATE_READY   2 // Expired, waiting in a ready list
+#define STATE_RUNNING 3
+
+static soft_timer_t *wheel[SOFT_TIMER_WHEEL_LEVELS][SOFT_TIMER_WHEEL_SIZE];
+static uint32_t wheel_ms;      // Next tick to process
+static uint8_t wheel_started;
+static uint16_t armed_cnt;
+
+static soft_timer_t *ready_head[SOFT_TIMER_PRIO_COUNT];
+static soft_timer_t **ready_tail[SOFT_TIMER_PRIO_COUNT];
+
+static soft_timer_t *soft_timer_all = 0;
+
+static void list_push(soft_timer_t **head, soft_timer_t *timer)
+{
+    timer->next = *head;
+    if (*head)
+        (*head)->pprev = &timer->next;
+    timer->pprev = head;
+    *head = timer;
+}
+
+static void timer_unlink(soft_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    else if (timer->state == STATE_READY)
+        ready_tail[timer->prio] = timer->pprev;
+
+    if (timer->state == STATE_ARMED)
+        armed_cnt -= 1;
+    timer->state = STATE_IDLE;
+}
+
+static void wheel_insert(soft_timer_t *timer)
+{
+    uint32_t delta = timer->expire_ms - wheel_ms;
+    soft_timer_t **slot;
+
+    if ((int32_t)delta < 0)
+    {
+        delta = 0;
+        timer->expire_ms = wheel_ms;
+    }
+    else if (delta > SOFT_TIMER_MAX_MS)
+    {
+        delta = SOFT_TIMER_MAX_MS;
+        timer->expire_ms = wheel_ms + SOFT_TIMER_MAX_MS;
+    }
+
+    if (delta < SOFT_TIMER_WHEEL_SIZE)
+        slot = &wheel[0][timer->expire_ms & WHEEL_MASK];
+    else if (delta < (1UL << (2 * SOFT_TIMER_WHEEL_BITS)))
+        slot = &wheel[1][(timer->expire_ms >> SOFT_TIMER_WHEEL_BITS) & WHEEL_MASK];
+    else
+        slot = &wheel[2][(timer->expire_ms >> (2 * SOFT_TIMER_WHEEL_BITS)) & WHEEL_MASK];
+
+    list_push(slot, timer);
+    timer->state = STATE_ARMED;
+    armed_cnt += 1;
+}
+
+static void ready_append(soft_timer_t *timer)
+{
+    const uint8_t prio = timer->prio;
+
+    timer->next = 0;
+    timer->pprev = ready_tail[prio];
+    *ready_tail[prio] = timer;
+    ready_tail[prio] = &timer->next;
+    timer->state = STATE_READY;
+}
+
+// Move every timer of a higher level slot down, each one lands in a lower level
+static void wheel_cascade(uint8_t level, uint8_t index)
+{
+    soft_timer_t *timer = wheel[level][index], *next;
+
+    wheel[level][index] = 0;
+    for (; timer; timer = next)
+    {
+        next = timer->next;
+        armed_cnt -= 1;
+        wheel_insert(timer);
+    }
+}
+
+static void wheel_tick(void)
 {
-    if (timer == 0 || timeout_ms == 0)
+    const uint32_t t = wheel_ms;
+    soft_timer_t *timer, *next;
+
+    if ((t & WHEEL_MASK) == 0)
+    {
+        if (((t >> SOFT_TIMER_WHEEL_BITS) & WHEEL_MASK) == 0)
+            wheel_cascade(2, (t >> (2 * SOFT_TIMER_WHEEL_BITS)) & WHEEL_MASK);
+        wheel_cascade(1, (t >> SOFT_TIMER_WHEEL_BITS) & WHEEL_MASK);
+    }
+
+    timer = wheel[0][t & WHEEL_MASK];
+    wheel[0][t & WHEEL_MASK] = 0;
+    for (; timer; timer = next)
+    {
+        next = timer->next;
+        armed_cnt -= 1;
+        ready_append(timer);
+    }
+
+    wheel_ms = t + 1;
+}
+
+static void timer_run(soft_timer_t *timer)
+{
+    uint32_t start_us, run_us;
+
+    timer_unlink(timer);
+    timer->state = STATE_RUNNING;
+
+    start_us = soft_timer_get_us();
+    timer->callback();
+    run_us = soft_timer_get_us() - start_us;
+
+    timer->runs += 1;
+    timer->run_us_sum += run_us;
+    if (run_us > timer->run_us_max)
+        timer->run_us_max = run_us;
+
+    // The callback may have stopped or restarted its own timer
+    if (timer->state != STATE_RUNNING)
+        return;
+
+    if (timer->repeat != 0 && ++timer->repeat_cnt >= timer->repeat)
+    {
+        timer->state = STATE_IDLE;
+        return;
+    }
+
+    // Keep the period, unless the loop fell behind by more than one period
+    timer->start_ms = soft_timer_get_ms();
+    timer->expire_ms += timer->timeout_ms;
+    if ((int32_t)(timer->expire_ms - timer->start_ms) < 0)
+        timer->expire_ms = timer->start_ms + timer->timeout_ms;
+    wheel_insert(timer);
+}
+
+int soft_timer_init_ex(soft_timer_t *timer, const char *name, soft_timer_prio_t prio,
+                       uint32_t timeout_ms, uint32_t repeat, void (*callback)(void))
+{
+    soft_timer_t *target;
+
+    if (timer == 0 || timeout_ms == 0 || callback == 0 || prio >= SOFT_TIMER_PRIO_COUNT)
     {
         return -1;
     }
 
+    if (timer->state != STATE_IDLE)
+        soft_timer_stop(timer);
+
     timer->timeout_ms = timeout_ms;
     timer->start_ms = 0;
     timer->repeat = repeat;
     timer->repeat_cnt = 0;
     timer->callback = callback;
+    timer->name = name;
+    timer->prio = prio;
+    timer->state = STATE_IDLE;
     timer->next = 0;
+    timer->pprev = 0;
+
+    for (target = soft_timer_all; target; target = target->all)
+    {
+        if (target == timer)
+            return 0;
+    }
+    timer->all = soft_timer_all;
+    soft_timer_all = timer;
 
     return 0;
 }
 
+int soft_timer_init(soft_timer_t *timer, uint32_t timeout_ms, uint32_t repeat, void (*callback)(void))
+{
+    return soft_timer_init_ex(timer, "timer", SOFT_TIMER_PRIO_NORMAL, timeout_ms, repeat, callback);
+}
+
 int soft_timer_start(soft_timer_t *timer)
 {
-    soft_timer_t *target;
+    uint8_t i;
 
-    for (target = soft_timer_head; target; target = target->next)
+    if (timer->state == STATE_ARMED || timer->state == STATE_READY)
     {
-        if (target == timer)
-        {
-            return -1;
-        }
+        return -1;
+    }
+
+    if (!wheel_started)
+    {
+        for (i = 0; i < SOFT_TIMER_PRIO_COUNT; i++)
+            ready_tail[i] = &ready_head[i];
+        wheel_ms = soft_timer_get_ms();
+        wheel_started = 1;
+    }
+    else if (armed_cnt == 0)
+    {
+        wheel_ms = soft_timer_get_ms(); // Nothing to catch up on
     }
 
     timer->repeat_cnt = 0;
     timer->start_ms = soft_timer_get_ms();
-
-    timer->next = soft_timer_head;
-    soft_timer_head = timer;
+    timer->expire_ms = timer->start_ms + timer->timeout_ms;
+    wheel_insert(timer);
 
     return 0;
 }
 
 int soft_timer_stop(soft_timer_t *timer)
 {
-    soft_timer_t **curr;
-
-    for (curr = &soft_timer_head; *curr; curr = &(*curr)->next)
+    if (timer->state == STATE_ARMED || timer->state == STATE_READY)
     {
-        if (*curr == timer)
-        {
-            *curr = timer->next;
-            return 0;
-        }
+        timer_unlink(timer);
+        return 0;
+    }
+    if (timer->state == STATE_RUNNING)
+    {
+        timer->state = STATE_IDLE;
+        return 0;
     }
     return -1;
 }
 
 void soft_timer_loop(void)
 {
-    soft_timer_t *target;
-    uint32_t timebase_ms;
+    const uint32_t now_ms = soft_timer_get_ms();
+    uint8_t prio;
+
+    if (!wheel_started)
+        return;
+
+    if (armed_cnt == 0)
+        wheel_ms = now_ms + 1;
+    else
+        while ((int32_t)(now_ms - wheel_ms) >= 0)
+            wheel_tick();
+
+    for (prio = SOFT_TIMER_PRIO_HIGH; prio < SOFT_TIMER_PRIO_LOW; prio++)
+        while (ready_head[prio])
+            timer_run(ready_head[prio]);
+
+    if (ready_head[SOFT_TIMER_PRIO_LOW])
+        timer_run(ready_head[SOFT_TIMER_PRIO_LOW]);
+}
+
+soft_timer_t *soft_timer_list(void)
+{
+    return soft_timer_all;
+}
+
+void soft_timer_stats_reset(void)
+{
+    soft_timer_t *timer;
 
-    for (target = soft_timer_head; target; target = target->next)
+    for (timer = soft_timer_all; timer; timer = timer->all)
     {
-        timebase_ms = soft_timer_get_ms();
-
-        if (timebase_ms - target->start_ms < target->timeout_ms)
-        {
-            continue;
-        }
-
-        target->callback();
-
-        if (target->repeat == 0)
-        {
-            target->start_ms = timebase_ms;
-            continue;
-        }
-
-        target->repeat_cnt += 1;
-        if (target->repeat_cnt < target->repeat)
-        {
-            target->start_ms = timebase_ms;
-            continue;
-        }
-        soft_timer_stop(target);
+        timer->runs = 0;
+        timer->run_us_max = 0;
+        timer->run_us_sum = 0;
     }
 }
@@ -5,25 +5,66 @@
 #include "clock.h"
 
 #define soft_timer_get_ms() getCurrentMillis()
+#define soft_timer_get_us() getCurrentMicros()
 
 #define SOFT_TIMER_REPEAT_FOREVER 0
 
+/**
+ * Hierarchical timer wheel, 1ms ticks
+ *   level 0: 64 slots x 1ms, level 1: 64 slots x 64ms, level 2: 64 slots x 4096ms
+ * Start, stop and expiry are O(1), soft_timer_loop() reads the clock once.
+ * Expired timers run by priority: every HIGH and NORMAL timer in the same loop,
+ * LOW timers one per loop so a burst of reporters can not stall the main loop.
+ */
+#define SOFT_TIMER_WHEEL_BITS   6
+#define SOFT_TIMER_WHEEL_SIZE   (1 << SOFT_TIMER_WHEEL_BITS)
+#define SOFT_TIMER_WHEEL_LEVELS 3
+#define SOFT_TIMER_MAX_MS       ((1UL << (SOFT_TIMER_WHEEL_BITS * SOFT_TIMER_WHEEL_LEVELS)) - 1)
+
+typedef enum
+{
+    SOFT_TIMER_PRIO_HIGH,
+    SOFT_TIMER_PRIO_NORMAL,
+    SOFT_TIMER_PRIO_LOW,
+    SOFT_TIMER_PRIO_COUNT
+} soft_timer_prio_t;
+
 typedef struct soft_timer
 {
     uint32_t timeout_ms;
     uint32_t start_ms;
+    uint32_t expire_ms;
     uint32_t repeat;
     uint32_t repeat_cnt;
     void (*callback)(void);
-    struct soft_timer *next;
+
+    const char *name;
+    uint8_t prio;
+    uint8_t state;
+
+    struct soft_timer *next;   // Wheel slot or ready list
+    struct soft_timer **pprev;
+    struct soft_timer *all;    // Every initialized timer, for the report
+
+    // Callback run time
+    uint32_t runs;
+    uint32_t run_us_max;
+    uint64_t run_us_sum;
 } soft_timer_t;
 
 int soft_timer_init(soft_timer_t *timer, uint32_t timeout_ms, uint32_t repeat, void (*callback)(void));
 
+int soft_timer_init_ex(soft_timer_t *timer, const char *name, soft_timer_prio_t prio,
+                       uint32_t timeout_ms, uint32_t repeat, void (*callback)(void));
+
 int soft_timer_start(soft_timer_t *timer);
 
 int soft_timer_stop(soft_timer_t *timer);
 
 void soft_timer_loop(void);
 
+soft_timer_t *soft_timer_list(void);
+
+void soft_timer_stats_reset(void);
+
 #endif
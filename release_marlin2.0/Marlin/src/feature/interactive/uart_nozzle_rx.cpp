@@ -57,8 +57,7 @@ extern "C"
     {
         soft_timer_t soft_timer;
         gcp_parser_t parser;
-        uint8_t uart_buffer[1056];
-        uint8_t rx_buffer[1056];
+        uint8_t rx_buffer[GCP_HEAD_LEN + GCP_CONTENT_MAX_LEN];
 
         uint32_t tx_cnt;
         uint32_t rx_cnt;
@@ -70,31 +69,52 @@ extern "C"
     } uart_nozzle_rx_t;
 
     static uart_nozzle_rx_t uart_nozzle_rx;
+    static soft_timer_t uart_nozzle_poll_timer;
 
     nozzle_t nozzle;
+    probe_ack_t probe_ack;
     static uint8_t nozzle_rst_cnt;
 
+    // Reply of one arm. A late ACK of an earlier arm completes the earlier request, still pending
+    // in the link, and is dropped here by its seq: only the ACK of the latest arm sets acked.
+    static void uart_nozzle_probe_ack(gcp_msg_t *msg, void *ctx)
+    {
+        if (msg == 0 || msg->type != GCP_TYPE_ACK || (uint16_t)(uintptr_t)ctx != probe_ack.seq)
+            return;
+        // ACK: content[0..1] applied threshold, content[2..3] baseline settle time (optional)
+        if (msg->content_len < 2 || PACK_LE_16(&msg->content[0]) != probe_ack.threshold)
+            return;
+        probe_ack.settle_ms = msg->content_len >= 4 ? PACK_LE_16(&msg->content[2]) : 0;
+        probe_ack.acked = 1;
+    }
+
+    /**
+     * @brief  Send a probe threshold and wait for its ACK in probe_ack
+     * @param  val : probe threshold
+     * @param  timeout_ms : how long the request stays matched to this arm, at least the caller's wait
+     * @retval None
+     */
+    void uart_nozzle_probe_arm(uint16_t val, uint32_t timeout_ms)
+    {
+        probe_ack.acked = 0;
+        probe_ack.threshold = val;
+        const uint16_t seq = ++probe_ack.seq;
+        // No free request slot: the ACK is not matched and the caller times out as with an old nozzle firmware
+        gcp_link_request(&uart_nozzle_link, GCP_MODULE_02_NOZZLE, GCP_CMD_21_PROBE_SET, timeout_ms,
+                         uart_nozzle_probe_ack, (void *)(uintptr_t)seq, 0);
+        uart_nozzle_tx_probe_val(val);
+    }
+
     static void uart_nozzle_tx_temperature_polling_callback(void)
     {
-        uint8_t content[8];
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        content[0] = 1;
-        content[1] = thermalManager.degTargetHotend(0) & 0xFF;
-        content[2] = thermalManager.degTargetHotend(0) >> 8;
-        content[3] = thermalManager.fan_speed[0] & 0xFF;
-        content[4] = thermalManager.fan_speed[0] >> 8;
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_ACK,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_20_MSG_GET,
-                           content,
-                           5);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        gcp_20_msg_get_ack_t *content = (gcp_20_msg_get_ack_t *)gcp_link_tx_alloc(&uart_nozzle_link, sizeof(gcp_20_msg_get_ack_t));
+
+        if (content == 0)
+            return;
+        content->on = 1;
+        content->target = thermalManager.degTargetHotend(0);
+        content->fan = thermalManager.fan_speed[0];
+        gcp_link_tx_commit(&uart_nozzle_link, GCP_TYPE_ACK, GCP_MODULE_02_NOZZLE, GCP_CMD_20_MSG_GET);
 
         uart_nozzle_rx.tx_cnt += 1;
     }
@@ -211,6 +231,7 @@ extern "C"
 
         nozzle_rst_cnt = 0;
         uart_nozzle_rx.start_ms = getCurrentMillis();
+        gcp_link_rx_dispatch(&uart_nozzle_link, gcp_msg);
         memset(data, 0, sizeof(data));
         switch (gcp_msg->cmd)
         {
@@ -222,6 +243,10 @@ extern "C"
             uart_nozzle_rx.rx_cnt += 1;
             break;
 
+          case GCP_CMD_21_PROBE_SET:
+            // The ACK completes the request of its arm in gcp_link_rx_dispatch(), see uart_nozzle_probe_arm()
+            break;
+
           case GCP_CMD_22_LOG_UPLOAD:
             uart_nozzle_info.sys_err = PACK_LE_32(&gcp_msg->content[0]);
             uart_nozzle_info.rst_flg = PACK_LE_16(&gcp_msg->content[4]);
@@ -386,12 +411,7 @@ extern "C"
 
     static void uart_nozzle_packet_parse_isr(uint8_t *buf, uint16_t len)
     {
-        uint16_t index;
-
-        for (index = 0; index < len; index++)
-        {
-            gcp_parser_fsm_process(&uart_nozzle_rx.parser, buf[index]);
-        }
+        gcp_parser_process(&uart_nozzle_rx.parser, buf, len);
     }
 
     void latch_clear(void)
@@ -401,21 +421,40 @@ extern "C"
         OUT_WRITE(PD10, HIGH);
     }
 
+    static void uart_nozzle_send(uint8_t *buf, uint16_t len)
+    {
+        MYSERIAL3.send(buf, len);
+    }
+
     void uart_nozzle_init(void)
     {
+        gcp_link_init(&uart_nozzle_link, GCP_MODULE_01_MARLIN, uart_nozzle_send, getCurrentMillis);
+
         gcp_parser_init(&uart_nozzle_rx.parser,
                         uart_nozzle_rx.rx_buffer,
                         10,
                         getCurrentMillis,
                         uart_nozzle_rx_callback);
 
-        soft_timer_init(&uart_nozzle_rx.soft_timer,
-                        100,
-                        SOFT_TIMER_REPEAT_FOREVER,
-                        uart_nozzle_tx_temperature_polling_callback);
+        soft_timer_init_ex(&uart_nozzle_rx.soft_timer,
+                           "nozzle_temp",
+                           SOFT_TIMER_PRIO_NORMAL,
+                           100,
+                           SOFT_TIMER_REPEAT_FOREVER,
+                           uart_nozzle_tx_temperature_polling_callback);
 
         soft_timer_start(&uart_nozzle_rx.soft_timer);
 
+        // Sends the queued frames, so it runs on every tick
+        soft_timer_init_ex(&uart_nozzle_poll_timer,
+                           "nozzle_link",
+                           SOFT_TIMER_PRIO_HIGH,
+                           1,
+                           SOFT_TIMER_REPEAT_FOREVER,
+                           uart_nozzle_polling);
+
+        soft_timer_start(&uart_nozzle_poll_timer);
+
         uart_rx_isr_callback[5] = uart_nozzle_packet_parse_isr;
 
         uart_nozzle_rx.start_ms = getCurrentMillis();
@@ -438,7 +477,8 @@ extern "C"
                     last_temp_now = uart_nozzle_info.temp_now;
                 MYSERIAL2.printLine("sys_err = 0x%x, rst_flg = 0x%x, adc_raw = %d, adc_ave = %d, ", uart_nozzle_info.sys_err, uart_nozzle_info.rst_flg, uart_nozzle_info.adc_raw, uart_nozzle_info.adc_ave);
                 MYSERIAL2.printLine("temp_now = %d, temp_tg = %d, pidout = %d, probe_thres = %d, ", uart_nozzle_info.temp_now, uart_nozzle_info.temp_tg, uart_nozzle_info.pidout, uart_nozzle_info.probe_thres);
-                MYSERIAL2.printLine("tx_cnt = %d, rx_cnt = %d, oci ttl cnt = %d M:%d\n", uart_nozzle_rx.tx_cnt, uart_nozzle_rx.rx_cnt, uart_nozzle_info.oci_ttl_cnt, Stepper_enio_state());
+                MYSERIAL2.printLine("tx_cnt = %d, rx_cnt = %d, oci ttl cnt = %d M:%d ", uart_nozzle_rx.tx_cnt, uart_nozzle_rx.rx_cnt, uart_nozzle_info.oci_ttl_cnt, Stepper_enio_state());
+                MYSERIAL2.printLine("tx_drop = %d, req_timeout = %d\n", uart_nozzle_link.tx_dropped, uart_nozzle_link.timeouts);
             }
 
             sys_err_parse(uart_nozzle_info.sys_err);
@@ -459,7 +499,7 @@ extern "C"
 
     void uart_nozzle_polling(void)
     {
-        soft_timer_loop();
+        gcp_link_poll(&uart_nozzle_link);
 
         uart_nozzle_rx_disconnect_check();
 
@@ -19,6 +19,17 @@ extern "C"
 
     extern nozzle_t nozzle;
 
+    // Probe set handshake of the latest uart_nozzle_probe_arm(), the ACK is written in the uart isr
+    typedef struct
+    {
+        volatile uint8_t acked;      // Threshold applied and adc baseline settled
+        volatile uint16_t seq;       // Arm the ACK must answer, bumped by every arm
+        volatile uint16_t threshold; // Threshold of that arm, an ACK with another one is rejected
+        volatile uint16_t settle_ms; // Nozzle side settle time, 0 if not reported
+    } probe_ack_t;
+
+    extern probe_ack_t probe_ack;
+
     void latch_clear(void);
 
     void uart_nozzle_init(void);
@@ -26,6 +37,8 @@ extern "C"
     void uart_nozzle_polling(void);
 
     void uart_nozzle_tx_probe_val(uint16_t val);
+
+    void uart_nozzle_probe_arm(uint16_t val, uint32_t timeout_ms);
 }
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "../../inc/MarlinConfig.h"
 #include "../../module/temperature.h"
+#include "../../MarlinCore.h"
 #include "clock.h"
 
 
@@ -29,227 +30,133 @@ extern "C"
 #include "protocol.h"
 #include "soft_timer.h"
 
-    void uart_nozzle_tx_probe_val(uint16_t val)
-    {
-        uint8_t content[8];
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
+    gcp_link_t uart_nozzle_link;
 
-        content[0] = val & 0xFF;
-        content[1] = val >> 8;
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_21_PROBE_SET,
-                           content,
-                           2);
+    static void uart_nozzle_tx_empty(uint8_t type, uint8_t cmd)
+    {
+        gcp_link_tx(&uart_nozzle_link, type, GCP_MODULE_02_NOZZLE, cmd, 0, 0);
+    }
 
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+    // Register the reply first, then queue the frame
+    static int32_t uart_nozzle_tx_request(uint8_t type, uint8_t cmd, gcp_future_t *future)
+    {
+        const int32_t id = gcp_link_request(&uart_nozzle_link, GCP_MODULE_02_NOZZLE, cmd, UART_NOZZLE_REPLY_MS, 0, 0, future);
+
+        if (id >= 0 && !gcp_link_tx(&uart_nozzle_link, type, GCP_MODULE_02_NOZZLE, cmd, 0, 0))
+        {
+            gcp_link_cancel(&uart_nozzle_link, id);
+            return -1;
+        }
+        return id;
     }
 
-    void uart_nozzle_tx_hwsw_ver_get(void)
+    void uart_nozzle_tx_probe_val(uint16_t val)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
+        gcp_21_probe_set_t *content = (gcp_21_probe_set_t *)gcp_link_tx_alloc(&uart_nozzle_link, sizeof(gcp_21_probe_set_t));
 
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_CMD,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_24_HWSW_VER,
-                           0,
-                           0);
+        if (content == 0)
+            return;
+        content->threshold = val;
+        gcp_link_tx_commit(&uart_nozzle_link, GCP_TYPE_SET, GCP_MODULE_02_NOZZLE, GCP_CMD_21_PROBE_SET);
+    }
 
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+    void uart_nozzle_tx_hwsw_ver_get(void)
+    {
+        uart_nozzle_tx_empty(GCP_TYPE_CMD, GCP_CMD_24_HWSW_VER);
     }
 
     void uart_nozzle_tx_single_data(uint8_t cmd, uint8_t dat)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-        uint8_t context = dat;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_CMD,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           cmd,
-                           &context,
-                           1);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        gcp_link_tx(&uart_nozzle_link, GCP_TYPE_CMD, GCP_MODULE_02_NOZZLE, cmd, &dat, 1);
     }
 
     void uart_nozzle_tx_multi_data(uint8_t cmd, uint8_t *buf, uint16_t size)
     {
-        uint8_t pbuf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&pbuf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_CMD,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           cmd,
-                           buf,
-                           size);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        gcp_link_tx(&uart_nozzle_link, GCP_TYPE_CMD, GCP_MODULE_02_NOZZLE, cmd, buf, size);
     }
 
     void uart_nozzle_tx_show_adc_value_on()
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_41_SHOW_ADC_VALUE_ON,
-                           0,
-                           0);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        uart_nozzle_tx_empty(GCP_TYPE_SET, GCP_CMD_41_SHOW_ADC_VALUE_ON);
     }
 
     void uart_nozzle_tx_show_adc_value_off()
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_42_SHOW_ADC_VALUE_OFF,
-                           0,
-                           0);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        uart_nozzle_tx_empty(GCP_TYPE_SET, GCP_CMD_42_SHOW_ADC_VALUE_OFF);
     }
 
     void uart_nozzle_tx_pid_autotune(uint16_t temp, uint16_t ncycles)
     {
-        uint8_t content[8];
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        content[0] = temp & 0xFF;
-        content[1] = temp >> 8;
-        content[2] = ncycles & 0xFF;
-        content[3] = ncycles >> 8;
+        gcp_43_pid_autotune_t *content = (gcp_43_pid_autotune_t *)gcp_link_tx_alloc(&uart_nozzle_link, sizeof(gcp_43_pid_autotune_t));
 
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_43_PID_AUTO_TURN,
-                           content,
-                           4);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        if (content == 0)
+            return;
+        content->temp = temp;
+        content->ncycles = ncycles;
+        gcp_link_tx_commit(&uart_nozzle_link, GCP_TYPE_SET, GCP_MODULE_02_NOZZLE, GCP_CMD_43_PID_AUTO_TURN);
     }
 
     // Get strain gauge readings
-    void uart_nozzle_tx_probe_val_get()
+    int32_t uart_nozzle_tx_probe_val_get(gcp_future_t *future)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_40_GET_PROBE_VALUE,
-                           0,
-                           0);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        return uart_nozzle_tx_request(GCP_TYPE_SET, GCP_CMD_40_GET_PROBE_VALUE, future);
     }
 
     // set probe leveling value
     void uart_nozzle_tx_probe_leveling_val_set(int16_t val)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_33_LEVELING_VAL_WRITE,
-                           (uint8_t *)&val,
-                           2);
+        gcp_33_leveling_val_t *content = (gcp_33_leveling_val_t *)gcp_link_tx_alloc(&uart_nozzle_link, sizeof(gcp_33_leveling_val_t));
 
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        if (content == 0)
+            return;
+        content->val = val;
+        gcp_link_tx_commit(&uart_nozzle_link, GCP_TYPE_SET, GCP_MODULE_02_NOZZLE, GCP_CMD_33_LEVELING_VAL_WRITE);
     }
 
     // get probe leveling value
-    void uart_nozzle_tx_probe_leveling_val_get(void)
+    int32_t uart_nozzle_tx_probe_leveling_val_get(gcp_future_t *future)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_SET,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_34_LEVELING_VAL_READ,
-                           0,
-                           0);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        return uart_nozzle_tx_request(GCP_TYPE_SET, GCP_CMD_34_LEVELING_VAL_READ, future);
     }
 
     void uart_nozzle_tx_auto_offset_start(void)
     {
-        uint8_t buf[64];
-        gcp_msg_t *gcp_msg = (gcp_msg_t *)&buf[0];
-        uint16_t len;
-
-        len = gcp_msg_pack(gcp_msg,
-                           GCP_TYPE_CMD,
-                           GCP_MODULE_01_MARLIN,
-                           GCP_MODULE_02_NOZZLE,
-                           GCP_CMD_43_AUTO_OFFSET_START,
-                           0,
-                           0);
-
-        MYSERIAL3.send((uint8_t *)gcp_msg, len);
+        uart_nozzle_tx_empty(GCP_TYPE_CMD, GCP_CMD_43_AUTO_OFFSET_START);
     }
 
     void uart_nozzle_tx_notify_error(void)
     {
         uart_nozzle_tx_single_data(GCP_CMD_35_LOGO_LED_ERR, 2);
+        gcp_link_flush(&uart_nozzle_link);
         _delay_ms(10);
     }
 
     void uart_nozzle_tx_point_type(uint8_t type, uint8_t point) // Notify the nozzle board of the position under different commands.
     { // type = G28/G36/G29, point= position or count in different modes
-        uint8_t buff[2] = {0, 0}; // (type, point)
-        production_mode.type = buff[1] = type;
-        production_mode.point = buff[0] = point;
-        uart_nozzle_tx_multi_data(GCP_CMD_48_POINT_TYPE, buff, 2);
+        const gcp_48_point_type_t content = { point, type };
+        production_mode.type = type;
+        production_mode.point = point;
+        uart_nozzle_tx_multi_data(GCP_CMD_48_POINT_TYPE, (uint8_t *)&content, sizeof(content));
     }
 
     void uart_nozzle_tx_production_mode(const uint8_t mode, const uint8_t parm) // Switch between production test mode and normal mode.
     {   // mode = PRODUCTION_NORMAL_MODE/PRODUCTION_TEST_MODE; parm = STA_00_OFF/STA_01_ON/STA_02_ON
-        uint8_t buff[2] = {0, 0}; // (type, point)
-        production_mode.mode = buff[1] = mode;
-        production_mode.parm = buff[0] = parm;
-        uart_nozzle_tx_multi_data(GCP_CMD_49_PRODUCTION_MODE, buff, 2);
+        const gcp_49_production_mode_t content = { parm, mode };
+        production_mode.mode = mode;
+        production_mode.parm = parm;
+        uart_nozzle_tx_multi_data(GCP_CMD_49_PRODUCTION_MODE, (uint8_t *)&content, sizeof(content));
     }
 }
 
+/**
+ * @brief  Wait in idle() for a reply requested with a future
+ * @param  future : passed to one of the requesting uart_nozzle_tx_* functions
+ * @retval true if the reply arrived, false on timeout or if the request could not be queued
+ */
+bool uart_nozzle_wait_reply(gcp_future_t *future)
+{
+    while (future->state == GCP_FUTURE_WAIT) idle();
+    return future->state == GCP_FUTURE_DONE;
+}
+
 #endif
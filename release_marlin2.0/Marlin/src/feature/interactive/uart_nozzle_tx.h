@@ -48,9 +48,14 @@ enum anker_overpressure_trigger_type
 };
 
 
+#define UART_NOZZLE_REPLY_MS 500 // Timeout of requests that wait for the nozzle board reply
+
 extern "C"
 {
 #include <stdint.h>
+#include "gcp_link.h"
+
+    extern gcp_link_t uart_nozzle_link;
 
     typedef struct _production_mode_t
     {
@@ -68,19 +73,21 @@ extern "C"
     void uart_nozzle_tx_show_adc_value_on();
     void uart_nozzle_tx_show_adc_value_off();
     void uart_nozzle_tx_pid_autotune(uint16_t temp, uint16_t ncycles);
-    void uart_nozzle_tx_probe_val_get();
+    int32_t uart_nozzle_tx_probe_val_get(gcp_future_t *future = 0);
     void uart_nozzle_tx_multi_data(uint8_t cmd, uint8_t *buf, uint16_t size);
     void uart_nozzle_tx_auto_offset_start(void);
     void uart_nozzle_tx_m3001_deal(void);
     void uart_nozzle_tx_m3002_deal(void);
     void uart_nozzle_tx_notify_error(void);
     void uart_nozzle_tx_probe_leveling_val_set(int16_t val);
-    void uart_nozzle_tx_probe_leveling_val_get(void);
+    int32_t uart_nozzle_tx_probe_leveling_val_get(gcp_future_t *future = 0);
     void uart_nozzle_tx_point_type(uint8_t type, uint8_t point);
     void uart_nozzle_tx_production_mode(const uint8_t mode, const uint8_t parm);
 
 }
 
+bool uart_nozzle_wait_reply(gcp_future_t *future);
+
 extern production_mode_t production_mode;
 #define POINT_TYPE_STRING   (production_mode.type == POINT_G28 ? "G28": (production_mode.type == POINT_G29 ? "G29" : (production_mode.type == POINT_G36 ? "G36" : "unknow")))
 #define POINT_TYPE_POSITION (production_mode.point)
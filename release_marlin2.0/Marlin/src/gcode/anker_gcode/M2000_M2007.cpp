@@ -4,6 +4,8 @@
 #include "../../module/planner.h"
 #include "../../feature/anker/anker_homing.h"
 #include "../../feature/anker/anker_z_sensorless.h"
+#include "../../feature/anker/anker_tmc_poll.h"
+#include "../../feature/anker/anker_z_stall.h"
 #include "../../feature/anker/board_configure.h"
 #include "../../module/motion.h"
 #include "../../module/stepper.h"
@@ -104,6 +106,18 @@ void GcodeSuite::M2000() {
            use_z_sensorless.set_z2_value(value);
          #endif
       }
+      #if ENABLED(ANKER_TMC_POLL)
+      if (parser.seen('P'))
+      {
+          anker_tmc_poll.enable = parser.value_bool();
+      }
+      #endif
+      #if ENABLED(ANKER_Z_STALL_LEARN)
+      if (parser.seen('L'))
+      {
+          anker_z_stall.enable = parser.value_bool();
+      }
+      #endif
       #if ENABLED(ANKER_TMC_SET)
       if (parser.seen('T'))
       {
@@ -115,6 +129,11 @@ void GcodeSuite::M2000() {
 
         use_z_sensorless.report();
         TERN_(ANKER_TMC_SET, anker_tmc_set.report_tmc_tcoolthrs());
+        TERN_(ANKER_TMC_POLL, anker_tmc_poll.report());
+        #if ENABLED(ANKER_Z_STALL_LEARN)
+          SERIAL_ECHOLNPAIR("echo:z stall learn:", anker_z_stall.enable);
+          anker_z_stall.report();
+        #endif
    }
 #endif
 
@@ -17,6 +17,7 @@
 #include "../../feature/anker/anker_homing.h"
 #include "../../feature/bedlevel/bedlevel.h"
 #include "../../module/settings.h"
+#include "../../feature/anker/anker_mesh_filter.h"
 
 void GcodeSuite::M3030()
 {// M3030 [C<log_type>] [T<point_type>] [P<point_number>]
@@ -131,101 +132,42 @@ void GcodeSuite::M3033()
 }
 
 #if ENABLED(ANKER_FILTER_LEVEL_GRID)
-  
-  #define BOUNDARIES_NOISE_POINT 0.35f // Noise Point Judgment
-  #define NOISE_POINT 0.3f // Noise Point Judgment
 
-  static float boundarie_noise_point = BOUNDARIES_NOISE_POINT;
-  static float noise_point = NOISE_POINT;
-  
-  void filter_leveling_grid(bed_mesh_t &din, const uint8_t outter_size, const uint8_t inner_size, bool debug_flag)
+void GcodeSuite::M3034()
+{// M3034 [S<save>] [F<smooth passes>] [R] [B<boundary noise>] [P<noise>] [K<mad factor>]
+
+  if (parser.seenval('B'))
   {
+    float value = parser.value_float();
+    if(value > 0.02f) anker_mesh_filter.edge_noise = value;
+  }
 
-      uint8_t i, j, m, n, k;
-      float dout[outter_size][inner_size];
-
-
-      if(outter_size <= 0 || inner_size <= 0) return;
-
-      if(debug_flag) SERIAL_ECHOLNPGM("filter leveling grid:");
-      
-      for(i = 0; i < outter_size; i++) // Row
-      {
-          for(j = 0; j < inner_size; j++) // Column
-          {
-              short A[4]; // Four boundaries of the data point
-              k = 0;
-              dout[i][j] = 0; // Initialize the output to 0
-              A[0] = i-1;
-              if (A[0] < 0){ A[0] = 0; } // Set to 0 if it exceeds the boundary
-              A[1] = i+1;
-              if (A[1] > outter_size-1){ A[1] = outter_size-1; } // Set to maximum if it exceeds the boundary
-              A[2] = j-1;
-              if (A[2] < 0){ A[2] = 0; } // Set to 0 if it exceeds the boundary
-              A[3] = j+1;
-              if (A[3] > inner_size-1){ A[3] = inner_size-1; } // Set to maximum if it exceeds the boundary
-
-              for(m = A[0]; m <= A[1]; m++){ // Retrieve within the row range
-                  for(n = A[2]; n <= A[3]; n++){ // Retrieve within the column range
-                      k++;
-                      dout[i][j] += din[m][n]; // Sum of all points within the specified boundary
-                  }
-              }
-
-              if(k > 1){
-                dout[i][j] -= din[i][j];
-                dout[i][j] /= (k-1); // In calculating the average, the weight of all points is the same
-              }
-
-              if(debug_flag) { SERIAL_ECHO_F(dout[i][j], int(3)); SERIAL_ECHO(" ,"); _delay_ms(5);}
-          }
-
-          if(debug_flag) { SERIAL_EOL();}
-      }
-
-      // Compare using dout and dint, smooth out the ones with large differences
-      if(debug_flag) SERIAL_ECHOLNPGM("nosie point grid:");
-      for(i = 0; i < outter_size; i++) // Row
-      {
-          for(j = 0; j < inner_size; j++) // Column
-          {
-              if((i== 0 || j == 0 || i== outter_size-1 || j == inner_size-1))
-              {   
-                if(ABS(dout[i][j] - din[i][j]) > boundarie_noise_point)
-                  din[i][j] = dout[i][j];
-              }else if(ABS(dout[i][j] - din[i][j]) > noise_point)
-              {
-                  din[i][j] = dout[i][j];
-              }
-          }
-      }
-      _delay_ms(20);
+  if (parser.seenval('P'))
+  {
+    float value = parser.value_float();
+    if(value > 0.02f) anker_mesh_filter.noise = value;
+  }
+
+  if (parser.seenval('K'))
+  {
+    float value = parser.value_float();
+    if(value >= 1.0f) anker_mesh_filter.mad_k = value;
   }
 
-void GcodeSuite::M3034()
-{// M3034 [S<filter_leveling_grid >]
-  
   if (parser.seenval('S'))
   {
     const uint8_t save = parser.value_int();
     print_bilinear_leveling_grid();
-    TERN_(ANKER_FILTER_LEVEL_GRID, filter_leveling_grid(z_values, GRID_MAX_POINTS_X, GRID_MAX_POINTS_Y, ENABLE));
+    anker_mesh_filter.process(z_values);
+    if (parser.seenval('F'))
+      LOOP_L_N(i, _MIN(parser.value_byte(), 4)) anker_mesh_filter.smooth(z_values);
+    refresh_bed_level();
     SERIAL_ECHOLNPGM(">>>>>>>>>>>>>>> after filter level:");
     print_bilinear_leveling_grid();
     if(save) settings.save();
   }
 
-  if (parser.seenval('B'))
-  {
-    float value = parser.value_float();
-    if(value > 0.02f) boundarie_noise_point = value;
-  }
-
-  if (parser.seenval('P'))
-  {
-    float value = parser.value_float();
-    if(value > 0.02f) noise_point = value;
-  }
+  if (parser.seen('R')) anker_mesh_filter.report(z_values);
 }
 
 #endif
@@ -1,7 +1,16 @@
 #include "../gcode.h"
 #include "../../MarlinCore.h"
 #include "../../module/planner.h"
+#include "../../module/stepper.h"
 #include "../../module/settings.h"
+#include "../../feature/anker/anker_isr_profile.h"
+#include "../../feature/anker/anker_shaping_cal.h"
+#include "../../feature/anker/anker_sched.h"
+#include "../../feature/anker/anker_probe_capture.h"
+#include "../../feature/anker/anker_endstop_debounce.h"
+#include "../../feature/anker/anker_move_stream.h"
+#include "../../feature/anker/anker_step_sched.h"
+#include "../../feature/anker/anker_flow_ctrl.h"
 
 #if ENABLED(ANKER_MAKE_API)
 
@@ -143,16 +152,115 @@ void GcodeSuite::M4205() {
 }
 
 
-#if ENABLED(ANKER_VIBRATION_CONTROL)
 /**
- * M4897: T/S curve switching and Zero configuration(Zeroconf)
+ * M4894: Periodic task report
+ *
+ * With no parameters, print period, priority, runs and run time of every task
+ * R: Reset the run time statistics
+ */
+void GcodeSuite::M4894(){
+  if (parser.seen('R')) {
+    anker_sched.reset();
+    MYSERIAL2.printLine("echo:sched stats reset\n");
+    return;
+  }
+  anker_sched.report();
+}
+
+#if ENABLED(ANKER_ISR_PROFILE)
+/**
+ * M4896: ISR execution time statistics
+ *
+ * With no parameters, print min/mean/max and histogram per probe
+ * R: Reset the statistics
+ */
+void GcodeSuite::M4896(){
+  if (parser.seen('R')) {
+    isr_profile.reset();
+    MYSERIAL2.printLine("echo:isr profile reset\n");
+    return;
+  }
+  isr_profile.report();
+}
+#endif
+
+#if ENABLED(ANKER_SHAPING_CAL) && ENABLED(INPUT_SHAPING)
+/**
+ * M4895: Input shaping resonance sweep
+ *
+ * X/Y: Axis to sweep (one of them)
+ * B: Start frequency (Hz), default SHAPING_CAL_FREQ_START
+ * E: End frequency (Hz), default SHAPING_CAL_FREQ_END
+ * S: Frequency step (Hz), default SHAPING_CAL_FREQ_STEP
+ * A: Excitation acceleration (mm/s^2), default the axis max acceleration
+ * C: Back and forth moves per frequency, default SHAPING_CAL_CYCLES
+ * P: 1=Apply the found frequency to the axis shaper, if no frequency of the sweep was skipped
+ */
+void GcodeSuite::M4895(){
+  const bool seen_x = parser.seen_test('X'), seen_y = parser.seen_test('Y');
+  if (seen_x == seen_y) {
+    SERIAL_ECHOLNPGM("echo:M4895 needs X or Y");
+    return;
+  }
+  const AxisEnum axis = seen_x ? X_AXIS : Y_AXIS;
+
+  const float f_start = parser.floatval('B', SHAPING_CAL_FREQ_START),
+              f_end   = parser.floatval('E', SHAPING_CAL_FREQ_END),
+              f_step  = parser.floatval('S', SHAPING_CAL_FREQ_STEP),
+              accel   = _MIN(parser.floatval('A', planner.settings.max_acceleration_mm_per_s2[axis]),
+                             float(planner.settings.max_acceleration_mm_per_s2[axis]));
+  const uint8_t cycles = constrain(parser.byteval('C', SHAPING_CAL_CYCLES), 1, SHAPING_CAL_MAX_CYCLES);
+
+  const float freq = anker_shaping_cal.sweep(axis, f_start, f_end, f_step, accel, cycles);
+
+  if (freq && parser.boolval('P')) {
+    const shaping_params_t * const sp = stepper.get_shaping(axis);
+    if (stepper.set_shaping(axis, sp->type, _MAX(freq, float(SHAPING_MIN_FREQ)), sp->zeta))
+      stepper.shaping_report();
+  }
+}
+#endif
+
+#if EITHER(ANKER_VIBRATION_CONTROL, INPUT_SHAPING)
+/**
+ * M4897: T/S curve switching and Zero configuration(Zeroconf), input shaper selection
  *
  * S: 0=CLOSED 1=T/S CURE 2= Zeroconf
  * T: planner.VC.N
  * O: planner.VC.omiga
+ *
+ * X/Y: Shaper axis, both if neither is given
+ * I: Shaper type 0=NONE 1=ZV 2=ZVD 3=MZV 4=EI
+ * F: Shaper frequency (Hz)
+ * D: Shaper damping ratio
+ *
+ * With no parameters, report the shapers
  */
 void GcodeSuite::M4897(){
 
+  #if ENABLED(INPUT_SHAPING)
+  if (parser.seen("IFD")) {
+    const bool seen_x = parser.seen_test('X'), seen_y = parser.seen_test('Y');
+    LOOP_L_N(i, XY) {
+      const AxisEnum axis = AxisEnum(i);
+      if ((seen_x || seen_y) && !(axis == X_AXIS ? seen_x : seen_y)) continue;
+      const shaping_params_t * const sp = stepper.get_shaping(axis);
+      if (!sp) continue;
+      const uint8_t type = parser.byteval('I', sp->type);
+      const float freq = parser.floatval('F', sp->frequency),
+                  zeta = parser.floatval('D', sp->zeta);
+      if (!stepper.set_shaping(axis, ShapingType(type), freq, zeta))
+        SERIAL_ECHOLNPAIR("echo:shaping ", AS_CHAR(axis_codes[axis]), " rejected, F", SHAPING_MIN_FREQ, "+ D0-", SHAPING_MAX_ZETA, " I0-", SHAPER_COUNT - 1);
+    }
+    stepper.shaping_report();
+  }
+  else if (!parser.seen("STO")) {
+    stepper.shaping_report();
+    return;
+  }
+  #endif
+
+  #if ENABLED(ANKER_VIBRATION_CONTROL)
   if (parser.seenval('S')){ // S: 0=CLOSED 1=T/S CURE 2= Zeroconf
     uint8_t mode = parser.value_byte();
     planner.VC.mode = mode;
@@ -170,6 +278,7 @@ void GcodeSuite::M4897(){
     if (WITHIN(omiga, 0.1f, 10000.0f)) {planner.VC.Zeroconf.omiga = omiga;}
     MYSERIAL2.printLine("VC.Zeroconf.omiga = %3.5f\n", omiga);
   }
+  #endif
 }
 
 #endif
@@ -331,4 +440,117 @@ void GcodeSuite::M4900() {
     GcodeSuite::M900();
 }
 
+#if ENABLED(ANKER_PROBE_CAPTURE)
+/**
+ * M4901: Probe trigger capture statistics
+ *
+ * With no parameters, print the captures, edge to stop latency and overshoot
+ * R: Reset the statistics
+ */
+void GcodeSuite::M4901(){
+  if (parser.seen('R')) {
+    probe_capture.reset();
+    MYSERIAL2.printLine("echo:probe capture reset\n");
+    return;
+  }
+  probe_capture.report();
+}
+#endif
+
+#if ENABLED(ANKER_BINARY_LOG)
+/**
+ * M4902: Binary host log
+ *
+ * S1: SEND_*_TO_HOST messages as binary records, see buildroot/share/scripts/blog_decode.py
+ * S0: Back to text
+ * With no parameters, print the record and drop counts
+ */
+void GcodeSuite::M4902(){
+  if (parser.seen('S')) anker_blog.enabled = parser.value_bool();
+  anker_blog.report();
+}
+#endif
+
+#if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+/**
+ * M4903: Endstop debounce statistics
+ *
+ * With no parameters, print the edges, glitches, bounces and edge to stop latency of each pin
+ * R: Reset the statistics
+ */
+void GcodeSuite::M4903(){
+  if (parser.seen('R')) {
+    es_debounce.reset();
+    MYSERIAL2.printLine("echo:endstop debounce reset\n");
+    return;
+  }
+  es_debounce.report();
+}
+#endif
+
+#if ENABLED(ANKER_MOVE_PACKET)
+/**
+ * M4904: Run the oldest move packet, queued by the move frame receiver
+ *
+ * R: Print the frame, move, error, position mismatch and refused packet counts instead
+ * S: Resync, the host has dealt with the "+moveerr" that halted the stream
+ * C: Print the "+moveconf" line of the settings the host prepass must use
+ */
+void GcodeSuite::M4904(){
+  if (parser.seen('R')) {
+    MYSERIAL2.printLine("Move packets frames:%d moves:%d errors:%d mismatches:%d refused:%d\n",
+      (int)anker_move_stream.frames, (int)anker_move_stream.moves, (int)anker_move_stream.errors,
+      (int)anker_move_stream.mismatches, (int)anker_move_stream.rejects);
+    anker_move_stream.report();
+    return;
+  }
+  if (parser.seen('S')) {
+    anker_move_stream.resync();
+    anker_move_stream.report();
+    return;
+  }
+  if (parser.seen('C')) {
+    anker_move_stream.report_config();
+    return;
+  }
+  anker_move_stream.run();
+}
+#endif
+
+#if ENABLED(ANKER_STEP_SCHED)
+/**
+ * M4905: Stepper ISR scheduling statistics
+ *
+ * With no parameters, print the multistepping, its switches, the ISR load and the smoothing budget
+ * R: Reset the statistics
+ */
+void GcodeSuite::M4905(){
+  if (parser.seen('R')) {
+    step_sched.reset();
+    MYSERIAL2.printLine("echo:step sched reset\n");
+    return;
+  }
+  step_sched.report();
+}
+#endif
+
+#if ENABLED(ANKER_FLOW_CTRL)
+/**
+ * M4906: Planner flow control
+ *
+ * With no parameters, print the lookahead, the drain rate and the last starves
+ * T<ms>: Lookahead the host is asked to keep queued
+ * R: Reset the starves
+ */
+void GcodeSuite::M4906(){
+  if (parser.seenval('T')) anker_flow.target_ms = constrain(parser.value_ushort(), 0, 10000);
+  if (parser.seen('R')) {
+    anker_flow.reset();
+    MYSERIAL2.printLine("echo:flow reset\n");
+    return;
+  }
+  anker_flow.report();
+}
+#endif
+
 #endif
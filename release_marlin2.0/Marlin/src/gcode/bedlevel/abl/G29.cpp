@@ -100,6 +100,10 @@
   #include "../../../feature/anker/anker_z_offset.h"
 #endif
 
+#if ENABLED(ANKER_FILTER_LEVEL_GRID)
+  #include "../../../feature/anker/anker_mesh_filter.h"
+#endif
+
 #if ABL_USES_GRID
   #if ENABLED(PROBE_Y_FIRST)
     #define PR_OUTER_VAR  abl.meshCount.x
@@ -171,10 +175,11 @@ public:
   constexpr int G29_State::abl_points;
 #endif
 
-#if ENABLED(ANKER_FILTER_LEVEL_GRID)
-extern void filter_leveling_grid(bed_mesh_t &din, const uint8_t outter_size, const uint8_t inner_size, bool debug_flag);
+#if ENABLED(ANKER_FLYING_MESH)
+  #define FLYING_MESH_RECHECK 0.3f  // (mm) A flying point this far from the line through the two before it is probed again point by point
 #endif
 
+
 /**
  * G29: Detailed Z probe, probes the bed at 3 or more points.
  *      Will fail if the printer has not been homed with G28.
@@ -251,6 +256,10 @@ extern void filter_leveling_grid(bed_mesh_t &din, const uint8_t outter_size, con
  *  E  By default G29 will engage the Z probe, test the bed, then disengage.
  *     Include "E" to engage/disengage the Z probe for each sample.
  *     There's no extra effect if you have a fixed Z probe.
+ *
+ *  U  With ANKER_FLYING_MESH, U0 probes point by point. By default each point is one
+ *     touch, its raise is queued with the next hop and the nozzle board is armed during
+ *     travel. A point off the line of the two before it is probed again point by point.
  */
 G29_TYPE GcodeSuite::G29() {
   MYSERIAL2.printLine("ok\n");
@@ -659,6 +668,22 @@ G29_TYPE GcodeSuite::G29() {
 
       abl.measured_z = 0;
 
+      #if ENABLED(ANKER_FLYING_MESH)
+        // The serpentine keeps every point next to the previous one, so each height is checked against
+        // the line through the two before it in the row, or the previous point at the start of a row
+        const bool flying = !faux && raise_after == PROBE_PT_RAISE && parser.boolval('U', true);
+        float flying_z[2] = { NAN, NAN };   // The two points before, the newest last
+        uint8_t flying_run = 0;             // Points of the current row so far
+        const millis_t flying_start_ms = millis();
+      #endif
+
+      #if BOTH(ANKER_PROBE_ADAPTIVE, AUTO_BED_LEVELING_BILINEAR)
+        // Points whose samples never agreed, probed again after the grid
+        xy_int8_t reprobe[GRID_MAX_POINTS];
+        float reprobe_z[GRID_MAX_POINTS];
+        uint8_t reprobe_count = 0;
+      #endif
+
       // Outer loop is X with PROBE_Y_FIRST enabled
       // Outer loop is Y with PROBE_Y_FIRST disabled
       for (PR_OUTER_VAR = 0; PR_OUTER_VAR < PR_OUTER_SIZE && !isnan(abl.measured_z); PR_OUTER_VAR++) {
@@ -678,6 +703,8 @@ G29_TYPE GcodeSuite::G29() {
 
         zig ^= true; // zag
 
+        TERN_(ANKER_FLYING_MESH, flying_run = 0);
+
         // An index to print current state
         uint8_t pt_index = (PR_OUTER_VAR) * (PR_INNER_SIZE) + 1;
 
@@ -711,6 +738,20 @@ G29_TYPE GcodeSuite::G29() {
 
           TERN_(ADAPT_DETACHED_NOZZLE, uart_nozzle_tx_point_type(POINT_G29, pt_index));
 
+          #if ENABLED(ANKER_FLYING_MESH)
+            if (flying) {
+              abl.measured_z = probe.probe_at_point_flying(abl.probePos);
+              const float predicted_z = flying_run >= 2 ? 2 * flying_z[1] - flying_z[0] : flying_z[1];
+              if (!isnan(abl.measured_z) && !isnan(predicted_z) && ABS(abl.measured_z - predicted_z) > FLYING_MESH_RECHECK) {
+                SERIAL_ECHOLNPAIR("echo:flying mesh recheck point ", pt_index, " z:", abl.measured_z, " predicted:", predicted_z);
+                abl.measured_z = probe.probe_at_point(abl.probePos, raise_after, abl.verbose_level);
+              }
+              flying_z[0] = flying_z[1];
+              flying_z[1] = abl.measured_z;
+              flying_run++;
+            }
+            else
+          #endif
           abl.measured_z = faux ? 0.001f * random(-100, 101) : probe.probe_at_point(abl.probePos, raise_after, abl.verbose_level);
 
           if (isnan(abl.measured_z)) {
@@ -745,6 +786,12 @@ G29_TYPE GcodeSuite::G29() {
             //2021-10-18 harley
             ;
             TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(abl.meshCount, z));
+            #if ENABLED(ANKER_PROBE_ADAPTIVE)
+              if (!faux && probe.flagged) {
+                reprobe[reprobe_count] = abl.meshCount;
+                reprobe_z[reprobe_count++] = abl.measured_z;
+              }
+            #endif
             //TERN_(ANKER_UI,AnkerUI::levlUpdate(abl.abl_probe_index, z));
               #if ENABLED(REPORT_LEVEL_PORT)
                SERIAL_ECHO("echo:auto_level_index:");
@@ -760,6 +807,30 @@ G29_TYPE GcodeSuite::G29() {
         } // inner
       } // outer
 
+      #if ENABLED(ANKER_FLYING_MESH)
+        if (flying) {
+          planner.synchronize();  // The last raise is still queued
+          SERIAL_ECHOLNPAIR("echo:flying mesh ", abl.abl_points, " points in ", millis() - flying_start_ms, "ms");
+        }
+      #endif
+
+      #if BOTH(ANKER_PROBE_ADAPTIVE, AUTO_BED_LEVELING_BILINEAR)
+        // Once more for the flagged points, the bed and the probe have settled by now
+        if (!isnan(abl.measured_z)) LOOP_L_N(i, reprobe_count) {
+          const xy_int8_t &m = reprobe[i];
+          abl.probePos = abl.probe_position_lf + abl.gridSpacing * m.asFloat();
+          const float z = probe.probe_at_point(abl.probePos, raise_after, abl.verbose_level);
+          SERIAL_ECHOLNPAIR("echo:reprobe point ", m.x, ",", m.y, " flagged:", probe.flagged);
+          if (isnan(z)) {           // A probe failure, as in the first pass
+            abl.measured_z = NAN;
+            set_bed_leveling_enabled(abl.reenable);
+            break;
+          }
+          z_values[m.x][m.y] += z - reprobe_z[i];
+          TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(m, z_values[m.x][m.y]));
+        }
+      #endif
+
     #elif ENABLED(AUTO_BED_LEVELING_3POINT)
 
       // Probe at 3 arbitrary points
@@ -824,9 +895,10 @@ G29_TYPE GcodeSuite::G29() {
       print_bilinear_leveling_grid();
 
       #if ENABLED(ANKER_FILTER_LEVEL_GRID)
-        filter_leveling_grid(z_values, GRID_MAX_POINTS_X, GRID_MAX_POINTS_Y, ENABLE);
-        SERIAL_ECHOLNPGM(">>>>>>>>>>>>>>> after filter level:");
-        print_bilinear_leveling_grid();
+        if (!abl.dryrun && anker_mesh_filter.process(z_values)) {
+          SERIAL_ECHOLNPGM(">>>>>>>>>>>>>>> after filter level:");
+          print_bilinear_leveling_grid();
+        }
       #endif
       
       refresh_bed_level();
@@ -30,6 +30,10 @@
 #include "../../../module/planner.h"
 #include "../../queue.h"
 
+#if ENABLED(ANKER_TMC_POLL)
+  #include "../../../feature/anker/anker_tmc_poll.h"
+#endif
+
 #if ENABLED(MONITOR_DRIVER_STATUS)
 
   #define M91x_USE(ST) (AXIS_DRIVER_TYPE(ST, TMC2130) || AXIS_DRIVER_TYPE(ST, TMC2160) || AXIS_DRIVER_TYPE(ST, TMC2208) || AXIS_DRIVER_TYPE(ST, TMC2209) || AXIS_DRIVER_TYPE(ST, TMC2660) || AXIS_DRIVER_TYPE(ST, TMC5130) || AXIS_DRIVER_TYPE(ST, TMC5160))
@@ -368,6 +372,7 @@
           case K_AXIS: stepperK.homing_threshold(value); break;
         #endif
       }
+      TERN_(ANKER_TMC_POLL, anker_tmc_poll.invalidate_all());
     }
 
     if (report) {
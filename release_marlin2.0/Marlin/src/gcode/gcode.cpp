@@ -1173,12 +1173,37 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
             case 4203:M4203(); break;
             case 4204:M4204(); break; 
             case 4205:M4205(); break;
+            case 4894:M4894(); break;
+            #if ENABLED(ANKER_SHAPING_CAL) && ENABLED(INPUT_SHAPING)
+            case 4895:M4895(); break;
+            #endif
+            #if ENABLED(ANKER_ISR_PROFILE)
+            case 4896:M4896(); break;
+            #endif
             case 4897:M4897(); break;
             #if ENABLED(ANKER_MOTION_TRACKING)
             case 4898:M4898(); break;
             #endif
             case 4899:M4899(); break;
             case 4900:M4900(); break;
+            #if ENABLED(ANKER_PROBE_CAPTURE)
+            case 4901:M4901(); break;
+            #endif
+            #if ENABLED(ANKER_BINARY_LOG)
+            case 4902:M4902(); break;
+            #endif
+            #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+            case 4903:M4903(); break;
+            #endif
+            #if ENABLED(ANKER_MOVE_PACKET)
+            case 4904:M4904(); break;
+            #endif
+            #if ENABLED(ANKER_STEP_SCHED)
+            case 4905:M4905(); break;
+            #endif
+            #if ENABLED(ANKER_FLOW_CTRL)
+            case 4906:M4906(); break;
+            #endif
           #endif
       #endif
          default:
@@ -1239,12 +1239,37 @@ private:
         static void M4203();
         static void M4204();
         static void M4205();
+        static void M4894();
+        #if ENABLED(ANKER_SHAPING_CAL) && ENABLED(INPUT_SHAPING)
+        static void M4895();
+        #endif
+        #if ENABLED(ANKER_ISR_PROFILE)
+        static void M4896();
+        #endif
         static void M4897();
         #if ENABLED(ANKER_MOTION_TRACKING)
         static void M4898();
         #endif
         static void M4899();
         static void M4900();
+        #if ENABLED(ANKER_PROBE_CAPTURE)
+        static void M4901();
+        #endif
+        #if ENABLED(ANKER_BINARY_LOG)
+        static void M4902();
+        #endif
+        #if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+        static void M4903();
+        #endif
+        #if ENABLED(ANKER_MOVE_PACKET)
+        static void M4904();
+        #endif
+        #if ENABLED(ANKER_STEP_SCHED)
+        static void M4905();
+        #endif
+        #if ENABLED(ANKER_FLOW_CTRL)
+        static void M4906();
+        #endif
       #endif
   #endif
 
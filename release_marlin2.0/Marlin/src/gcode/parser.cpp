@@ -38,11 +38,6 @@ bool GCodeParser::volumetric_enabled;
   uint8_t GCodeParser::layer_change_flag = 0;
   float GCodeParser::layer_num = 0;
   //end add by jason.wu for detect layer change to notify remote controller capture
-
-  /******************************************************************/
-    bool       GCodeParser::report_layer;
-    float     GCodeParser::report_layer_num;
-    xyze_pos_t GCodeParser::report_pos;  
 #endif
 
 #if ENABLED(ANKER_M_CMDBUF)
@@ -67,6 +67,19 @@ GCodeQueue queue;
 #include "../feature/interactive/M3011_3100.h"
 #endif
 
+#if BOTH(DIRECT_STEPPING, ANKER_MULTIORDER_PACK)
+  #include "../feature/direct_stepping.h"
+  #include "../feature/anker/anker_page_stream.h"
+#endif
+
+#if BOTH(ANKER_MOVE_PACKET, ANKER_MULTIORDER_PACK)
+  #include "../feature/anker/anker_move_stream.h"
+#endif
+
+#if ENABLED(ANKER_FLOW_CTRL)
+  #include "../feature/anker/anker_flow_ctrl.h"
+#endif
+
 // Frequently used G-code strings
 PGMSTR(G28_STR, "G28");
 
@@ -115,9 +128,25 @@ char GCodeQueue::injected_commands[64]; // = { 0 }
   {
     int is_empty = empty() && (planner.movesplanned() < 4);
     MYSERIAL2.printLine("+ringbuf:%d,%d,%d\n", ring_buffer.length, BUFSIZE, is_empty);
+    #if ENABLED(DIRECT_STEPPING)
+      // Step pages are flow controlled like the commands, free pages, total, bad frames
+      MYSERIAL2.printLine("+pagebuf:%d,%d,%d\n", page_manager.free_pages(), DirectStepping::Config::NUM_PAGES, (int)anker_page_stream.errors);
+    #endif
+    // Move packet slots, the same way
+    TERN_(ANKER_MOVE_PACKET, anker_move_stream.report());
+    // Planner lookahead against its target, the host paces the packs on it
+    TERN_(ANKER_FLOW_CTRL, anker_flow.report_host());
   }
 #endif
 
+/**
+ * Clear the Marlin command queue, and the move packets its M4904s would have run
+ */
+void GCodeQueue::clear() {
+  ring_buffer.clear();
+  TERN_(ANKER_MOVE_PACKET, anker_move_stream.clear());
+}
+
 void GCodeQueue::RingBuffer::commit_command(bool skip_ok
   OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
 ) {
@@ -676,6 +705,9 @@ bool GCodeQueue::multi_pack_recv(int c, int p)
   static unsigned int  chkpos;      //Check code location
   static unsigned int  state   = 0; //current state
   static unsigned int timeout = 0;  //timeout timer
+  #if EITHER(DIRECT_STEPPING, ANKER_MOVE_PACKET)
+    static bool line_start = true;  //next char starts a line
+  #endif
   #define IS_UARTX 1
   if (p != IS_UARTX) //only responce uart1 from junzheng
     return false;
@@ -688,6 +720,20 @@ bool GCodeQueue::multi_pack_recv(int c, int p)
   switch (state)
   {
   case 0:
+    #if EITHER(DIRECT_STEPPING, ANKER_MOVE_PACKET)
+    {
+      // The '#' page and '%' move frames only open at the start of a line, a frame is a line
+      // of its own. Inside a frame the other receiver never sees the bytes as a start of line.
+      const bool sync = line_start;
+      line_start = ISEOL(c);
+      #if ENABLED(DIRECT_STEPPING)
+        if (anker_page_stream.recv(c, sync)) { line_start = !anker_page_stream.busy(); return true; }
+      #endif
+      #if ENABLED(ANKER_MOVE_PACKET)
+        if (anker_move_stream.recv(c, sync, p)) { line_start = !anker_move_stream.busy(); return true; }
+      #endif
+    }
+    #endif
     if (c != '@') {
       return false;
     } else {
@@ -65,6 +65,8 @@
 #define ANKER_BELT_CHECK      0 // for belt inspection
 #define ANKER_PROBE_SET       1
 #define ADAPT_DETACHED_NOZZLE 1 // adapt detached nozzle board(GD32E230)
+#define ANKER_PROBE_ACK       1 // wait for the nozzle board probe set ACK instead of fixed delays
+#define ANKER_FLYING_MESH     1 // G29 arms the nozzle board during the XY hop and queues the raise with the next hop
 #define ANKER_TEMP_WATCH      1
 #define USE_Z_SENSORLESS      1 //
 #define EVT_HOMING_5X         1
@@ -74,6 +76,7 @@
 #define NO_CHECK_Z_HOMING         1 // Does not detect whether Z is zeroed
 #define ANKER_M_CMDBUF            1 //
 #define ANKER_PROBE_DETECT_TIMES  1 // Probe multiple times at the same point
+#define ANKER_PROBE_ADAPTIVE      1 // Touch a point only until the samples agree, re-probe the points that never do
 #define ANKER_SIMPLE_HOMING       1 // Probe multiple times at the same point
 #define ANKER_E_SMOOTH            1
 #define ANKER_OVERPRESSURE_REPORT 0 // if overpressure is detected, the down-probing function should be stopped and an error should be reported.
@@ -81,8 +84,22 @@
 #define ANKER_RETRACTION_E_JERK   1 // retraction_e_jerk. Independent setting of starting speeds for E-axis retraction and feed-in
 #define ANKER_VIBRATION_CONTROL   1 // T/S curve switching and Zero configuration(Zeroconf)
 #define ANKER_CORNER_CALC         1 // Corner angle calculation
+#define ANKER_VELOCITY_PROFILE    1 // Junction speed from the path curvature over several lines, replaces the ANKER_CORNER_CALC limit
 #define ANKER_STARTUP_SPEED_ERR   0 // Excessive startup speed error
-#define ANKER_FILTER_LEVEL_GRID   0 //filter_leveling_grid
+#define ANKER_FILTER_LEVEL_GRID   1 // Leveling mesh cleanup after G29, M3034
+#define ANKER_ISR_PROFILE         1 // DWT cycle counter timing of stepper/temperature ISRs, see M4896
+#define ANKER_TMC_POLL            1 // Shadowed TMC2209 register writes and time-sliced DRV_STATUS/SG_RESULT polling
+#define ANKER_STEP_PORT_BATCH     1 // Square wave X/Y/E step toggles written as one word per GPIO port
+#define ANKER_SHAPING_CAL         1 // M4895 input shaping resonance sweep, StallGuard load as the response
+#define ANKER_PROBE_CAPTURE       1 // Probe edge timestamp, trigger Z interpolated between Z steps, M4901
+#define ANKER_BINARY_LOG          1 // SEND_*_TO_HOST as binary records decoded on the host, M4902
+#define ANKER_STEPPER_SNAPSHOT    1 // Untorn position/progress/rate of the steppers for reports and telemetry
+#define ANKER_Z_STALL_LEARN       1 // Z homing SGTHRS from the SG_RESULT baseline of the first mm of the move, M2003 L
+#define ANKER_ALIGN_LSQ           1 // G36 correction fitted over the passes, applied on the next rise in one move
+#define ANKER_ENDSTOP_DEBOUNCE    1 // Endstop EXTI edges debounced by a one-shot timer, per pin glitch statistics, M4903
+#define ANKER_MOVE_PACKET         1 // Pre-leveled, pre-segmented move packets from the host G-code prepass, M4904
+#define ANKER_STEP_SCHED          1 // Multistepping with hysteresis, smoothing budget from the measured stepper ISR load, M4905
+#define ANKER_FLOW_CTRL           1 // Planner lookahead in ms and starvation events, +flow backpressure for the host, M4906
 #endif
 
 /*******************************Error detection****************************/
@@ -94,3 +111,18 @@
 #error "HANDSHAKE needs to be enabled HEATER_EN_CONTROL"
 #endif
 #endif
+#if ANKER_Z_STALL_LEARN
+#if USE_Z_SENSORLESS == 0 || ANKER_TMC_POLL == 0
+#error "ANKER_Z_STALL_LEARN needs to be enabled USE_Z_SENSORLESS and ANKER_TMC_POLL"
+#endif
+#endif
+#if ANKER_MOVE_PACKET
+#if ANKER_MULTIORDER_PACK == 0
+#error "ANKER_MOVE_PACKET needs to be enabled ANKER_MULTIORDER_PACK"
+#endif
+#endif
+#if ANKER_FLOW_CTRL
+#if ANKER_MULTIORDER_PACK == 0 || ANKER_MAKE_API == 0
+#error "ANKER_FLOW_CTRL needs to be enabled ANKER_MULTIORDER_PACK and ANKER_MAKE_API"
+#endif
+#endif
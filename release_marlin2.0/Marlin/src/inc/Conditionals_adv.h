@@ -964,7 +964,7 @@
 #endif
 
 // Flag whether least_squares_fit.cpp is used
-#if ANY(AUTO_BED_LEVELING_UBL, AUTO_BED_LEVELING_LINEAR, Z_STEPPER_ALIGN_KNOWN_STEPPER_POSITIONS)
+#if ANY(AUTO_BED_LEVELING_UBL, AUTO_BED_LEVELING_LINEAR, Z_STEPPER_ALIGN_KNOWN_STEPPER_POSITIONS, ANKER_FILTER_LEVEL_GRID)
   #define NEED_LSF 1
 #endif
 
@@ -994,6 +994,15 @@
   #if defined(SHAPING_FREQ_Y) && SHAPING_BUFFER_Y
     #define HAS_SHAPING_Y 1
   #endif
+  #ifndef SHAPING_TYPE_X
+    #define SHAPING_TYPE_X SHAPER_ZV
+  #endif
+  #ifndef SHAPING_TYPE_Y
+    #define SHAPING_TYPE_Y SHAPER_ZV
+  #endif
+  #ifndef SHAPING_MIN_FREQ
+    #define SHAPING_MIN_FREQ TERN(__AVR__, 40, 20)  // 16-bit AVR timer limits the longest echo delay
+  #endif
 #endif
 
 
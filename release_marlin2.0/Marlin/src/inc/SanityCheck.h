@@ -1222,8 +1222,6 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
   );
   #if ENABLED(S_CURVE_ACCELERATION) && DISABLED(EXPERIMENTAL_SCURVE)
     #error "LIN_ADVANCE and S_CURVE_ACCELERATION may not play well together! Enable EXPERIMENTAL_SCURVE to continue."
-  #elif ENABLED(DIRECT_STEPPING)
-    #error "DIRECT_STEPPING is incompatible with LIN_ADVANCE. Enable in external planner if possible."
   #elif !HAS_JUNCTION_DEVIATION && defined(DEFAULT_EJERK)&&!ANKER_MAKE_API
     static_assert(DEFAULT_EJERK >= 10, "It is strongly recommended to set DEFAULT_EJERK >= 10 when using LIN_ADVANCE.");
   #endif
@@ -1689,6 +1687,24 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
  * Bed Leveling Requirements
  */
 
+#if ENABLED(ABL_BILINEAR_BICUBIC)
+  #if DISABLED(AUTO_BED_LEVELING_BILINEAR)
+    #error "ABL_BILINEAR_BICUBIC requires AUTO_BED_LEVELING_BILINEAR."
+  #elif ENABLED(ABL_BILINEAR_SUBDIVISION)
+    #error "ABL_BILINEAR_BICUBIC and ABL_BILINEAR_SUBDIVISION are incompatible."
+  #elif IS_CARTESIAN && DISABLED(SEGMENT_LEVELED_MOVES)
+    #error "ABL_BILINEAR_BICUBIC requires SEGMENT_LEVELED_MOVES."
+  #endif
+#endif
+
+#if ENABLED(ANKER_PROBE_ADAPTIVE)
+  #if DISABLED(ANKER_PROBE_DETECT_TIMES)
+    #error "ANKER_PROBE_ADAPTIVE requires ANKER_PROBE_DETECT_TIMES."
+  #elif MULTIPLE_PROBING != 2
+    #error "ANKER_PROBE_ADAPTIVE requires MULTIPLE_PROBING 2, the fast approach is the first sample."
+  #endif
+#endif
+
 #if ENABLED(AUTO_BED_LEVELING_UBL)
 
   /**
@@ -3814,11 +3830,18 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
 #endif
 
 #if ENABLED(INPUT_SHAPING)
-  #if ENABLED(DIRECT_STEPPING)
-    #error "INPUT_SHAPING cannot currently be used with DIRECT_STEPPING."
-  #elif ENABLED(LASER_FEATURE)
+  #if ENABLED(LASER_FEATURE)
     #error "INPUT_SHAPING cannot currently be used with LASER_FEATURE."
   #endif
+  #if HAS_SHAPING_X
+    static_assert((SHAPING_FREQ_X) >= (SHAPING_MIN_FREQ), "SHAPING_FREQ_X must be at least SHAPING_MIN_FREQ.");
+  #endif
+  #if HAS_SHAPING_Y
+    static_assert((SHAPING_FREQ_Y) >= (SHAPING_MIN_FREQ), "SHAPING_FREQ_Y must be at least SHAPING_MIN_FREQ.");
+  #endif
+  #ifdef __AVR__
+    static_assert(1.25f * (STEPPER_TIMER_RATE) / (SHAPING_MIN_FREQ) < 0x10000, "SHAPING_MIN_FREQ is too low for the 16-bit AVR shaping timer.");
+  #endif
 #endif
 
 // Misc. Cleanup
@@ -0,0 +1,90 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Catmull-Rom surface over a grid, one cell at a time in the power basis.
+ *
+ * Plain C++ with no Marlin configuration, the firmware leveling (ABL_BILINEAR_BICUBIC)
+ * and the host G-code prepass (feature/anker/prepass) evaluate the same surface with it.
+ */
+
+#include <stdint.h>
+
+// Grid point, the grid continued in a straight line past its edges. z(x, y) reads the grid.
+template<typename Z>
+static inline float catmull_rom_grid(const Z &z, const int8_t nx, const int8_t ny, const int8_t x, const int8_t y) {
+  if (x < 0) return 2 * catmull_rom_grid(z, nx, ny, 0, y) - catmull_rom_grid(z, nx, ny, 1, y);
+  if (x > nx - 1) return 2 * catmull_rom_grid(z, nx, ny, nx - 1, y) - catmull_rom_grid(z, nx, ny, nx - 2, y);
+  if (y < 0) return 2 * catmull_rom_grid(z, nx, ny, x, 0) - catmull_rom_grid(z, nx, ny, x, 1);
+  if (y > ny - 1) return 2 * catmull_rom_grid(z, nx, ny, x, ny - 1) - catmull_rom_grid(z, nx, ny, x, ny - 2);
+  return z(x, y);
+}
+
+// Catmull-Rom in the power basis, row m is the u^m coefficient of the 4 points
+static constexpr float catmull_rom_basis[4][4] = {
+  {  0.0f,  1.0f,  0.0f,  0.0f },
+  { -0.5f,  0.0f,  0.5f,  0.0f },
+  {  1.0f, -2.5f,  2.0f, -0.5f },
+  { -0.5f,  1.5f, -1.5f,  0.5f }
+};
+
+struct catmull_rom_cell {
+  // z = sum a[m][n] * u^m * v^n over the cell, u and v 0..1
+  float a[4][4];
+
+  // p(i, j) is the point i, j of the 4x4 around the cell, the cell spans 1..2
+  template<typename P>
+  void build(const P &p) {
+    float t[4][4];
+    for (uint8_t m = 0; m < 4; m++) for (uint8_t j = 0; j < 4; j++) {
+      t[m][j] = 0;
+      for (uint8_t i = 0; i < 4; i++) t[m][j] += catmull_rom_basis[m][i] * p(i, j);
+    }
+    for (uint8_t m = 0; m < 4; m++) for (uint8_t n = 0; n < 4; n++) {
+      a[m][n] = 0;
+      for (uint8_t j = 0; j < 4; j++) a[m][n] += t[m][j] * catmull_rom_basis[n][j];
+    }
+  }
+
+  // Coefficients of the polynomial in u along the line v
+  void at_v(const float v, float c[4]) const {
+    for (uint8_t m = 0; m < 4; m++) c[m] = ((a[m][3] * v + a[m][2]) * v + a[m][1]) * v + a[m][0];
+  }
+
+  static float poly(const float c[4], const float u) {
+    float z = 0;
+    for (int8_t m = 3; m >= 0; m--) z = z * u + c[m];
+    return z;
+  }
+
+  static float slope(const float c[4], const float u) {
+    return ((3 * c[3] * u) + 2 * c[2]) * u + c[1];
+  }
+
+  // dz/dv at u, v
+  float dv(const float u, const float v) const {
+    float d = 0;
+    for (int8_t m = 3; m >= 0; m--) d = d * u + ((3 * a[m][3] * v) + 2 * a[m][2]) * v + a[m][1];
+    return d;
+  }
+};
@@ -63,6 +63,14 @@
   #include "../feature/interactive/uart_nozzle_tx.h"
 #endif
 
+#if ENABLED(ANKER_PROBE_CAPTURE)
+  #include "../feature/anker/anker_probe_capture.h"
+#endif
+
+#if ENABLED(ANKER_ENDSTOP_DEBOUNCE)
+  #include "../feature/anker/anker_endstop_debounce.h"
+#endif
+
 Endstops endstops;
 
 // private:
@@ -774,8 +782,14 @@ void Endstops::update() {
 
   #if HAS_BED_PROBE
     // When closing the gap check the enabled probe
-    if (probe_switch_activated())
+    if (probe_switch_activated()) {
       UPDATE_ENDSTOP_BIT(Z, TERN(USES_Z_MIN_PROBE_PIN, MIN_PROBE, MIN));
+      #if ENABLED(ANKER_PROBE_CAPTURE)
+        constexpr EndstopEnum probe_es = _ENDSTOP(Z, TERN(USES_Z_MIN_PROBE_PIN, MIN_PROBE, MIN));
+        // With the debounce this runs ENDSTOP_DEBOUNCE_US after the edge, take the EXTI stamp
+        probe_capture.edge(TEST(live_state, probe_es) OPTARG(ANKER_ENDSTOP_DEBOUNCE, es_debounce.stamp(probe_es)));
+      #endif
+    }
   #endif
 
   #if HAS_Z_MAX && !Z_SPI_SENSORLESS
@@ -1154,6 +1168,7 @@ void Endstops::update() {
             #else
               PROCESS_ENDSTOP(Z, MIN_PROBE);
             #endif
+            TERN_(ANKER_PROBE_CAPTURE, if (TEST(hit_state, Z_MIN_PROBE)) probe_capture.stop());
           }
         #endif
       }
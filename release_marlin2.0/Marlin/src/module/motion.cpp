@@ -77,6 +77,9 @@
 
 #if ENABLED(USE_Z_SENSORLESS) 
   #include "../feature/anker/anker_z_sensorless.h"
+  #if ENABLED(ANKER_Z_STALL_LEARN)
+    #include "../feature/anker/anker_z_stall.h"
+  #endif
 #endif
 
 #if ENABLED(NO_MOTION_BEFORE_HOMING)
@@ -1752,12 +1755,18 @@ void prepare_line_to_destination() {
       #if ENABLED(USE_Z_SENSORLESS)
       anker_homing.set_triger_per_ms();
       #endif
+      TERN_(ANKER_Z_STALL_LEARN, if (axis == Z_AXIS && is_home_dir) anker_z_stall.begin());
       // Set delta/cartesian axes directly
       target[axis] = distance;                  // The move will be towards the endstop
       planner.buffer_segment(target OPTARG(HAS_DIST_MM_ARG, cart_dist_mm), home_fr_mm_s, active_extruder);
     #endif
 
-    planner.synchronize();
+    #if ENABLED(ANKER_Z_STALL_LEARN)
+      if (axis == Z_AXIS && is_home_dir)
+        anker_z_stall.wait();   // Learns the StallGuard baseline of the Z drivers while moving
+      else
+    #endif
+        planner.synchronize();
     
     if (is_home_dir) {
 
@@ -1770,6 +1779,7 @@ void prepare_line_to_destination() {
       // Re-enable stealthChop if used. Disable diag1 pin on driver.
       TERN_(SENSORLESS_HOMING, end_sensorless_homing_per_axis(axis, stealth_states));
       TERN_(SENSORLESS_STALLGUARD_DELAY, safe_delay(SENSORLESS_STALLGUARD_DELAY));// Short delay needed to settle
+      TERN_(ANKER_Z_STALL_LEARN, if (axis == Z_AXIS) anker_z_stall.end());
     }
   }
   
@@ -1968,6 +1978,9 @@ void prepare_line_to_destination() {
 
 #if ENABLED(WS1_HOMING_5X)
   #include "../feature/anker/anker_nozzle_board.h"
+  #if ENABLED(ANKER_TMC_POLL)
+    #include "../feature/anker/anker_tmc_poll.h"
+  #endif
 
   #if ENABLED(USE_Z_SENSORLESS)
 
@@ -1999,10 +2012,17 @@ void prepare_line_to_destination() {
     anker_homing.set_first_end_z_axis(Z_AXIS_IDLE);
 
     #if ENABLED(USE_Z_SENSORLESS)
+      #if ENABLED(ANKER_TMC_POLL)
+       anker_tmc_poll.set_sgthrs(ANKER_TMC_Z, use_z_sensorless.an_stall_value);
+       #ifdef ANKER_Z2_STALL_SENSITIVITY
+        anker_tmc_poll.set_sgthrs(ANKER_TMC_Z2, use_z_sensorless.an_stall_value);
+       #endif
+      #else
        stepperZ.anker_homing_threshold(use_z_sensorless.an_stall_value);
        #ifdef ANKER_Z2_STALL_SENSITIVITY
         stepperZ2.anker_homing_threshold(use_z_sensorless.an_stall_value);
        #endif
+      #endif
     #endif
 
     #if ENABLED(SENSORLESS_HOMING)
@@ -2040,10 +2060,17 @@ void prepare_line_to_destination() {
     }
 
    #if ENABLED(USE_Z_SENSORLESS)
+      #if ENABLED(ANKER_TMC_POLL)
+       anker_tmc_poll.set_sgthrs(ANKER_TMC_Z, ANKER_Z_STALL_SENSITIVITY);
+       #ifdef ANKER_Z2_STALL_SENSITIVITY
+        anker_tmc_poll.set_sgthrs(ANKER_TMC_Z2, ANKER_Z2_STALL_SENSITIVITY);
+       #endif
+      #else
        stepperZ.anker_homing_threshold(ANKER_Z_STALL_SENSITIVITY);
        #ifdef ANKER_Z2_STALL_SENSITIVITY
         stepperZ2.anker_homing_threshold(ANKER_Z2_STALL_SENSITIVITY);
        #endif
+      #endif
     #endif
 
     stepper.set_separate_multi_axis(false);
@@ -72,6 +72,11 @@
 #include "../MarlinCore.h"
 
 #include "../feature/interactive/uart_nozzle_tx.h"
+#include "../feature/anker/anker_isr_profile.h"
+
+#if ENABLED(ANKER_FLOW_CTRL)
+  #include "../feature/anker/anker_flow_ctrl.h"
+#endif
 
 #if HAS_LEVELING
   #include "../feature/bedlevel/bedlevel.h"
@@ -129,6 +134,7 @@ Planner planner;
  * A ring buffer of moves described in steps
  */
 block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+block_plan_t Planner::block_plan[BLOCK_BUFFER_SIZE];
 volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be pushed
                  Planner::block_buffer_nonbusy, // Index of the first non-busy block
                  Planner::block_buffer_planned, // Index of the optimally planned block
@@ -261,7 +267,7 @@ float Planner::previous_nominal_speed_sqr;
   xyze_pos_t Planner::position_cart;
 #endif
 
-#if HAS_WIRED_LCD
+#if HAS_BLOCK_BUFFER_RUNTIME
   volatile uint32_t Planner::block_buffer_runtime_us = 0;
 #endif
 
@@ -778,7 +784,7 @@ block_t* Planner::get_current_block() {
     if (TEST(block->flag, BLOCK_BIT_RECALCULATE)) return nullptr;
 
     // We can't be sure how long an active block will take, so don't count it.
-    TERN_(HAS_WIRED_LCD, block_buffer_runtime_us -= block->segment_time_us);
+    TERN_(HAS_BLOCK_BUFFER_RUNTIME, block_buffer_runtime_us -= block->segment_time_us);
 
     // As this block is busy, advance the nonbusy block pointer
     block_buffer_nonbusy = next_block_index(block_buffer_tail);
@@ -788,10 +794,10 @@ block_t* Planner::get_current_block() {
       block_buffer_planned = block_buffer_nonbusy;
 
     #if ENABLED(ANKER_E_SMOOTH)
-      if(LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+      if(block->la_version >= LIN_ADV_VERSION_2){
         if(block_buffer_head != block_buffer_nonbusy){// If there stiil are any moves queued.
           block_t * const nextblock = &block_buffer[block_buffer_nonbusy];
-          if (TEST(nextblock->flag, BLOCK_BIT_RECALCULATE)){// No trapezoid calculated?
+          if (TEST(nextblock->flag, BLOCK_BIT_RECALCULATE) || nextblock->la_version < LIN_ADV_VERSION_2){// No trapezoid calculated, or no la_segment?
             LA_CLEAR_SEGMENT(stepper.la_status.next); // clear
             return block;// Return the block
           }
@@ -806,7 +812,7 @@ block_t* Planner::get_current_block() {
   }
 
   // The queue became empty
-  TERN_(HAS_WIRED_LCD, clear_block_buffer_runtime()); // paranoia. Buffer is empty now - so reset accumulated time to zero.
+  TERN_(HAS_BLOCK_BUFFER_RUNTIME, clear_block_buffer_runtime()); // paranoia. Buffer is empty now - so reset accumulated time to zero.
 
   return nullptr;
 }
@@ -822,9 +828,18 @@ block_t* Planner::get_current_block() {
  * alter its values.
  */
 void Planner::calculate_trapezoid_for_block(block_t * const block, const_float_t entry_factor, const_float_t exit_factor) {
+  #if ENABLED(LIN_ADVANCE)
+    if (block->la_version >= LIN_ADV_VERSION_2) return calculate_trapezoid_kernel<true>(block, entry_factor, exit_factor);
+  #endif
+  calculate_trapezoid_kernel<false>(block, entry_factor, exit_factor);
+}
+
+// LA_V1: fill in the LIN_ADV_VERSION_2/3 advance fields, the 0/1 ones are set by recalculate_trapezoids()
+template<bool LA_V1>
+void Planner::calculate_trapezoid_kernel(block_t * const block, const_float_t entry_factor, const_float_t exit_factor) {
 
 #define INIT_RATE_CAL(INIT_RATE, MIN_STEP_RATE) do{                           \
-              const uint32_t initial_freq = (block->acceleration / INIT_RATE);\
+              const uint32_t initial_freq = (plan_of(block).acceleration / INIT_RATE);\
               if (initial_freq > uint32_t(MIN_STEP_RATE)){                   \
                NOLESS(initial_rate, uint32_t(initial_freq));                  \
               } else {                                                        \
@@ -916,29 +931,31 @@ void Planner::calculate_trapezoid_for_block(block_t * const block, const_float_t
   block->final_rate = final_rate;
 
   #if ENABLED(LIN_ADVANCE)
-    // version 1
-    if (block->la_advance_rate) {
-      const float comp = extruder_advance_K[E_INDEX_N(block->extruder)] * block->steps.e / block->step_event_count;
-      block->max_adv_steps_v1 = cruise_rate * comp;
-      block->final_adv_steps_v1 = final_rate * comp;
+    // version 1, the fields share their storage with the version 0 ones
+    if (LA_V1) {
+      if (block->la_advance_rate) {
+        const float comp = extruder_advance_K[E_INDEX_N(block->extruder)] * block->steps.e / block->step_event_count;
+        block->max_adv_steps_v1 = cruise_rate * comp;
+        block->final_adv_steps_v1 = final_rate * comp;
+        #if ENABLED(ANKER_E_SMOOTH)
+          // Calculate the maximum speed that can be accelerated
+          block->la_segment.acc_v2 = block->la_segment.double_steps_per_s2 * accelerate_steps; // vt^2 = 2as
+          block->la_segment.dec_v2 = block->la_segment.double_steps_per_s2 * decelerate_steps; // vt^2 = 2as
+          NOMORE(block->la_segment.acc_v2, sq(block->la_advance_rate));
+          NOMORE(block->la_segment.dec_v2, sq(block->la_advance_rate));
+          // Mark whether there is an acceleration or deceleration section in the block.
+          (accelerate_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.acc = true) : (block->la_segment.acc = false);
+          (decelerate_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.dec = true) : (block->la_segment.dec = false);
+          (plateau_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.cruise = true) : (block->la_segment.cruise = false);
+          block->la_segment.la_advance_rate = block->la_advance_rate;
+        #endif
+      }
       #if ENABLED(ANKER_E_SMOOTH)
-        // Calculate the maximum speed that can be accelerated
-        block->la_segment.acc_v2 = block->la_segment.double_steps_per_s2 * accelerate_steps; // vt^2 = 2as
-        block->la_segment.dec_v2 = block->la_segment.double_steps_per_s2 * decelerate_steps; // vt^2 = 2as
-        NOMORE(block->la_segment.acc_v2, sq(block->la_advance_rate));
-        NOMORE(block->la_segment.dec_v2, sq(block->la_advance_rate));
-        // Mark whether there is an acceleration or deceleration section in the block.
-        (accelerate_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.acc = true) : (block->la_segment.acc = false);
-        (decelerate_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.dec = true) : (block->la_segment.dec = false);
-        (plateau_steps > LA_MAX_NOISE_STEP) ? (block->la_segment.cruise = true) : (block->la_segment.cruise = false);
-        block->la_segment.la_advance_rate = block->la_advance_rate;
+        else {
+          block->la_segment.la_advance_rate = 0;
+        }
       #endif
     }
-	  #if ENABLED(ANKER_E_SMOOTH)
-	  else{
-      block->la_segment.la_advance_rate = 0;
-    }
-	  #endif
   #endif
   /**
    * Laser trapezoid calculations
@@ -1051,11 +1068,12 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
     // in the next block, there is no need to recheck. Block is cruising and there is no need to
     // compute anything for this block,
     // If not, block entry speed needs to be recalculated to ensure maximum possible planned speed.
-    const float max_entry_speed_sqr = current->max_entry_speed_sqr;
+    block_plan_t &cp = plan_of(current);
+    const float max_entry_speed_sqr = cp.max_entry_speed_sqr;
 
     // Compute maximum entry speed decelerating over the current block from its exit speed.
     // If not at the maximum entry speed, or the previous block entry speed changed
-    if (current->entry_speed_sqr != max_entry_speed_sqr || (next && TEST(next->flag, BLOCK_BIT_RECALCULATE))) {
+    if (cp.entry_speed_sqr != max_entry_speed_sqr || (next && TEST(next->flag, BLOCK_BIT_RECALCULATE))) {
 
       // If nominal length true, max junction speed is guaranteed to be reached.
       // If a block can de/ac-celerate from nominal speed to zero within the length of the block, then
@@ -1067,8 +1085,8 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
 
       const float new_entry_speed_sqr = TEST(current->flag, BLOCK_BIT_NOMINAL_LENGTH)
         ? max_entry_speed_sqr
-        : _MIN(max_entry_speed_sqr, max_allowable_speed_sqr(-current->acceleration, next ? next->entry_speed_sqr : sq(float(MINIMUM_PLANNER_SPEED)), current->millimeters));
-      if (current->entry_speed_sqr != new_entry_speed_sqr) {
+        : _MIN(max_entry_speed_sqr, max_allowable_speed_sqr(-cp.acceleration, next ? plan_of(next).entry_speed_sqr : sq(float(MINIMUM_PLANNER_SPEED)), cp.millimeters));
+      if (cp.entry_speed_sqr != new_entry_speed_sqr) {
 
         // Need to recalculate the block speed - Mark it now, so the stepper
         // ISR does not consume the block before being recalculated
@@ -1085,7 +1103,7 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
         else {
           // Block is not BUSY so this is ahead of the Stepper ISR:
           // Just Set the new entry speed.
-          current->entry_speed_sqr = new_entry_speed_sqr;
+          cp.entry_speed_sqr = new_entry_speed_sqr;
         }
       }
     }
@@ -1148,14 +1166,16 @@ void Planner::forward_pass_kernel(const block_t * const previous, block_t * cons
     // change, adjust the entry speed accordingly. Entry speeds have already been reset,
     // maximized, and reverse-planned. If nominal length is set, max junction speed is
     // guaranteed to be reached. No need to recheck.
+    const block_plan_t &pp = plan_of(previous);
+    block_plan_t &cp = plan_of(current);
     if (!TEST(previous->flag, BLOCK_BIT_NOMINAL_LENGTH) &&
-      previous->entry_speed_sqr < current->entry_speed_sqr) {
+      pp.entry_speed_sqr < cp.entry_speed_sqr) {
 
       // Compute the maximum allowable speed
-      const float new_entry_speed_sqr = max_allowable_speed_sqr(-previous->acceleration, previous->entry_speed_sqr, previous->millimeters);
+      const float new_entry_speed_sqr = max_allowable_speed_sqr(-pp.acceleration, pp.entry_speed_sqr, pp.millimeters);
 
       // If true, current block is full-acceleration and we can move the planned pointer forward.
-      if (new_entry_speed_sqr < current->entry_speed_sqr) {
+      if (new_entry_speed_sqr < cp.entry_speed_sqr) {
 
         // Mark we need to recompute the trapezoidal shape, and do it now,
         // so the stepper ISR does not consume the block before being recalculated
@@ -1174,10 +1194,10 @@ void Planner::forward_pass_kernel(const block_t * const previous, block_t * cons
           // Block is not BUSY, we won the race against the Stepper ISR:
 
           // Always <= max_entry_speed_sqr. Backward pass sets this.
-          current->entry_speed_sqr = new_entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
+          cp.entry_speed_sqr = new_entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
 
           // Set optimal plan pointer.
-          block_buffer_planned = block_index;
+          if (TERN1(ANKER_VELOCITY_PROFILE, !cp.provisional)) block_buffer_planned = block_index;
         }
       }
     }
@@ -1186,7 +1206,7 @@ void Planner::forward_pass_kernel(const block_t * const previous, block_t * cons
     // point in the buffer. When the plan is bracketed by either the beginning of the
     // buffer and a maximum entry speed or two maximum entry speeds, every block in between
     // cannot logically be further improved. Hence, we don't have to recompute them anymore.
-    if (current->entry_speed_sqr == current->max_entry_speed_sqr)
+    if (cp.entry_speed_sqr == cp.max_entry_speed_sqr TERN_(ANKER_VELOCITY_PROFILE, && !cp.provisional))
       block_buffer_planned = block_index;
   }
 }
@@ -1265,7 +1285,7 @@ void Planner::recalculate_trapezoids() {
 
     // Skip sync and page blocks
     if (!(next->flag & BLOCK_MASK_SYNC) && !IS_PAGE(next)) {
-      next_entry_speed = SQRT(next->entry_speed_sqr);
+      next_entry_speed = SQRT(plan_of(next).entry_speed_sqr);
 
       if (block) {
 
@@ -1282,12 +1302,12 @@ void Planner::recalculate_trapezoids() {
             // Block is not BUSY, we won the race against the Stepper ISR:
 
             // NOTE: Entry and exit factors always > 0 by all previous logic operations.
-            const float current_nominal_speed = SQRT(block->nominal_speed_sqr),
+            const float current_nominal_speed = SQRT(plan_of(block).nominal_speed_sqr),
                         nomr = 1.0f / current_nominal_speed;
             calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
             #if ENABLED(LIN_ADVANCE)
-              if (block->use_advance_lead) {
-                const float comp = block->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
+              if (block->la_version < LIN_ADV_VERSION_2 && block->use_advance_lead) {
+                const float comp = plan_of(block).e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
                 block->max_adv_steps = current_nominal_speed * comp;
                 block->final_adv_steps = next_entry_speed * comp;
               }
@@ -1321,12 +1341,12 @@ void Planner::recalculate_trapezoids() {
     if (!stepper.is_block_busy(block)) {
       // Block is not BUSY, we won the race against the Stepper ISR:
 
-      const float next_nominal_speed = SQRT(next->nominal_speed_sqr),
+      const float next_nominal_speed = SQRT(plan_of(next).nominal_speed_sqr),
                   nomr = 1.0f / next_nominal_speed;
       calculate_trapezoid_for_block(next, next_entry_speed * nomr, float(MINIMUM_PLANNER_SPEED) * nomr);
       #if ENABLED(LIN_ADVANCE)
-        if (next->use_advance_lead) {
-          const float comp = next->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
+        if (next->la_version < LIN_ADV_VERSION_2 && next->use_advance_lead) {
+          const float comp = plan_of(next).e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
           next->max_adv_steps = next_nominal_speed * comp;
           next->final_adv_steps = (MINIMUM_PLANNER_SPEED) * comp;
         }
@@ -1340,6 +1360,8 @@ void Planner::recalculate_trapezoids() {
 }
 
 void Planner::recalculate() {
+  TERN_(ANKER_VELOCITY_PROFILE, refine_junctions());
+
   // Initialize block index to the last block in the planner buffer.
   const uint8_t block_index = prev_block_index(block_buffer_head);
   // If there is just one block, no planning can be done. Avoid it!
@@ -1552,7 +1574,7 @@ void Planner::check_axes_activity() {
     for (uint8_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
       block_t *block = &block_buffer[b];
       if (LINEAR_AXIS_GANG(block->steps.x, || block->steps.y, || block->steps.z, || block->steps.i, || block->steps.j, || block->steps.k)) {
-        const float se = (float)block->steps.e / block->step_event_count * SQRT(block->nominal_speed_sqr); // mm/sec;
+        const float se = (float)block->steps.e / block->step_event_count * SQRT(plan_of(block).nominal_speed_sqr); // mm/sec;
         NOLESS(high, se);
       }
     }
@@ -1760,12 +1782,13 @@ void Planner::quick_stop() {
 
   // Drop all queue entries
   block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail;
+  TERN_(PHOTO_Z_LAYER, block_event.discard());
 
   // Restart the block delay for the first movement - As the queue was
   // forced to empty, there's no risk the ISR will touch this.
   delay_before_delivering = BLOCK_DELAY_FOR_1ST_MOVE;
 
-  #if HAS_WIRED_LCD
+  #if HAS_BLOCK_BUFFER_RUNTIME
     // Clear the accumulated runtime
     clear_block_buffer_runtime();
   #endif
@@ -1823,13 +1846,20 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
     // Requesting one of the "core" axes?
     if (axis == CORE_AXIS_1 || axis == CORE_AXIS_2) {
 
-      // Protect the access to the position.
-      const bool was_enabled = stepper.suspend();
+      #if ENABLED(ANKER_STEPPER_SNAPSHOT)
+        // Both from the same isr run, no need to stop the steppers
+        stepper_snapshot_t s;
+        stepper.snapshot(s);
+        const int32_t p1 = s.pos[CORE_AXIS_1], p2 = s.pos[CORE_AXIS_2];
+      #else
+        // Protect the access to the position.
+        const bool was_enabled = stepper.suspend();
 
-      const int32_t p1 = stepper.position(CORE_AXIS_1),
-                    p2 = stepper.position(CORE_AXIS_2);
+        const int32_t p1 = stepper.position(CORE_AXIS_1),
+                      p2 = stepper.position(CORE_AXIS_2);
 
-      if (was_enabled) stepper.wake_up();
+        if (was_enabled) stepper.wake_up();
+      #endif
 
       // ((a1+a2)+(a1-a2))/2 -> (a1+a2+a1-a2)/2 -> (a1+a1)/2 -> a1
       // ((a1+a2)-(a1-a2))/2 -> (a1+a2-a1+a2)/2 -> (a2+a2)/2 -> a2
@@ -1842,13 +1872,20 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
 
     // Requesting one of the joined axes?
     if (axis == CORE_AXIS_1 || axis == CORE_AXIS_2) {
-      // Protect the access to the position.
-      const bool was_enabled = stepper.suspend();
+      #if ENABLED(ANKER_STEPPER_SNAPSHOT)
+        // Both from the same isr run, no need to stop the steppers
+        stepper_snapshot_t s;
+        stepper.snapshot(s);
+        const int32_t p1 = s.pos[CORE_AXIS_1], p2 = s.pos[CORE_AXIS_2];
+      #else
+        // Protect the access to the position.
+        const bool was_enabled = stepper.suspend();
 
-      const int32_t p1 = stepper.position(CORE_AXIS_1),
-                    p2 = stepper.position(CORE_AXIS_2);
+        const int32_t p1 = stepper.position(CORE_AXIS_1),
+                      p2 = stepper.position(CORE_AXIS_2);
 
-      if (was_enabled) stepper.wake_up();
+        if (was_enabled) stepper.wake_up();
+      #endif
 
       axis_steps = ((axis == CORE_AXIS_1) ? p1 - p2 : p2);
     }
@@ -1868,6 +1905,7 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
  * Block until all buffered steps are executed / cleaned
  */
 void Planner::synchronize() {
+  TERN_(ANKER_FLOW_CTRL, anker_flow.sync());
   while (has_blocks_queued() || cleaning_buffer_counter
       || TERN0(EXTERNAL_CLOSED_LOOP_CONTROLLER, CLOSED_LOOP_WAITING())
   ) 
@@ -1876,7 +1914,7 @@ void Planner::synchronize() {
   }
 }
 
-#if ENABLED(ANKER_CORNER_CALC)
+#if ANY(ANKER_CORNER_CALC, ANKER_VELOCITY_PROFILE)
 /**
  *  Curvature Calculation. Curvature is calculated using the circumcircle method of a triangle.
  *  A(x1,y1) B(x2,y2) B(x3,y3)
@@ -1900,8 +1938,9 @@ static double_t curvity_calc(const double_t X_AB, const double_t Y_AB, const dou
 
   return curvity_radius;
 }
+#endif
 
-
+#if ENABLED(ANKER_CORNER_CALC)
 /**
  *  Compute cosine of angle between previous and current path.
  */
@@ -1972,6 +2011,101 @@ void  Planner::costheta_calc(const uint8_t moves_queued, const abce_long_t targe
 
 #endif
 
+#if ENABLED(ANKER_VELOCITY_PROFILE)
+/**
+ *  Path curvature over several lines.
+ *  Slicers write a curve as a run of short lines. The turn between two lines is small and
+ *  noisy, so a junction limit taken from one or two lines makes the speed saw up and down.
+ *  Instead a circle is fitted through the junction and the points VP_ARM_MM / VP_ARM_SEGMENTS
+ *  lines behind and ahead of it, and the entry speed is held to the centripetal acceleration
+ *  limit v^2 = a * R. The reverse and forward passes then plan the whole window against these
+ *  limits, and S-curve acceleration limits the jerk inside each block.
+ *
+ *  Until the path ahead is queued a junction limit is provisional: the smaller of the fit with
+ *  the one line ahead and the 3 point circle of the two lines. refine_junctions() fits the whole
+ *  arm once it is queued. It only ever raises max_entry_speed_sqr, so a block already planned
+ *  stays valid, and forward_pass() keeps block_buffer_planned behind the provisional blocks.
+ */
+static float path_radius(const xy_float_t &a, const xy_float_t &b, const xy_float_t &c) {
+  return ABS(curvity_calc(b.x - a.x, b.y - a.y, c.x - a.x, c.y - a.y, c.x - b.x, c.y - b.y));
+}
+
+// Point on the path behind the junction at the end of block k
+xy_float_t Planner::path_arm_back(uint8_t k) {
+  float len = 0;
+  for (uint8_t n = 1; ; n++) {
+    const block_plan_t &kp = block_plan[k];
+    len += kp.millimeters;
+    if (len >= VP_ARM_MM || n >= VP_ARM_SEGMENTS || !kp.joined || kp.turn_cos < VP_CORNER_COS) return kp.start;
+    k = prev_block_index(k);
+    if (k == block_buffer_head) return kp.start; // Overwritten by newer blocks
+  }
+}
+
+// Point on the path ahead of the junction at the start of block k. False while the arm reaches the queue head.
+bool Planner::path_arm_ahead(uint8_t k, const uint8_t head, xy_float_t &p) {
+  float len = 0;
+  for (uint8_t n = 1; ; n++) {
+    const block_plan_t &kp = block_plan[k];
+    p = kp.end;
+    len += kp.millimeters;
+    if (len >= VP_ARM_MM || n >= VP_ARM_SEGMENTS) return true;
+    k = next_block_index(k);
+    if (k == head) return false;
+    if (!block_plan[k].joined || block_plan[k].turn_cos < VP_CORNER_COS) return true; // The path ends or turns a corner
+  }
+}
+
+/**
+ * @brief  Record the XY line of the new block and limit its entry speed by the path curvature
+ * @param  block the block being planned, at block_buffer_head
+ * @param  moves_queued blocks in the queue before this one
+ * @param  target block target in steps
+ * @param  vmax_junction_sqr entry speed limit from jerk / junction deviation
+ * @retval the limited entry speed
+ */
+float Planner::path_junction_limit(block_t * const block, const uint8_t moves_queued, const abce_long_t &target, const_float_t vmax_junction_sqr) {
+  block_plan_t &plan = plan_of(block);
+  const block_plan_t &pp = block_plan[prev_block_index(block_buffer_head)];
+
+  plan.start.set(position.a * steps_to_mm[A_AXIS], position.b * steps_to_mm[B_AXIS]);
+  plan.end.set(target.a * steps_to_mm[A_AXIS], target.b * steps_to_mm[B_AXIS]);
+  plan.on_path = (block->steps.a || block->steps.b) && !block->steps.c;
+  plan.joined = plan.on_path && pp.on_path && moves_queued && !UNEAR_ZERO(previous_nominal_speed_sqr)
+             && pp.end.x == plan.start.x && pp.end.y == plan.start.y;
+  plan.junction_max_sqr = vmax_junction_sqr;
+  plan.provisional = false;
+  plan.turn_cos = 1.0f;
+  if (!plan.joined) return vmax_junction_sqr;
+
+  const xy_float_t u = pp.end - pp.start, v = plan.end - plan.start;
+  plan.turn_cos = (u.x * v.x + u.y * v.y) * RSQRT((sq(u.x) + sq(u.y)) * (sq(v.x) + sq(v.y)));
+  if (plan.turn_cos < VP_CORNER_COS) return vmax_junction_sqr;
+
+  float r = path_radius(path_arm_back(prev_block_index(block_buffer_head)), plan.start, plan.end);
+  plan.provisional = plan.millimeters < VP_ARM_MM;
+  if (plan.provisional) NOMORE(r, path_radius(pp.start, plan.start, plan.end));
+  return _MIN(vmax_junction_sqr, plan.acceleration * r);
+}
+
+// Fit the junctions whose path ahead is now queued. Called before the passes of recalculate().
+void Planner::refine_junctions() {
+  const uint8_t head = block_buffer_head, tail = block_buffer_tail;
+  uint8_t j = head;
+  LOOP_L_N(n, VP_ARM_SEGMENTS) {
+    if (j == tail) break;
+    j = prev_block_index(j);
+    block_plan_t &jp = block_plan[j];
+    xy_float_t c;
+    if (!jp.provisional || !path_arm_ahead(j, head, c)) continue;
+    jp.provisional = false;
+    const float v_sqr = _MIN(jp.junction_max_sqr, jp.acceleration * path_radius(path_arm_back(prev_block_index(j)), jp.start, c));
+    NOLESS(jp.max_entry_speed_sqr, v_sqr);
+  }
+}
+
+#endif
+
 
 #if ENABLED(ANKER_VIBRATION_CONTROL)
 float Planner::anker_start_accel(block_t * const block, const uint32_t esteps) {
@@ -1991,7 +2125,7 @@ float Planner::anker_start_accel(block_t * const block, const uint32_t esteps) {
         const float cal_max_accel = _MAX(planner.settings.max_acceleration_mm_per_s2[X_AXIS], planner.settings.max_acceleration_mm_per_s2[Y_AXIS]);
         
         MYSERIAL1.printLine("VC Accel=%3.2f", acceleration);
-        acceleration = SQRT(block->nominal_speed_sqr) / ((2 * PI * VC.Zeroconf.N)/VC.Zeroconf.omiga);
+        acceleration = SQRT(plan_of(block).nominal_speed_sqr) / ((2 * PI * VC.Zeroconf.N)/VC.Zeroconf.omiga);
         NOMORE(acceleration, cal_max_accel);
         NOLESS(acceleration, 200);
         MYSERIAL1.printLine(" %3.2f %s\r\n", acceleration, parser.command_ptr);
@@ -2130,6 +2264,8 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   OPTARG(HAS_DIST_MM_ARG, const xyze_float_t &cart_dist_mm)
   , feedRate_t fr_mm_s, const uint8_t extruder, const_float_t millimeters/*=0.0*/
 ) {
+  ISR_PROFILE(PROF_POPULATE_BLOCK);
+  block_plan_t &plan = plan_of(block);
   int32_t LOGICAL_AXIS_LIST(
     de = target.e - position.e,
     da = target.a - position.a,
@@ -2139,26 +2275,6 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     dj = target.j - position.j,
     dk = target.k - position.k
   );
-  #if ENABLED(PHOTO_Z_LAYER)
-    //begin add by jason.wu for detect layer change to notify remote controller capture
-    #if 0
-    if(dc != 0)
-      block->layer_change_flag = (dc > 0) ? 1 : -1;
-    else
-      block->layer_change_flag = 0;
-    memcpy(&block->target_layer_start_pos,&target_float,sizeof(xyze_pos_t));
-    #else
-    if(parser.layer_change_flag != 0)
-    {
-      parser.layer_change_flag = 0;
-      block->layer_change_flag = 1;
-      block->layer_num = parser.layer_num;
-      memcpy(&block->target_layer_start_pos,&target_float,sizeof(xyze_pos_t));
-    }
-    #endif
-  #endif
-  //end add by jason.wu for detect layer change to notify remote controller capture
-  
   /* <-- add a slash to enable
     SERIAL_ECHOLNPAIR(
       "  _populate_block FR:", fr_mm_s,
@@ -2278,6 +2394,9 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   // Set direction bits
   block->direction_bits = dm;
 
+  // Plan for the LA generation in use now, M4899 may change it while the block waits
+  TERN_(LIN_ADVANCE, block->la_version = LIN_ADV_version_change);
+
   // Update block laser power
   #if ENABLED(LASER_POWER_INLINE)
     laser_inline.status.isPlanned = true;
@@ -2374,13 +2493,13 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
       && block->steps.k < MIN_STEPS_PER_SEGMENT
     )
   ) {
-    block->millimeters = TERN0(HAS_EXTRUDERS, ABS(steps_dist_mm.e));
+    plan.millimeters = TERN0(HAS_EXTRUDERS, ABS(steps_dist_mm.e));
   }
   else {
     if (millimeters)
-      block->millimeters = millimeters;
+      plan.millimeters = millimeters;
     else {
-      block->millimeters = SQRT(
+      plan.millimeters = SQRT(
         #if EITHER(CORE_IS_XY, MARKFORGED_XY)
           LINEAR_AXIS_GANG(
               sq(steps_dist_mm.head.x), + sq(steps_dist_mm.head.y), + sq(steps_dist_mm.z),
@@ -2438,6 +2557,16 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   #endif
       {if (block->step_event_count < MIN_STEPS_PER_SEGMENT) return false;}
 
+  #if ENABLED(PHOTO_Z_LAYER)
+    // Detect layer change to notify remote controller capture, past the zero-length bail so the
+    // event goes with a block that runs. A full event table keeps the flag for the next block.
+    block->event_id = BLOCK_EVENT_NONE;
+    if (parser.layer_change_flag) {
+      block->event_id = block_event.alloc(BLOCK_EVENT_LAYER, parser.layer_num, target_float);
+      if (block->event_id) parser.layer_change_flag = 0;
+    }
+  #endif
+
   #if ENABLED(ANKER_STARTUP_SPEED_ERR)
     if (block->step_event_count == esteps){ block->axis_maximum_count = E_AXIS;}
     else if (block->step_event_count == block->steps.a){ block->axis_maximum_count = X_AXIS;}
@@ -2556,7 +2685,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   else
     NOLESS(fr_mm_s, settings.min_travel_feedrate_mm_s);
 
-  const float inverse_millimeters = 1.0f / block->millimeters;  // Inverse millimeters to remove multiple divides
+  const float inverse_millimeters = 1.0f / plan.millimeters;  // Inverse millimeters to remove multiple divides
 
   // Calculate inverse time for this move. No divide by zero due to previous checks.
   // Example: At 120mm/s a 60mm move takes 0.5s. So this will give 2.0.
@@ -2566,7 +2695,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   const uint8_t moves_queued = nonbusy_movesplanned();
 
   // Slow down when the buffer starts to empty, rather than wait at the corner for a buffer refill
-  #if EITHER(SLOWDOWN, HAS_WIRED_LCD) || defined(XY_FREQUENCY_LIMIT)
+  #if EITHER(SLOWDOWN, HAS_BLOCK_BUFFER_RUNTIME) || defined(XY_FREQUENCY_LIMIT)
     // Segment time im micro seconds
     int32_t segment_time_us = LROUND(1000000.0f / inverse_secs);
   #endif
@@ -2581,14 +2710,14 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
         // Buffer is draining so add extra time. The amount of time added increases if the buffer is still emptied more.
         const int32_t nst = segment_time_us + LROUND(2 * time_diff / moves_queued);
         inverse_secs = 1000000.0f / nst;
-        #if defined(XY_FREQUENCY_LIMIT) || HAS_WIRED_LCD
+        #if defined(XY_FREQUENCY_LIMIT) || HAS_BLOCK_BUFFER_RUNTIME
           segment_time_us = nst;
         #endif
       }
     }
   #endif
 
-  #if HAS_WIRED_LCD
+  #if HAS_BLOCK_BUFFER_RUNTIME
     // Protect the access to the position.
     const bool was_enabled = stepper.suspend();
 
@@ -2598,7 +2727,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     if (was_enabled) stepper.wake_up();
   #endif
 
-  block->nominal_speed_sqr = sq(block->millimeters * inverse_secs);   // (mm/sec)^2 Always > 0
+  plan.nominal_speed_sqr = sq(plan.millimeters * inverse_secs);   // (mm/sec)^2 Always > 0
   block->nominal_rate = CEIL(block->step_event_count * inverse_secs); // (step/sec) Always > 0
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
@@ -2682,7 +2811,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
         ys2 = ys1; ys1 = ys0;
       }
 
-      if (block->millimeters >= XY_FREQUENCY_TRIG_LENGTH){// Trigger at >=0.15mm
+      if (plan.millimeters >= XY_FREQUENCY_TRIG_LENGTH){// Trigger at >=0.15mm
         xs0 = TEST(direction_change, X_AXIS) ? segment_time_us : xy_freq_min_interval_us;
         ys0 = TEST(direction_change, Y_AXIS) ? segment_time_us : xy_freq_min_interval_us;
       }else{
@@ -2704,11 +2833,21 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
   #endif // XY_FREQUENCY_LIMIT
 
+  #if ENABLED(INPUT_SHAPING)
+    // Every step event of a shaped block is buffered until its last echo; keep the
+    // event rate within what the echo buffer holds over that delay
+    LOOP_L_N(i, XY) {
+      const shaping_params_t * const sp = stepper.get_shaping(AxisEnum(i));
+      if (sp && sp->echoes && block->steps[i] && block->nominal_rate * speed_factor > sp->max_rate)
+        speed_factor = float(sp->max_rate) / block->nominal_rate;
+    }
+  #endif
+
   // Correct the speed
   if (speed_factor < 1.0f) {
     current_speed *= speed_factor;
     block->nominal_rate *= speed_factor;
-    block->nominal_speed_sqr = block->nominal_speed_sqr * sq(speed_factor);
+    plan.nominal_speed_sqr = plan.nominal_speed_sqr * sq(speed_factor);
   }
 
   // Compute and limit the acceleration rate for the trapezoid generator.
@@ -2716,9 +2855,9 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   uint32_t accel;
   #if ENABLED(LIN_ADVANCE)
     block->use_advance_lead = false;
-	  #if ENABLED(ANKER_E_SMOOTH)
-      LA_CLEAR_SEGMENT(block->la_segment);
-	  #endif
+    #if ENABLED(ANKER_E_SMOOTH)
+      if (block->la_version >= LIN_ADV_VERSION_2) LA_CLEAR_SEGMENT(block->la_segment);
+    #endif
   #endif
   if (LINEAR_AXIS_GANG(
          !block->steps.a, && !block->steps.b, && !block->steps.c,
@@ -2762,8 +2901,8 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
       block->use_advance_lead = esteps && extruder_advance_K[active_extruder] && de > 0;
 
       if (block->use_advance_lead) {
-        block->e_D_ratio = (target_float.e - position_float.e) /
-          TERN(IS_KINEMATIC, block->millimeters,
+        plan.e_D_ratio = (target_float.e - position_float.e) /
+          TERN(IS_KINEMATIC, plan.millimeters,
             SQRT(sq(target_float.x - position_float.x)
                + sq(target_float.y - position_float.y)
                + sq(target_float.z - position_float.z))
@@ -2771,11 +2910,11 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
         // Check for unusual high e_D ratio to detect if a retract move was combined with the last print move due to min. steps per segment. Never execute this with advance!
         // This assumes no one will use a retract length of 0mm < retr_length < ~0.2mm and no one will print 100mm wide lines using 3mm filament or 35mm wide lines using 1.75mm filament.
-        if (block->e_D_ratio > 3.0f)
+        if (plan.e_D_ratio > 3.0f)
           block->use_advance_lead = false;
         else {
           // Scale E acceleration so that it will be possible to jump to the advance speed.
-          const uint32_t max_accel_steps_per_s2 = MAX_E_JERK(extruder) / (extruder_advance_K[active_extruder] * block->e_D_ratio) * steps_per_mm;
+          const uint32_t max_accel_steps_per_s2 = MAX_E_JERK(extruder) / (extruder_advance_K[active_extruder] * plan.e_D_ratio) * steps_per_mm;
           if (TERN0(LA_DEBUG, accel > max_accel_steps_per_s2))
             MYSERIAL2.printLine("Acceleration limited. %d\r\n", (uint32_t)(max_accel_steps_per_s2 / steps_per_mm));
           NOMORE(accel, max_accel_steps_per_s2);
@@ -2808,31 +2947,36 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     }
   }
   block->acceleration_steps_per_s2 = accel;
-  block->acceleration = accel / steps_per_mm;
+  plan.acceleration = accel / steps_per_mm;
   #if (DISABLED(S_CURVE_ACCELERATION) || ENABLED(ANKER_E_SMOOTH)) // LA_V0
     block->acceleration_rate = (uint32_t)(accel * (sq(4096.0f) / (STEPPER_TIMER_RATE)));
   #endif
   #if ENABLED(LIN_ADVANCE)
-    block->la_advance_rate = 0;
-    block->la_scaling = 0;
-    #if ENABLED(ANKER_E_SMOOTH)
-	  block->la_segment.double_steps_per_s2 =  2 * planner.extruder_K_steps_per_s2;
-	#endif
-
-    if (block->use_advance_lead) {
-      block->advance_speed = (STEPPER_TIMER_RATE) / (extruder_advance_K[active_extruder] * block->e_D_ratio * block->acceleration * settings.axis_steps_per_mm[E_AXIS_N(extruder)]);
-      // the Bresenham algorithm will convert this step rate into extruder steps
-      block->la_advance_rate = extruder_advance_K[E_INDEX_N(extruder)] * block->acceleration_steps_per_s2;
-
-      // reduce LA ISR frequency by calling it only often enough to ensure that there will
-      // never be more than four extruder steps per call
-      for (uint32_t dividend = block->steps.e << 1; dividend <= (block->step_event_count >> 2); dividend <<= 1)
-        block->la_scaling++;
-
-      #if ENABLED(LA_DEBUG)
-        if (block->la_advance_rate >> block->la_scaling > 10000)
-          MYSERIAL2.printLine("eISR running at > 10kHz: %d\r\n", block->la_advance_rate);
+    if (block->la_version < LIN_ADV_VERSION_2) {
+      if (block->use_advance_lead)
+        block->advance_speed = (STEPPER_TIMER_RATE) / (extruder_advance_K[active_extruder] * plan.e_D_ratio * plan.acceleration * settings.axis_steps_per_mm[E_AXIS_N(extruder)]);
+    }
+    else {
+      block->la_advance_rate = 0;
+      block->la_scaling = 0;
+      #if ENABLED(ANKER_E_SMOOTH)
+        block->la_segment.double_steps_per_s2 =  2 * planner.extruder_K_steps_per_s2;
       #endif
+
+      if (block->use_advance_lead) {
+        // the Bresenham algorithm will convert this step rate into extruder steps
+        block->la_advance_rate = extruder_advance_K[E_INDEX_N(extruder)] * block->acceleration_steps_per_s2;
+
+        // reduce LA ISR frequency by calling it only often enough to ensure that there will
+        // never be more than four extruder steps per call
+        for (uint32_t dividend = block->steps.e << 1; dividend <= (block->step_event_count >> 2); dividend <<= 1)
+          block->la_scaling++;
+
+        #if ENABLED(LA_DEBUG)
+          if (block->la_advance_rate >> block->la_scaling > 10000)
+            MYSERIAL2.printLine("eISR running at > 10kHz: %d\r\n", block->la_advance_rate);
+        #endif
+      }
     }
   #endif
 
@@ -2921,7 +3065,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
         xyze_float_t junction_unit_vec = unit_vec - prev_unit_vec;
         normalize_junction_vector(junction_unit_vec);
 
-        const float junction_acceleration = limit_value_by_axis_maximum(block->acceleration, junction_unit_vec),
+        const float junction_acceleration = limit_value_by_axis_maximum(plan.acceleration, junction_unit_vec),
                     sin_theta_d2 = SQRT(0.5f * (1.0f - junction_cos_theta)); // Trig half angle identity. Always positive.
 
         vmax_junction_sqr = junction_acceleration * junction_deviation_mm * sin_theta_d2 / (1.0f - sin_theta_d2);
@@ -2929,7 +3073,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
         #if ENABLED(JD_HANDLE_SMALL_SEGMENTS)
 
           // For small moves with >135° junction (octagon) find speed for approximate arc
-          if (block->millimeters < 1 && junction_cos_theta < -0.7071067812f) {
+          if (plan.millimeters < 1 && junction_cos_theta < -0.7071067812f) {
 
             #if ENABLED(JD_USE_MATH_ACOS)
 
@@ -3008,7 +3152,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
             #endif
 
-            const float limit_sqr = (block->millimeters * junction_acceleration) / junction_theta;
+            const float limit_sqr = (plan.millimeters * junction_acceleration) / junction_theta;
             NOMORE(vmax_junction_sqr, limit_sqr);
           }
 
@@ -3016,7 +3160,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
       }
 
       // Get the lowest speed
-      vmax_junction_sqr = _MIN(vmax_junction_sqr, block->nominal_speed_sqr, previous_nominal_speed_sqr);
+      vmax_junction_sqr = _MIN(vmax_junction_sqr, plan.nominal_speed_sqr, previous_nominal_speed_sqr);
     }
     else // Init entry speed to zero. Assume it starts from rest. Planner will correct this later.
       vmax_junction_sqr = 0;
@@ -3039,7 +3183,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
      * Adapted from Průša MKS firmware
      * https://github.com/prusa3d/Prusa-Firmware
      */
-    CACHED_SQRT(nominal_speed, block->nominal_speed_sqr);
+    CACHED_SQRT(nominal_speed, plan.nominal_speed_sqr);
 
     // Exit speed limited by a jerk to full halt of a previous last segment
     static float previous_safe_speed;
@@ -3135,8 +3279,10 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
 
   #endif // Classic Jerk Limiting
 
-  #if ENABLED(ANKER_CORNER_CALC)
-    #define HAS_MINI_LINE() (WITHIN(block->millimeters, 0.15, CD_MAXIMUM_RESOLUTION)&&\
+  #if ENABLED(ANKER_VELOCITY_PROFILE)
+    vmax_junction_sqr = path_junction_limit(block, moves_queued, target, vmax_junction_sqr);
+  #elif ENABLED(ANKER_CORNER_CALC)
+    #define HAS_MINI_LINE() (WITHIN(plan.millimeters, 0.15, CD_MAXIMUM_RESOLUTION)&&\
                                   WITHIN(corner.pre_millimeters, 0.15, CD_MAXIMUM_RESOLUTION))
     const float acc_arc = (esteps ? settings.acceleration : settings.travel_acceleration);  // (mm/s^2)
     // const float corner_vmax1_sqr = acc_arc * ABS(corner.radius[CURVITY_2LINE]);
@@ -3145,18 +3291,18 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
       // MYSERIAL1.printLine("debug= %s Z%3.3f %3.3f %3.3f %3.3f %3.2f %3.2f %3.2f\r\n", parser.command_ptr, target_float.z, corner.cos_theta[CUR_LINE],corner.radius[CURVITY_2LINE],corner.radius[CURVITY_3LINE],SQRT(corner_vmax1_sqr), SQRT(corner_vmax2_sqr), SQRT(vmax_junction_sqr));
       NOMORE(vmax_junction_sqr, corner_vmax2_sqr);
     }
-    corner.pre_millimeters = block->millimeters;
+    corner.pre_millimeters = plan.millimeters;
   #endif
 
   // Max entry speed of this block equals the max exit speed of the previous block.
-  block->max_entry_speed_sqr = vmax_junction_sqr;
+  plan.max_entry_speed_sqr = vmax_junction_sqr;
 
   // Initialize block entry speed. Compute based on deceleration to user-defined MINIMUM_PLANNER_SPEED.
-  const float v_allowable_sqr = max_allowable_speed_sqr(-block->acceleration, sq(float(MINIMUM_PLANNER_SPEED)), block->millimeters);
+  const float v_allowable_sqr = max_allowable_speed_sqr(-plan.acceleration, sq(float(MINIMUM_PLANNER_SPEED)), plan.millimeters);
 
   // If we are trying to add a split block, start with the
   // max. allowed speed to avoid an interrupted first move.
-  block->entry_speed_sqr = !split_move ? sq(float(MINIMUM_PLANNER_SPEED)) : _MIN(vmax_junction_sqr, v_allowable_sqr);
+  plan.entry_speed_sqr = !split_move ? sq(float(MINIMUM_PLANNER_SPEED)) : _MIN(vmax_junction_sqr, v_allowable_sqr);
 
   // Initialize planner efficiency flags
   // Set flag if block will always reach maximum junction speed regardless of entry/exit speeds.
@@ -3166,11 +3312,11 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   // block nominal speed limits both the current and next maximum junction speeds. Hence, in both
   // the reverse and forward planners, the corresponding block junction speed will always be at the
   // the maximum junction speed and may always be ignored for any speed reduction checks.
-  block->flag |= block->nominal_speed_sqr <= v_allowable_sqr ? BLOCK_FLAG_RECALCULATE | BLOCK_FLAG_NOMINAL_LENGTH : BLOCK_FLAG_RECALCULATE;
+  block->flag |= plan.nominal_speed_sqr <= v_allowable_sqr ? BLOCK_FLAG_RECALCULATE | BLOCK_FLAG_NOMINAL_LENGTH : BLOCK_FLAG_RECALCULATE;
 
   // Update previous path unit_vector and nominal speed
   previous_speed = current_speed;
-  previous_nominal_speed_sqr = block->nominal_speed_sqr;
+  previous_nominal_speed_sqr = plan.nominal_speed_sqr;
 
   position = target;  // Update the position
 
@@ -3203,6 +3349,10 @@ void Planner::buffer_sync_block(TERN_(LASER_SYNCHRONOUS_M106_M107, uint8_t sync_
 
   block->position = position;
 
+  #if ENABLED(ANKER_VELOCITY_PROFILE)
+    plan_of(block).on_path = plan_of(block).joined = plan_of(block).provisional = false;
+  #endif
+
   #if BOTH(HAS_FAN, LASER_SYNCHRONOUS_M106_M107)
     FANS_LOOP(i) block->fan_speed[i] = thermalManager.fan_speed[i];
   #endif
@@ -3408,8 +3558,17 @@ bool Planner::buffer_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s, cons
     uint8_t next_buffer_head;
     block_t * const block = get_next_free_block(next_buffer_head);
 
+    // Clear block, nothing of its last use may reach the stepper: no steps for the shaping
+    // or the Bresenham, no advance. LIN_ADV_VERSION_2 puts the E steps of the page in the pulse phase.
+    memset(block, 0, sizeof(block_t));
+    TERN_(LIN_ADVANCE, block->la_version = LIN_ADV_VERSION_2);
+
     block->flag = BLOCK_FLAG_IS_PAGE;
 
+    #if ENABLED(ANKER_VELOCITY_PROFILE)
+      plan_of(block).on_path = plan_of(block).joined = plan_of(block).provisional = false;
+    #endif
+
     #if HAS_FAN
       FANS_LOOP(i) block->fan_speed[i] = thermalManager.fan_speed[i];
     #endif
@@ -3450,6 +3609,9 @@ bool Planner::buffer_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s, cons
     // Move buffer head
     block_buffer_head = next_buffer_head;
 
+    // A page is not planned, the planner passes stop at it
+    block_buffer_planned = block_buffer_head;
+
     enable_all_steppers();
     stepper.wake_up();
   }
@@ -3646,7 +3808,7 @@ void Planner::set_max_feedrate(const uint8_t axis, float inMaxFeedrateMMS) {
   #endif
 #endif
 
-#if HAS_WIRED_LCD
+#if HAS_BLOCK_BUFFER_RUNTIME
 
   uint16_t Planner::block_buffer_runtime() {
     #ifdef __AVR__
@@ -43,6 +43,11 @@
   #define JD_USE_LOOKUP_TABLE
 #endif
 
+// Motion time queued in the planner, for the LCD and the host flow control
+#if EITHER(HAS_WIRED_LCD, ANKER_FLOW_CTRL)
+  #define HAS_BLOCK_BUFFER_RUNTIME 1
+#endif
+
 #include "motion.h"
 #include "../gcode/queue.h"
 
@@ -77,6 +82,10 @@
   #include "../feature/anker/anker_m_cmdbuf.h"
 #endif
 
+#if ENABLED(PHOTO_Z_LAYER)
+  #include "../feature/anker/anker_block_event.h"
+#endif
+
 
 // Feedrate for manual moves
 #ifdef MANUAL_FEEDRATE
@@ -199,23 +208,15 @@ enum BlockFlag : char {
  *
  * The "nominal" values are as-specified by gcode, and
  * may never actually be reached due to acceleration limits.
+ *
+ * Only what the Stepper ISR reads is kept here, the fields it steps with
+ * first. Data used by the planner alone lives in block_plan_t.
  */
 typedef struct block_t {
 
   volatile uint8_t flag;                    // Block flags (See BlockFlag enum above) - Modified by ISR and main thread!
 
-  // Fields used by the motion planner to manage acceleration
-  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
-        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
-        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
-        millimeters,                        // The total travel of this block in mm
-        acceleration;                       // acceleration mm/sec^2
-
-  union {
-    abce_ulong_t steps;                     // Step count along each axis
-    abce_long_t position;                   // New position to force when this sync block is executed
-  };
-  uint32_t step_event_count;                // The number of step events required to complete this block
+  uint8_t direction_bits;                   // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
 
   #if HAS_MULTI_EXTRUDER
     uint8_t extruder;                       // The extruder to move (if E move)
@@ -223,14 +224,25 @@ typedef struct block_t {
     static constexpr uint8_t extruder = 0;
   #endif
 
-  #if ENABLED(MIXING_EXTRUDER)
-    mixer_comp_t b_color[MIXING_STEPPERS];  // Normalized color for the mixing steppers
+  #if ENABLED(LIN_ADVANCE)
+    uint8_t la_version;                     // LIN_ADV_VERSION_* the block was planned for, selects the ISR kernel
   #endif
 
+  union {
+    abce_ulong_t steps;                     // Step count along each axis
+    abce_long_t position;                   // New position to force when this sync block is executed
+  };
+  uint32_t step_event_count;                // The number of step events required to complete this block
+
   // Settings for the trapezoid generator
   uint32_t accelerate_until,                // The index of the step event on which to stop acceleration
            decelerate_after;                // The index of the step event on which to start decelerating
 
+  uint32_t nominal_rate,                    // The nominal step rate for this block in step_events/sec
+           initial_rate,                    // The jerk-adjusted step rate at start of block
+           final_rate,                      // The minimal rate at exit
+           acceleration_steps_per_s2;       // acceleration steps/sec^2
+
   #if ENABLED(S_CURVE_ACCELERATION)
     uint32_t cruise_rate,                   // The actual cruise rate to use, between end of the acceleration phase and start of deceleration phase
              acceleration_time,             // Acceleration time and deceleration time in STEP timer counts
@@ -242,30 +254,30 @@ typedef struct block_t {
     uint32_t acceleration_rate;             // The acceleration rate used for acceleration calculation
   #endif
 
-  uint8_t direction_bits;                   // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
-
-  // Advance extrusion
+  // Advance extrusion, only the generation in la_version is filled in
   #if ENABLED(LIN_ADVANCE)
-   // version 0
     bool use_advance_lead;
-    uint16_t advance_speed,                 // STEP timer value for extruder speed offset ISR
-             max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
-             final_adv_steps;               // advance steps due to exit speed
-    float e_D_ratio;
-    // version 1
-    uint32_t la_advance_rate;               // The rate at which steps are added whilst accelerating
-    uint8_t  la_scaling;                    // Scale ISR frequency down and step frequency up by 2 ^ la_scaling
-    uint16_t max_adv_steps_v1,                 // Max advance steps to get cruising speed pressure
-             final_adv_steps_v1;               // Advance steps for exit speed pressure
-    #if ENABLED(ANKER_E_SMOOTH)
-     la_block_bits_t la_segment;
-    #endif
+    union {
+      struct {                              // LIN_ADV_VERSION_0/1
+        uint16_t advance_speed,             // STEP timer value for extruder speed offset ISR
+                 max_adv_steps,             // max. advance steps to get cruising speed pressure (not always nominal_speed!)
+                 final_adv_steps;           // advance steps due to exit speed
+      };
+      struct {                              // LIN_ADV_VERSION_2/3
+        uint32_t la_advance_rate;           // The rate at which steps are added whilst accelerating
+        uint8_t  la_scaling;                // Scale ISR frequency down and step frequency up by 2 ^ la_scaling
+        uint16_t max_adv_steps_v1,          // Max advance steps to get cruising speed pressure
+                 final_adv_steps_v1;        // Advance steps for exit speed pressure
+        #if ENABLED(ANKER_E_SMOOTH)
+          la_block_bits_t la_segment;
+        #endif
+      };
+    };
   #endif
 
-  uint32_t nominal_rate,                    // The nominal step rate for this block in step_events/sec
-           initial_rate,                    // The jerk-adjusted step rate at start of block
-           final_rate,                      // The minimal rate at exit
-           acceleration_steps_per_s2;       // acceleration steps/sec^2
+  #if ENABLED(MIXING_EXTRUDER)
+    mixer_comp_t b_color[MIXING_STEPPERS];  // Normalized color for the mixing steppers
+  #endif
 
   #if ENABLED(DIRECT_STEPPING)
     page_idx_t page_idx;                    // Page index used for direct stepping
@@ -283,7 +295,7 @@ typedef struct block_t {
     uint8_t valve_pressure, e_to_p_pressure;
   #endif
 
-  #if HAS_WIRED_LCD
+  #if HAS_BLOCK_BUFFER_RUNTIME
     uint32_t segment_time_us;
   #endif
 
@@ -295,17 +307,38 @@ typedef struct block_t {
     block_laser_t laser;
   #endif
   #if ENABLED(PHOTO_Z_LAYER)
-    //begin add by jason.wu for detect layer change to notify remote controller capture
-    int8_t layer_change_flag;
-    float layer_num;
-    xyze_pos_t target_layer_start_pos;
-    //end add by jason.wu for detect layer change to notify remote controller capture
+    uint8_t event_id;                     // Anker_Block_Event table slot, BLOCK_EVENT_NONE if none
   #endif
   #if ENABLED(ANKER_STARTUP_SPEED_ERR)
     AxisEnum axis_maximum_count;
   #endif
 } block_t;
 
+/**
+ * struct block_plan_t
+ *
+ * Look-ahead data of a block_t, in a parallel array.
+ * The Stepper ISR never touches it, see Planner::plan_of().
+ */
+typedef struct {
+  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
+        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
+        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
+        millimeters,                        // The total travel of this block in mm
+        acceleration;                       // acceleration mm/sec^2
+  #if ENABLED(LIN_ADVANCE)
+    float e_D_ratio;
+  #endif
+  #if ENABLED(ANKER_VELOCITY_PROFILE)
+    xy_float_t start, end;                  // XY line of the block in mm
+    float turn_cos,                         // Cosine of the direction change at the entry junction, 1 = straight on
+          junction_max_sqr;                 // Entry speed limit before the path curvature limit
+    bool on_path,                           // XY move without Z
+         joined,                            // Continues the previous XY move, the entry junction is on the path
+         provisional;                       // The curvature limit waits for more of the path ahead
+  #endif
+} block_plan_t;
+
 #if ANY(LIN_ADVANCE, SCARA_FEEDRATE_SCALING, GRADIENT_MIX, LCD_SHOW_E_TOTAL)
   #define HAS_POSITION_FLOAT 1
 #endif
@@ -350,6 +383,12 @@ typedef struct {
 }  corner_calculation_t;
 #endif
 
+#if ENABLED(ANKER_VELOCITY_PROFILE)
+  #define VP_ARM_SEGMENTS 8       // Lines on either side of a junction for the curvature fit
+  #define VP_ARM_MM       3.0f    // Path length on either side of a junction for the curvature fit
+  #define VP_CORNER_COS   0.819152f // A turn over 35deg is a corner, junction deviation handles it
+#endif
+
 #if ENABLED(ANKER_VIBRATION_CONTROL)
 typedef struct {
   #define VC_CLOSED   0
@@ -426,6 +465,7 @@ class Planner {
      *  Reader of tail is Stepper::isr(). Always consider tail busy / read-only
      */
     static block_t block_buffer[BLOCK_BUFFER_SIZE];
+    static block_plan_t block_plan[BLOCK_BUFFER_SIZE];
     static volatile uint8_t block_buffer_head,      // Index of the next block to be pushed
                             block_buffer_nonbusy,   // Index of the first non busy block
                             block_buffer_planned,   // Index of the optimally planned block
@@ -575,7 +615,7 @@ class Planner {
       static last_move_t g_uc_extruder_last_move[E_STEPPERS];
     #endif
 
-    #if HAS_WIRED_LCD
+    #if HAS_BLOCK_BUFFER_RUNTIME
       volatile static uint32_t block_buffer_runtime_us; // Theoretical block buffer runtime in µs
     #endif
 
@@ -695,10 +735,11 @@ class Planner {
        */
 
       #if ENABLED(ANKER_LEVEING_FADE)
+        #define LEVELING_FADE_HOLD_Z 0.4 // (mm) Full leveling up to here
         //The first 0.2mm leveling decay value is 1, and the 0.2 to 1mm is gradually decreasing
         static inline float fade_scaling_factor_for_z(const_float_t rz) {
           static float z_fade_factor = 1;
-          if (!z_fade_height || rz <= (0.4)) return 1;
+          if (!z_fade_height || rz <= (LEVELING_FADE_HOLD_Z)) return 1;
           if (rz >= z_fade_height) return 0;
           if (last_fade_z != rz) {
             last_fade_z = rz;
@@ -810,7 +851,13 @@ class Planner {
     FORCE_INLINE static uint8_t nonbusy_movesplanned() { return BLOCK_MOD(block_buffer_head - block_buffer_nonbusy); }
 
     // Remove all blocks from the buffer
-    FORCE_INLINE static void clear_block_buffer() { block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail = 0; }
+    FORCE_INLINE static void clear_block_buffer() {
+      block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail = 0;
+      TERN_(PHOTO_Z_LAYER, block_event.discard());
+    }
+
+    // Look-ahead data of a block in block_buffer
+    FORCE_INLINE static block_plan_t& plan_of(const block_t * const block) { return block_plan[block - block_buffer]; }
 
     // Check if movement queue is full
     FORCE_INLINE static bool is_full() { return block_buffer_tail == next_block_index(block_buffer_head); }
@@ -1036,7 +1083,7 @@ class Planner {
         block_buffer_tail = next_block_index(block_buffer_tail);
     }
 
-    #if HAS_WIRED_LCD
+    #if HAS_BLOCK_BUFFER_RUNTIME
       static uint16_t block_buffer_runtime();
       static void clear_block_buffer_runtime();
     #endif
@@ -1115,6 +1162,8 @@ class Planner {
     #endif
 
     static void calculate_trapezoid_for_block(block_t * const block, const_float_t entry_factor, const_float_t exit_factor);
+    template<bool LA_V1>
+    static void calculate_trapezoid_kernel(block_t * const block, const_float_t entry_factor, const_float_t exit_factor);
 
     static void reverse_pass_kernel(block_t * const current, const block_t * const next);
     static void forward_pass_kernel(const block_t * const previous, block_t * const current, uint8_t block_index);
@@ -1146,6 +1195,12 @@ class Planner {
       }
 
     #endif // !CLASSIC_JERK
+    #if ENABLED(ANKER_VELOCITY_PROFILE)
+      static xy_float_t path_arm_back(uint8_t k);
+      static bool path_arm_ahead(uint8_t k, const uint8_t head, xy_float_t &p);
+      static float path_junction_limit(block_t * const block, const uint8_t moves_queued, const abce_long_t &target, const_float_t vmax_junction_sqr);
+      static void refine_junctions();
+    #endif
     #if ENABLED(ANKER_CORNER_CALC)
       static void costheta_calc(const uint8_t moves_queued, const abce_long_t target, const abce_float_t steps_dist_mm, const uint32_t esteps, const float inverse_millimeters);
     #endif
@@ -92,6 +92,14 @@
 #include "../feature/interactive/uart_nozzle_tx.h"
 #endif
 
+#if ENABLED(ANKER_PROBE_CAPTURE)
+  #include "../feature/anker/anker_probe_capture.h"
+  // Z of the last probe trigger, between the steps around the edge
+  #define PROBED_Z() probe_capture.trigger_z(current_position.z)
+#else
+  #define PROBED_Z() current_position.z
+#endif
+
 #if ENABLED(ANKER_PROBE_DETECT_TIMES)
   xy_pos_t M3032_Get_move_away(uint8_t position);
 #endif
@@ -100,6 +108,12 @@ Probe probe;
 
 xyz_pos_t Probe::offset; // Initialized by settings.load()
 
+#if ENABLED(ANKER_PROBE_ADAPTIVE)
+  uint8_t Probe::samples, Probe::agree;
+  float Probe::std_error;
+  bool Probe::flagged;
+#endif
+
 #if HAS_PROBE_XY_OFFSET
   const xy_pos_t &Probe::offset_xy = Probe::offset;
 #endif
@@ -730,6 +744,7 @@ bool Probe::probe_down_to_z(const_float_t z, const_feedRate_t fr_mm_s) {
   #endif
 
   // Move down until the probe is triggered
+  TERN_(ANKER_PROBE_CAPTURE, probe_capture.arm());
   do_blocking_move_to_z(z, fr_mm_s);
 
   // Check to see if the probe was triggered
@@ -778,6 +793,7 @@ bool Probe::probe_down_to_z(const_float_t z, const_feedRate_t fr_mm_s) {
 
   // Get Z where the steppers were interrupted
   set_current_from_steppers_for_axis(Z_AXIS);
+  TERN_(ANKER_PROBE_CAPTURE, probe_capture.finish(probe_triggered));
 
   // Tell the planner where we actually are
   sync_plan_position();
@@ -857,6 +873,39 @@ void insertion_sort(float arr[], int16_t len){
   }
 }
 
+#if ENABLED(ANKER_PROBE_ADAPTIVE)
+/**
+ * @brief  Do the probe samples agree? The ones within PROBE_ADAPT_TOL / 2 of the median agree.
+ * @param  s samples
+ * @param  n number of samples
+ * @param  z mean of the agreeing samples, the median if fewer than 2 agree
+ * @param  m number of agreeing samples
+ * @param  se standard error of z, the whole spread if fewer than 2 agree
+ * @retval true if 2 or more samples, and more than half of them, agree
+ */
+static bool probe_samples_agree(const float s[], const uint8_t n, float &z, uint8_t &m, float &se) {
+  float v[PROBE_ADAPT_MAX];
+  LOOP_L_N(i, n) v[i] = s[i];
+  insertion_sort(v, n);
+  const float med = (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) * 0.5f;
+
+  float sum = 0;
+  m = 0;
+  LOOP_L_N(i, n) if (ABS(v[i] - med) <= PROBE_ADAPT_TOL * 0.5f) { sum += v[i]; m++; }
+  if (m < 2) {
+    z = med;
+    se = v[n - 1] - v[0];
+    return false;
+  }
+
+  z = sum / m;
+  float var = 0;
+  LOOP_L_N(i, n) if (ABS(v[i] - med) <= PROBE_ADAPT_TOL * 0.5f) var += sq(v[i] - z);
+  se = SQRT(var / (m - 1) / m);
+  return 2 * m > n;
+}
+#endif
+
 #endif
 /**
  * @brief Probe at the current XY (possibly more than once) to find the bed Z.
@@ -869,6 +918,8 @@ void insertion_sort(float arr[], int16_t len){
 float Probe::run_z_probe(const bool sanity_check/*=true*/) {
   DEBUG_SECTION(log_probe, "Probe::run_z_probe", DEBUGGING(LEVELING));
 
+  TERN_(ANKER_PROBE_ADAPTIVE, flagged = false);
+
   auto try_to_probe = [&](PGM_P const plbl, const_float_t z_probe_low_point, const feedRate_t fr_mm_s, const bool scheck, const float clearance) -> bool {
     // Tare the probe, if supported
     if (TERN0(PROBE_TARE, tare())) return true;
@@ -909,9 +960,9 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
                      sanity_check, Z_CLEARANCE_BETWEEN_PROBES) ) return NAN;
     
     #if ENABLED(ANKER_PROBE_DETECT_TIMES)
-      float first_probe_z = current_position.z;
+      float first_probe_z = PROBED_Z();
     #else
-      const float first_probe_z = current_position.z;
+      const float first_probe_z = PROBED_Z();
     #endif
 
     if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPAIR("1st Probe Z:", first_probe_z);
@@ -954,7 +1005,40 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
       if (TERN0(PROBE_TARE, tare())) return true;
       
       // Probe downward slowly to find the bed
-      #if ENABLED(ANKER_PROBE_DETECT_TIMES)
+      #if ENABLED(ANKER_PROBE_ADAPTIVE)
+
+        // One slow touch at a time until most of them agree. The fast approach only gates: a first
+        // slow touch close to it is the result as it is, its trigger latency is never averaged in.
+        float probe_z[PROBE_ADAPT_MAX - 1], z_agree;
+        samples = 0;
+        for (;;) {
+          TERN_(ANKER_PROBE_SET, anker_probe_set.probe_start(anker_probe_set.leveing_value));
+          if (try_to_probe(PSTR("SLOW"), z_probe_low_point, MMM_TO_MMS(Z_PROBE_FEEDRATE_SLOW),
+                          sanity_check, Z_CLEARANCE_MULTI_PROBE) ) return NAN;
+          probe_z[samples++] = PROBED_Z();
+          if (samples == 1) {
+            z_agree = probe_z[0];
+            agree = 1;
+            std_error = ABS(probe_z[0] - first_probe_z);
+            flagged = std_error > PROBE_ADAPT_TOL;
+          }
+          else
+            flagged = !probe_samples_agree(probe_z, samples, z_agree, agree, std_error);
+          if (!flagged || samples >= PROBE_ADAPT_MAX - 1) break;
+
+          // Off the spot for the next touch, a blob under the nozzle stays behind
+          do_blocking_move_to_z(current_position.z + Z_CLEARANCE_MULTI_PROBE, MMM_TO_MMS(HOMING_RISE_SPEED));
+          const xy_pos_t move_away = M3032_Get_move_away(samples - 1),
+                         dest = { current_position.x + move_away.x, current_position.y + move_away.y };
+          do_blocking_move_to_xy(dest, MMM_TO_MMS(HOMING_RISE_SPEED));
+        }
+        MYSERIAL2.printLine("echo:probe samples:%d agree:%d z:%3.5f se:%3.5f%s\r\n",
+                            samples, agree, z_agree, std_error, flagged ? " flagged" : "");
+
+        if (anker_probe_set.point_test_flag) anker_probe_set.point_test_idle();
+        return z_agree;
+
+      #elif ENABLED(ANKER_PROBE_DETECT_TIMES)
 
         //#define Z_PROBE_DETECTION_DEVIATION 0.06f  // Acceptable deviation between detections
         uint8_t insert_count = 0;
@@ -968,7 +1052,7 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
 
             if (try_to_probe(PSTR("SLOW"), z_probe_low_point, MMM_TO_MMS(Z_PROBE_FEEDRATE_SLOW),
                             sanity_check, Z_CLEARANCE_MULTI_PROBE) ) return NAN;
-            const float second_probe_z = current_position.z;
+            const float second_probe_z = PROBED_Z();
             MYSERIAL2.printLine("echo: num:%d Probe Z:%3.5f %3.5f diff:%3.5f\r\n", insert_count, first_probe_z, second_probe_z, (first_probe_z - second_probe_z));
             insert_count++;
             buff_insert[insert_count] = second_probe_z;
@@ -989,7 +1073,7 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
             // Do a first probe at the fast speed
             if (try_to_probe(PSTR("FAST"), z_probe_low_point, z_probe_fast_mm_s,
                      sanity_check, Z_CLEARANCE_BETWEEN_PROBES) ) return NAN;
-            first_probe_z = current_position.z;
+            first_probe_z = PROBED_Z();
             insert_count++;
             buff_insert[insert_count] = first_probe_z;
             do_blocking_move_to_z(current_position.z + Z_CLEARANCE_MULTI_PROBE, MMM_TO_MMS(HOMING_RISE_SPEED));
@@ -1033,7 +1117,7 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
 
       TERN_(MEASURE_BACKLASH_WHEN_PROBING, backlash.measure_with_probe());
 
-      const float z = current_position.z;
+      const float z = PROBED_Z();
 
       #if EXTRA_PROBING > 0
         // Insert Z measurement into probes[]. Keep it sorted ascending.
@@ -1084,7 +1168,7 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
 
   #elif TOTAL_PROBING == 2
 
-    const float z2 = current_position.z;
+    const float z2 = PROBED_Z();
 
     if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPAIR("2nd Probe Z:", z2, " Discrepancy:", first_probe_z - z2);
     
@@ -1099,7 +1183,7 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
   #else
 
     // Return the single probe result
-    const float measured_z = current_position.z;
+    const float measured_z = PROBED_Z();
 
   #endif
   return measured_z;
@@ -1240,6 +1324,84 @@ float Probe::probe_at_point(const_float_t rx, const_float_t ry, const ProbePtRai
 
   return measured_z;
 }
+
+#if ENABLED(ANKER_FLYING_MESH)
+/**
+ * @brief Probe one point of a continuous mesh pass
+ *
+ * @details - Queue the hop to the given XY behind the raise of the previous point
+ *          - Arm the nozzle board while the hop runs, then wait for motion and arm
+ *          - One touch at the slow touch speed of run_z_probe, measured with PROBED_Z()
+ *          - Queue the raise and return without waiting for it
+ *          One trigger per point, against the fast approach, re-arm, rise and slow touch of
+ *          probe_at_point(). Without a second touch nothing here can flag the point: G29 checks it
+ *          against the points before it instead. The board settles during travel. The caller must
+ *          synchronize after the last point.
+ *
+ * @return The probed Z position or NAN on error.
+ */
+float Probe::probe_at_point_flying(const xy_pos_t &pos, const bool sanity_check/*=true*/) {
+  DEBUG_SECTION(log_probe, "Probe::probe_at_point_flying", DEBUGGING(LEVELING));
+
+  TERN_(ANKER_PROBE_ADAPTIVE, flagged = false);
+
+  float measured_z = NAN;
+  if (can_reach(pos)) {
+    current_position.set(pos.x - offset_xy.x, pos.y - offset_xy.y);
+    line_to_current_position(feedRate_t(XY_PROBE_FEEDRATE_MM_S));
+
+    TERN_(ANKER_PROBE_SET, anker_probe_set.probe_arm(anker_probe_set.leveing_value));
+    planner.synchronize();
+    TERN_(ANKER_PROBE_SET, anker_probe_set.probe_wait_armed());
+
+    const float z_probe_low_point = axis_is_trusted(Z_AXIS) ? -offset.z + Z_PROBE_LOW_POINT : -10.0;
+    auto touch = [&](const feedRate_t fr_mm_s, const float clearance) -> bool {
+      return !probe_down_to_z(z_probe_low_point, fr_mm_s)
+          && !(sanity_check && current_position.z > -offset.z + clearance);
+    };
+
+    // The trigger speed of the points run_z_probe measures, so a flying Z matches a re-probed one
+    if (!deploy() && touch(MMM_TO_MMS(Z_PROBE_FEEDRATE_SLOW), Z_CLEARANCE_BETWEEN_PROBES)) {
+      measured_z = PROBED_Z() + offset.z;
+      #if ENABLED(ANKER_PROBE_ADAPTIVE)
+        samples = agree = 1;
+        std_error = 0;
+      #endif
+      TERN_(ANKER_PROBE_SET, if (anker_probe_set.point_test_flag) anker_probe_set.point_test_idle());
+    }
+
+    if (!isnan(measured_z)) {
+      current_position.z += Z_CLEARANCE_BETWEEN_PROBES;
+      #if ENABLED(PROVE_CONTROL)|| ENABLED(ANKER_PROBE_SET)
+        line_to_current_position(MMM_TO_MMS(HOMING_RISE_SPEED));
+      #else
+        line_to_current_position(z_probe_fast_mm_s);
+      #endif
+    }
+  }
+  else if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPGM("Position Not Reachable");
+
+  if (isnan(measured_z) || ANKER_OVERPRESSURE_TRIGGER()) {
+    if (ANKER_OVERPRESSURE_TRIGGER()) {
+      ANKER_CLOSED_OVERPRESSURE_TRIGGER();
+      measured_z = NAN;
+    }
+
+    planner.synchronize();
+    stow();
+    LCD_MESSAGEPGM(MSG_LCD_PROBING_FAILED);
+    #if DISABLED(G29_RETRY_AND_RECOVER)
+      #if ADAPT_DETACHED_NOZZLE
+      uart_nozzle_tx_notify_error();
+      #endif
+      SERIAL_ERROR_MSG(STR_ERR_PROBING_FAILED);
+    #endif
+  }
+
+  return measured_z;
+}
+#endif
+
 #if ENABLED(ANKER_Z_OFFSET_FUNC)
  #include "../feature/anker/anker_z_offset.h"
 float Probe::anker_z_ofset_probe_at_point(const_float_t rx, const_float_t ry, const ProbePtRaise raise_after/*=PROBE_PT_NONE*/, const uint8_t verbose_level/*=0*/, const bool probe_relative/*=true*/, const bool sanity_check/*=true*/,const bool cs1237_en) {
@@ -57,6 +57,15 @@
     extern bool anker_leve_pause;
 #endif
 
+#if ENABLED(ANKER_PROBE_ADAPTIVE)
+  #define PROBE_ADAPT_MAX 6                               // Touches per point, the fast approach included. It only gates the first slow one.
+  #ifdef Z_PROBE_DETECTION_DEVIATION
+    #define PROBE_ADAPT_TOL Z_PROBE_DETECTION_DEVIATION   // (mm) Two samples this close agree
+  #else
+    #define PROBE_ADAPT_TOL 0.05f
+  #endif
+#endif
+
 class Probe {
 public:
 
@@ -125,6 +134,17 @@ public:
       return probe_at_point(pos.x, pos.y, raise_after, verbose_level, probe_relative, sanity_check);
     }
 
+    #if ENABLED(ANKER_FLYING_MESH)
+      static float probe_at_point_flying(const xy_pos_t &pos, const bool sanity_check=true);
+    #endif
+
+    #if ENABLED(ANKER_PROBE_ADAPTIVE)
+      // The last run_z_probe
+      static uint8_t samples, agree;
+      static float std_error;             // (mm) Of the returned Z
+      static bool flagged;                // No slow touch agreed with the fast one, nor a majority of them with each other
+    #endif
+
     #if ENABLED(ANKER_Z_OFFSET_FUNC)
      static float anker_z_ofset_probe_at_point(const_float_t rx, const_float_t ry, const ProbePtRaise raise_after=PROBE_PT_NONE, const uint8_t verbose_level=0, const bool probe_relative=true, const bool sanity_check=true,const bool cs1237_en=true);
      static float anker_z_ofset_probe_at_point(const xy_pos_t &pos, const ProbePtRaise raise_after=PROBE_PT_NONE, const uint8_t verbose_level=0, const bool probe_relative=true, const bool sanity_check=true,const bool cs1237_en=true) {
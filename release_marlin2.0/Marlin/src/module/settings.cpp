@@ -36,7 +36,8 @@
  */
 
 // Change EEPROM version if the structure changes
-#define EEPROM_VERSION "V84"
+#define EEPROM_VERSION "V85"
+#define EEPROM_VERSION_V84 "V84" // V85 without the INPUT_SHAPING fields at the end, still loaded
 #define EEPROM_OFFSET 100
 
 // Check the integrity of data offsets.
@@ -174,6 +175,10 @@
   #include "../feature/anker/anker_z_offset.h" 
 #endif
 
+#if ENABLED(ANKER_TMC_POLL)
+  #include "../feature/anker/anker_tmc_poll.h"
+#endif
+
 #pragma pack(push, 1) // No padding between variables
 
 #if HAS_ETHERNET
@@ -542,6 +547,13 @@ typedef struct SettingsDataStruct {
     uint16_t anker_probe_set_leveing_value;   
   #endif
 
+  // Added in V85. Keep these last, a V84 image is this struct without them.
+  #if ENABLED(INPUT_SHAPING)
+    uint8_t shaping_type[XY];                           // M4897 X Y I
+    float shaping_frequency[XY];                        // M4897 X Y F
+    float shaping_zeta[XY];                             // M4897 X Y D
+  #endif
+
 } SettingsData;
 
 //static_assert(sizeof(SettingsData) <= MARLIN_EEPROM_SIZE, "EEPROM too small to contain SettingsData!");
@@ -1493,6 +1505,24 @@ void MarlinSettings::postprocess() {
       EEPROM_WRITE(anker_probe_set.leveing_value);     
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+    {
+      _FIELD_TEST(shaping_type);
+      uint8_t shaping_type[XY] = { SHAPER_NONE, SHAPER_NONE };
+      float shaping_frequency[XY] = { 0 }, shaping_zeta[XY] = { 0 };
+      LOOP_L_N(i, XY) {
+        const shaping_params_t * const sp = stepper.get_shaping(AxisEnum(i));
+        if (!sp) continue;
+        shaping_type[i] = sp->type;
+        shaping_frequency[i] = sp->frequency;
+        shaping_zeta[i] = sp->zeta;
+      }
+      EEPROM_WRITE(shaping_type);
+      EEPROM_WRITE(shaping_frequency);
+      EEPROM_WRITE(shaping_zeta);
+    }
+    #endif
+
     //
     // Report final CRC and Data Size
     //
@@ -1541,7 +1571,9 @@ void MarlinSettings::postprocess() {
     EEPROM_READ_ALWAYS(stored_crc);
 
     // Version has to match or defaults are used
-    if (strncmp(version, stored_ver, 3) != 0) {
+    // A V84 image only lacks the fields appended for V85, which get their defaults
+    const bool v84 = strncmp(EEPROM_VERSION_V84, stored_ver, 3) == 0;
+    if (!v84 && strncmp(version, stored_ver, 3) != 0) {
       if (stored_ver[3] != '\0') {
         stored_ver[0] = '?';
         stored_ver[1] = '\0';
@@ -2146,6 +2178,7 @@ void MarlinSettings::postprocess() {
             TERN_(Z2_SENSORLESS, stepperZ2.homing_threshold(tmc_sgt.Z2));
             TERN_(Z3_SENSORLESS, stepperZ3.homing_threshold(tmc_sgt.Z3));
             TERN_(Z4_SENSORLESS, stepperZ4.homing_threshold(tmc_sgt.Z4));
+            TERN_(ANKER_TMC_POLL, anker_tmc_poll.invalidate_all());
           }
         #endif
       }
@@ -2408,10 +2441,31 @@ void MarlinSettings::postprocess() {
         EEPROM_READ(anker_probe_set.homing_value);
         EEPROM_READ(anker_probe_set.leveing_value);     
       #endif
+
+      #if ENABLED(INPUT_SHAPING)
+      if (v84) {
+        if (!validating) {
+          TERN_(HAS_SHAPING_X, stepper.set_shaping(X_AXIS, SHAPING_TYPE_X, SHAPING_FREQ_X, SHAPING_ZETA_X));
+          TERN_(HAS_SHAPING_Y, stepper.set_shaping(Y_AXIS, SHAPING_TYPE_Y, SHAPING_FREQ_Y, SHAPING_ZETA_Y));
+        }
+      }
+      else {
+        _FIELD_TEST(shaping_type);
+        uint8_t shaping_type[XY];
+        float shaping_frequency[XY], shaping_zeta[XY];
+        EEPROM_READ(shaping_type);
+        EEPROM_READ(shaping_frequency);
+        EEPROM_READ(shaping_zeta);
+        if (!validating) LOOP_L_N(i, XY)
+          if (stepper.get_shaping(AxisEnum(i)))
+            stepper.set_shaping(AxisEnum(i), ShapingType(shaping_type[i]), shaping_frequency[i], shaping_zeta[i]);
+      }
+      #endif
       //
       // Validate Final Size and CRC
       //
-      eeprom_error = size_error(eeprom_index - (EEPROM_OFFSET));
+      constexpr uint16_t v85_size = TERN0(INPUT_SHAPING, sizeof(SettingsData) - offsetof(SettingsData, shaping_type));
+      eeprom_error = size_error(eeprom_index - (EEPROM_OFFSET) + (v84 ? v85_size : 0));
       if (eeprom_error) {
         DEBUG_ECHO_MSG("Index: ", eeprom_index - (EEPROM_OFFSET), " Size: ", datasize());
         IF_DISABLED(EEPROM_AUTO_INIT, ui.eeprom_alert_index());
@@ -3111,6 +3165,14 @@ void MarlinSettings::reset() {
   #if ENABLED(ANKER_PROBE_SET)
     anker_probe_set.reset_value();
   #endif
+
+  //
+  // Input Shaping
+  //
+  #if ENABLED(INPUT_SHAPING)
+    TERN_(HAS_SHAPING_X, stepper.set_shaping(X_AXIS, SHAPING_TYPE_X, SHAPING_FREQ_X, SHAPING_ZETA_X));
+    TERN_(HAS_SHAPING_Y, stepper.set_shaping(Y_AXIS, SHAPING_TYPE_Y, SHAPING_FREQ_Y, SHAPING_ZETA_Y));
+  #endif
 }
 
 #if DISABLED(DISABLE_M503)
@@ -4057,6 +4119,16 @@ void MarlinSettings::reset() {
     #if ENABLED(ANKER_PROBE_SET)
     anker_probe_set.report_value();
    #endif
+
+    #if ENABLED(INPUT_SHAPING)
+      CONFIG_ECHO_HEADING("Input Shaping:");
+      LOOP_L_N(i, XY) {
+        const shaping_params_t * const sp = stepper.get_shaping(AxisEnum(i));
+        if (!sp) continue;
+        CONFIG_ECHO_START();
+        SERIAL_ECHOLNPAIR("  M4897 ", AS_CHAR(axis_codes[i]), " I", int(sp->type), " F", sp->frequency, " D", sp->zeta);
+      }
+    #endif
   }
 
 #endif // !DISABLE_M503
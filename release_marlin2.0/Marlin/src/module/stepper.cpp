@@ -135,6 +135,20 @@ Stepper stepper; // Singleton
   #include "../feature/anker/anker_pause.h"
 #endif
 
+#include "../feature/anker/anker_isr_profile.h"
+
+#if ENABLED(ANKER_PROBE_CAPTURE)
+  #include "../feature/anker/anker_probe_capture.h"
+#endif
+
+#if ENABLED(ANKER_STEP_SCHED)
+  #include "../feature/anker/anker_step_sched.h"
+#endif
+
+#if ENABLED(ANKER_FLOW_CTRL)
+  #include "../feature/anker/anker_flow_ctrl.h"
+#endif
+
 #if ENABLED(ANKER_MAKE_API)
 typedef struct report_currentStatus_t {
     float nominal_speed_sqr; // (mm/sec)^2
@@ -185,6 +199,9 @@ bool Stepper::abort_current_block;
       #endif
     #endif
   ;
+  #if ENABLED(ANKER_ALIGN_LSQ)
+    uint32_t Stepper::z_lock_after[2];
+  #endif
 #endif
 
 uint32_t Stepper::acceleration_time, Stepper::deceleration_time;
@@ -227,27 +244,32 @@ uint32_t Stepper::advance_divisor = 0,
 #if ENABLED(LIN_ADVANCE)
   uint32_t Stepper::nextAdvanceISR = LA_ADV_NEVER;
   LA_version_tu Stepper::LA_ver = {.v0={LA_ADV_NEVER,0,0,0,0,false}, .v1={LA_ADV_NEVER,0,0,0,false,0}};
+  uint8_t Stepper::la_version = LIN_ADV_VERSION_0;
   #if ENABLED(ANKER_E_SMOOTH)
    la_stepper_bits_t Stepper::la_status;
   #endif
 #endif // LIN_ADVANCE
 
+void (*Stepper::pulse_phase_steps)(uint8_t) = &Stepper::pulse_phase_kernel<false>;
+
 
 #if ENABLED(INPUT_SHAPING)
   shaping_time_t DelayNowTimer::now = 0;
 #endif
 
 #if HAS_SHAPING_X
-  uint8_t                           Stepper::shaping_factor_x;
-  DelayQueue<SHAPING_BUFFER_X>      Stepper::shaping_queue_x;
-  ParamDelayQueue<SHAPING_SEGMENTS> Stepper::shaping_dividend_queue_x;
-  int32_t                           Stepper::shaping_dividend_x;
+  shaping_params_t                 Stepper::shaping_x;
+  bool                             Stepper::shaping_enqueue_x;
+  EchoQueue<SHAPING_BUFFER_X>      Stepper::shaping_queue_x;
+  EchoParamQueue<SHAPING_SEGMENTS> Stepper::shaping_dividend_queue_x;
+  int32_t                          Stepper::shaping_dividend_x[SHAPING_ECHOES];
 #endif
 #if HAS_SHAPING_Y
-  uint8_t                           Stepper::shaping_factor_y;
-  DelayQueue<SHAPING_BUFFER_Y>      Stepper::shaping_queue_y;
-  ParamDelayQueue<SHAPING_SEGMENTS> Stepper::shaping_dividend_queue_y;
-  int32_t                           Stepper::shaping_dividend_y;
+  shaping_params_t                 Stepper::shaping_y;
+  bool                             Stepper::shaping_enqueue_y;
+  EchoQueue<SHAPING_BUFFER_Y>      Stepper::shaping_queue_y;
+  EchoParamQueue<SHAPING_SEGMENTS> Stepper::shaping_dividend_queue_y;
+  int32_t                          Stepper::shaping_dividend_y[SHAPING_ECHOES];
 #endif
 
 #if ENABLED(INTEGRATED_BABYSTEPPING)
@@ -265,6 +287,12 @@ uint32_t Stepper::ticks_nominal = 0;
 
 xyz_long_t Stepper::endstops_trigsteps;
 xyze_long_t Stepper::count_position{0};
+
+#if ENABLED(ANKER_STEPPER_SNAPSHOT)
+  stepper_snapshot_t Stepper::snap[2];
+  volatile uint32_t Stepper::snap_seq;
+  uint32_t Stepper::snap_rate;
+#endif
 xyze_int8_t Stepper::count_direction{0};
 
 #if ENABLED(LASER_POWER_INLINE_TRAPEZOID)
@@ -497,20 +525,47 @@ xyze_int8_t Stepper::count_direction{0};
   #define DIR_WAIT_AFTER()
 #endif
 
-#if ENABLED(PHOTO_Z_LAYER)
-#include  "./src/gcode/parser.h"
-//begin add by jason.wu for detect layer change to notify remote controller capture
-static void z_axis_layer_change_notify(block_t* block_item)
-{
-  if(block_item->layer_change_flag != 0) {
-    parser.report_layer     = true;
-    parser.report_layer_num = block_item->layer_num;
-    parser.report_pos       = block_item->target_layer_start_pos;
-    block_item->layer_change_flag = 0;
-    memset(&block_item->target_layer_start_pos,0,sizeof(xyze_pos_t));
+#if ENABLED(ANKER_STEP_PORT_BATCH) && ENABLED(SQUARE_WAVE_STEPPING) && defined(ARDUINO_ARCH_STM32) \
+    && HAS_X_STEP && HAS_Y_STEP && HAS_E0_STEP && E_STEPPERS == 1 \
+    && NONE(X_DUAL_STEPPER_DRIVERS, Y_DUAL_STEPPER_DRIVERS, DUAL_X_CARRIAGE, MIXING_EXTRUDER, I2S_STEPPER_STREAM)
+  #define STEP_PORT_BATCH 1
+#endif
+
+#if STEP_PORT_BATCH
+  /**
+   * With square wave stepping a step is a toggle of the STEP pin. X, Y and E
+   * toggles are collected per tick into one word per GPIO port and written with
+   * a single ODR update each, instead of one read-modify-write per axis.
+   * Z keeps its own path because of the Z_MULTI_ENDSTOPS locking.
+   */
+  enum { SPB_X, SPB_Y, SPB_E, SPB_COUNT };
+  static struct {
+    GPIO_TypeDef *port[SPB_COUNT];  // Distinct ports, [0..ports)
+    uint8_t ports;
+    uint8_t slot[SPB_COUNT];        // Axis -> port slot
+    uint32_t mask[SPB_COUNT];       // Axis -> STEP pin bit
+  } step_port_batch;
+
+  static void step_port_batch_init() {
+    const pin_t pins[SPB_COUNT] = { X_STEP_PIN, Y_STEP_PIN, E0_STEP_PIN };
+    step_port_batch.ports = 0;
+    LOOP_L_N(a, SPB_COUNT) {
+      const PinName pn = digitalPinToPinName(pins[a]);
+      GPIO_TypeDef * const port = FastIOPortMap[STM_PORT(pn)];
+      uint8_t s = 0;
+      while (s < step_port_batch.ports && step_port_batch.port[s] != port) s++;
+      if (s == step_port_batch.ports) step_port_batch.port[step_port_batch.ports++] = port;
+      step_port_batch.slot[a] = s;
+      step_port_batch.mask[a] = _BV32(STM_PIN(pn));
+    }
   }
-}
-//end add by jason.wu for detect layer change to notify remote controller capture
+
+  #define STEP_BATCH_ADD(W, A, I) do{ \
+    if (step_needed[_AXIS(A)]) { \
+      count_position[_AXIS(A)] += count_direction[_AXIS(A)]; \
+      W[step_port_batch.slot[I]] |= step_port_batch.mask[I]; \
+    } \
+  }while(0)
 #endif
 
 #define SET_STEP_DIR(A)                       \
@@ -556,7 +611,7 @@ void Stepper::set_directions() {
     SET_STEP_DIR(K); // K
   #endif
 
-  if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+  if(la_version >= LIN_ADV_VERSION_2){
     #if ENABLED(MIXING_EXTRUDER)
        // Because this is valid for the whole block we don't know
        // what e-steppers will step. Likely all. Set all.
@@ -1431,6 +1486,8 @@ HAL_STEP_TIMER_ISR() {
 
 void Stepper::isr() {
   //WRITE(DEBUG_TP172,HIGH);
+  ISR_PROFILE(PROF_STEPPER_ISR);
+  TERN_(ANKER_STEP_SCHED, const uint32_t sched_start = DWT->CYCCNT);
   static uint32_t nextMainISR = 0;  // Interval until the next main Stepper Pulse phase (0 = Now)
 
   #ifndef __AVR__
@@ -1464,13 +1521,22 @@ void Stepper::isr() {
 
     if (!nextMainISR) pulse_phase_isr();                            // 0 = Do coordinated axes Stepper pulses
 
-    TERN_(HAS_SHAPING_X, if (!shaping_dividend_queue_x.peek()) shaping_dividend_x = shaping_dividend_queue_x.dequeue());
-    TERN_(HAS_SHAPING_Y, if (!shaping_dividend_queue_y.peek()) shaping_dividend_y = shaping_dividend_queue_y.dequeue());
-    TERN_(HAS_SHAPING_X, if (!shaping_queue_x.peek()) shaping_isr_x());
-    TERN_(HAS_SHAPING_Y, if (!shaping_queue_y.peek()) shaping_isr_y());
+    // Echo dividend changes first so an echo due on the same tick uses its own block's dividend
+    #define SHAPING_DIVIDEND_PHASE(A) \
+      LOOP_L_N(e, shaping_##A.echoes) \
+        if (!shaping_dividend_queue_##A.peek(e, shaping_##A.delay[e])) \
+          shaping_dividend_##A[e] = shaping_##A.factor[e] * (shaping_dividend_queue_##A.dequeue(e) >> 7)
+    #define SHAPING_ECHO_PHASE(A) \
+      LOOP_L_N(e, shaping_##A.echoes) \
+        if (!shaping_queue_##A.peek(e, shaping_##A.delay[e])) shaping_isr_##A(e)
+
+    TERN_(HAS_SHAPING_X, SHAPING_DIVIDEND_PHASE(x));
+    TERN_(HAS_SHAPING_Y, SHAPING_DIVIDEND_PHASE(y));
+    TERN_(HAS_SHAPING_X, SHAPING_ECHO_PHASE(x));
+    TERN_(HAS_SHAPING_Y, SHAPING_ECHO_PHASE(y));
 
     #if ENABLED(LIN_ADVANCE)
-    if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+    if(la_version >= LIN_ADV_VERSION_2){
       if (!nextAdvanceISR) {                            // 0 = Do Linear Advance E Stepper pulses
         v1_advance_isr();
         nextAdvanceISR = LA_ver.v1.la_interval;
@@ -1500,17 +1566,22 @@ void Stepper::isr() {
     #endif
 
     // Get the interval to the next ISR call
-    const uint32_t interval = _MIN(
+    TERN(INPUT_SHAPING, uint32_t, const uint32_t) interval = _MIN(
       uint32_t(HAL_TIMER_TYPE_MAX),                           // Come back in a very long time
       nextMainISR                                             // Time until the next Pulse / Block phase
-      OPTARG(HAS_SHAPING_X, shaping_dividend_queue_x.peek())  // Time until next input shaping dividend change for X
-      OPTARG(HAS_SHAPING_Y, shaping_dividend_queue_y.peek())  // Time until next input shaping dividend change for Y
-      OPTARG(HAS_SHAPING_X, shaping_queue_x.peek())           // Time until next input shaping echo for X
-      OPTARG(HAS_SHAPING_Y, shaping_queue_y.peek())           // Time until next input shaping echo for Y
       OPTARG(LIN_ADVANCE, nextAdvanceISR)                     // Come back early for Linear Advance?
       OPTARG(INTEGRATED_BABYSTEPPING, nextBabystepISR)        // Come back early for Babystepping?
     );
 
+    // Time until the next input shaping dividend change or echo
+    #define SHAPING_NEXT_EVENT(A) \
+      LOOP_L_N(e, shaping_##A.echoes) { \
+        NOMORE(interval, shaping_dividend_queue_##A.peek(e, shaping_##A.delay[e])); \
+        NOMORE(interval, shaping_queue_##A.peek(e, shaping_##A.delay[e])); \
+      }
+    TERN_(HAS_SHAPING_X, SHAPING_NEXT_EVENT(x));
+    TERN_(HAS_SHAPING_Y, SHAPING_NEXT_EVENT(y));
+
     //
     // Compute remaining time for each ISR phase
     //     NEVER : The phase is idle
@@ -1587,7 +1658,10 @@ void Stepper::isr() {
      * loop to 10 iterations. Beyond that, there's no way to ensure correct pulse
      * timing, since the MCU isn't fast enough.
      */
-    if (!--max_loops) next_isr_ticks = min_ticks;
+    if (!--max_loops) {
+      next_isr_ticks = min_ticks;
+      TERN_(ANKER_STEP_SCHED, step_sched.overruns++);
+    }
 
     // Advance pulses if not enough time to wait for the next ISR
   } while (next_isr_ticks < min_ticks);
@@ -1600,6 +1674,9 @@ void Stepper::isr() {
   //WRITE(DEBUG_TP172,LOW);
   // Don't forget to finally reenable interrupts
   ENABLE_ISRS();
+
+  TERN_(ANKER_STEPPER_SNAPSHOT, publish_snapshot());
+  TERN_(ANKER_STEP_SCHED, step_sched.isr_done(sched_start));
 }
 
 #if MINIMUM_STEPPER_PULSE || MAXIMUM_STEPPER_RATE
@@ -1617,18 +1694,19 @@ void Stepper::isr() {
  * is to keep pulse timing as regular as possible.
  */
 void Stepper::pulse_phase_isr() {
+  ISR_PROFILE(PROF_PULSE_PHASE);
 
   // If we must abort the current block, do so!
   if (abort_current_block) {
     abort_current_block = false;
     if (current_block) {
       discard_current_block();
-      TERN_(INPUT_SHAPING_X, shaping_queue_x.purge());
-      TERN_(INPUT_SHAPING_X, shaping_dividend_queue_x.purge());
-      TERN_(INPUT_SHAPING_Y, shaping_queue_y.purge());
-      TERN_(INPUT_SHAPING_Y, shaping_dividend_queue_y.purge());
-      TERN_(INPUT_SHAPING_X, delta_error.x = 0);
-      TERN_(INPUT_SHAPING_Y, delta_error.y = 0);
+      TERN_(HAS_SHAPING_X, shaping_queue_x.purge());
+      TERN_(HAS_SHAPING_X, shaping_dividend_queue_x.purge());
+      TERN_(HAS_SHAPING_Y, shaping_queue_y.purge());
+      TERN_(HAS_SHAPING_Y, shaping_dividend_queue_y.purge());
+      TERN_(HAS_SHAPING_X, delta_error.x = 0);
+      TERN_(HAS_SHAPING_Y, delta_error.y = 0);
     }
   }
 
@@ -1642,9 +1720,25 @@ void Stepper::pulse_phase_isr() {
   const uint32_t pending_events = step_event_count - step_events_completed;
   uint8_t events_to_do = _MIN(pending_events, steps_per_isr);
 
+  // Hold the primary steps while an echo buffer is full. The planner caps the step rate
+  // of shaped blocks to shaping max_rate, so this only catches steps_per_isr bursts.
+  if (TERN0(HAS_SHAPING_X, shaping_enqueue_x && shaping_queue_x.free(shaping_x.echoes) < events_to_do)
+   || TERN0(HAS_SHAPING_Y, shaping_enqueue_y && shaping_queue_y.free(shaping_y.echoes) < events_to_do)
+  ) return;
+
   // Just update the value we will get at the end of the loop
   step_events_completed += events_to_do;
 
+  pulse_phase_steps(events_to_do);
+}
+
+/**
+ * Step loop of pulse_phase_isr(), one instance per LA generation.
+ * LA_V1: LIN_ADV_VERSION_2/3, E steps are taken by the LA ISR.
+ * block_phase_isr() picks the instance once per block.
+ */
+template<bool LA_V1>
+void Stepper::pulse_phase_kernel(uint8_t events_to_do) {
   // Take multiple steps per interrupt (For high speed moves)
   #if ISR_MULTI_STEPS
     bool firstStep = true;
@@ -1676,10 +1770,8 @@ void Stepper::pulse_phase_isr() {
       } \
       step_needed[_AXIS(AXIS)] = (MAXDIR(AXIS) && delta_error[_AXIS(AXIS)] >= 0x10000000L) || \
                                  (MINDIR(AXIS) && delta_error[_AXIS(AXIS)] <= -0x10000000L); \
-      if (step_needed[_AXIS(AXIS)]) { \
-        count_position[_AXIS(AXIS)] += count_direction[_AXIS(AXIS)]; \
+      if (step_needed[_AXIS(AXIS)]) \
         delta_error[_AXIS(AXIS)] += MAXDIR(AXIS) ? -0x20000000L : 0x20000000L; \
-      } \
     }while(0)
 
     // Start an active pulse if needed
@@ -1807,8 +1899,8 @@ void Stepper::pulse_phase_isr() {
     #endif // DIRECT_STEPPING
 
     if (!is_page) {
-      TERN_(HAS_SHAPING_X, shaping_queue_x.enqueue(shaping_delay_x));
-      TERN_(HAS_SHAPING_Y, shaping_queue_y.enqueue(shaping_delay_y));
+      TERN_(HAS_SHAPING_X, if (shaping_enqueue_x) shaping_queue_x.enqueue());
+      TERN_(HAS_SHAPING_Y, if (shaping_enqueue_y) shaping_queue_y.enqueue());
       // Determine if pulses are needed
       #if HAS_X_STEP
         //PULSE_PREP(X);
@@ -1838,7 +1930,7 @@ void Stepper::pulse_phase_isr() {
       #if HAS_K_STEP
         PULSE_PREP(K);
       #endif
-      if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+      if (LA_V1) {
         #if EITHER(HAS_E0_STEP, MIXING_EXTRUDER)
           PULSE_PREP(E);
           #if ENABLED(LIN_ADVANCE)
@@ -1876,14 +1968,24 @@ void Stepper::pulse_phase_isr() {
     #endif
 
     // Pulse start
-    #if HAS_X_STEP
-      PULSE_START(X);
-    #endif
-    #if HAS_Y_STEP
-      PULSE_START(Y);
+    #if STEP_PORT_BATCH
+      uint32_t step_word[SPB_COUNT] = { 0 };
+      STEP_BATCH_ADD(step_word, X, SPB_X);
+      STEP_BATCH_ADD(step_word, Y, SPB_Y);
+    #else
+      #if HAS_X_STEP
+        PULSE_START(X);
+      #endif
+      #if HAS_Y_STEP
+        PULSE_START(Y);
+      #endif
     #endif
     #if HAS_Z_STEP
       PULSE_START(Z);
+      TERN_(ANKER_PROBE_CAPTURE, if (step_needed.z) probe_capture.step(count_position.z));
+      #if BOTH(ANKER_ALIGN_LSQ, SQUARE_WAVE_STEPPING)
+        if (step_needed.z) z_lock_count();  // A toggle is the whole step, the pin is never left high
+      #endif
     #endif
     #if HAS_I_STEP
       PULSE_START(I);
@@ -1895,16 +1997,22 @@ void Stepper::pulse_phase_isr() {
       PULSE_START(K);
     #endif
 
-    if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+    if (LA_V1) {
       #if ENABLED(MIXING_EXTRUDER)
        if (step_needed.e) {
         count_position[E_AXIS] += count_direction[E_AXIS];
         E_STEP_WRITE(mixer.get_next_stepper(), !INVERT_E_STEP_PIN);
        }
+      #elif STEP_PORT_BATCH
+        STEP_BATCH_ADD(step_word, E, SPB_E);
       #elif HAS_E0_STEP
         PULSE_START(E);
       #endif
     }
+    #if STEP_PORT_BATCH
+      LOOP_L_N(s, step_port_batch.ports)
+        if (step_word[s]) step_port_batch.port[s]->ODR ^= step_word[s];
+    #endif
     #if ENABLED(I2S_STEPPER_STREAM)
       i2s_push_sample();
     #endif
@@ -1927,6 +2035,7 @@ void Stepper::pulse_phase_isr() {
         #endif
         #if HAS_Z_STEP
           PULSE_STOP(Z);
+          TERN_(ANKER_ALIGN_LSQ, if (step_needed.z) z_lock_count());
         #endif
         #if HAS_I_STEP
           PULSE_STOP(I);
@@ -1937,7 +2046,7 @@ void Stepper::pulse_phase_isr() {
         #if HAS_K_STEP
           PULSE_STOP(K);
         #endif
-        if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+        if (LA_V1) {
           #if ENABLED(MIXING_EXTRUDER)
             if (step_needed.e) E_STEP_WRITE(mixer.get_stepper(), INVERT_E_STEP_PIN);
           #elif HAS_E0_STEP
@@ -1950,12 +2059,6 @@ void Stepper::pulse_phase_isr() {
       #endif
     }
   } while (--events_to_do);
-  //begin add by jason.wu for detect layer change to notify remote controller capture
-  #if ENABLED(PHOTO_Z_LAYER) // after z layer update
-  if(pending_events <= steps_per_isr)
-    z_axis_layer_change_notify(current_block);
-  #endif
-  //end add by jason.wu for detect layer change to notify remote controller capture
 }
 
 // Calculate timer interval, with all limits applied.
@@ -1997,6 +2100,12 @@ hal_timer_t Stepper::calc_timer_interval(uint32_t step_rate, uint8_t &loops) {
 
     // Just make sure the step rate is doable
     NOMORE(step_rate, uint32_t(MAX_STEP_ISR_FREQUENCY_1X)); // 106870UL
+  #elif ENABLED(ANKER_STEP_SCHED)
+
+    // Sticky multistepping, see anker_step_sched.h
+    const uint8_t idx = step_sched.select(step_rate);
+    step_rate >>= idx;
+    multistep <<= idx;
   #else
 
     // The stepping frequency limits for each multistepping rate
@@ -2089,12 +2198,12 @@ void Stepper::la_dec_calc(uint32_t step_rate)
 }
 
 #if HAS_SHAPING_X
-  void Stepper::shaping_isr_x() {
-    shaping_queue_x.dequeue();
+  void Stepper::shaping_isr_x(const uint8_t e) {
+    shaping_queue_x.dequeue(e);
 
     // echo step behaviour
     xyze_bool_t step_needed{0};
-    PULSE_PREP_SHAPING(X, shaping_dividend_x);
+    PULSE_PREP_SHAPING(X, shaping_dividend_x[e]);
     PULSE_START(X);
 
     TERN_(I2S_STEPPER_STREAM, i2s_push_sample());
@@ -2110,12 +2219,12 @@ void Stepper::la_dec_calc(uint32_t step_rate)
 #endif
 
 #if HAS_SHAPING_Y
-  void Stepper::shaping_isr_y() {
-    shaping_queue_y.dequeue();
+  void Stepper::shaping_isr_y(const uint8_t e) {
+    shaping_queue_y.dequeue(e);
 
     // echo step behaviour
     xyze_bool_t step_needed{0};
-    PULSE_PREP_SHAPING(Y, shaping_dividend_y);
+    PULSE_PREP_SHAPING(Y, shaping_dividend_y[e]);
     PULSE_START(Y);
 
     TERN_(I2S_STEPPER_STREAM, i2s_push_sample());
@@ -2135,6 +2244,7 @@ void Stepper::la_dec_calc(uint32_t step_rate)
 // the step pulses, so it is not time critical, as pulses are already done.
 
 uint32_t Stepper::block_phase_isr() {
+  ISR_PROFILE(PROF_BLOCK_PHASE);
 
   // If no queued movements, just wait 1ms for the next block
   uint32_t interval = (STEPPER_TIMER_RATE) / 1000UL;
@@ -2162,7 +2272,9 @@ uint32_t Stepper::block_phase_isr() {
         }
       #endif
       TERN_(HAS_FILAMENT_RUNOUT_DISTANCE, runout.block_completed(current_block));
+      TERN_(PHOTO_Z_LAYER, block_event.finish(current_block->event_id));
       discard_current_block();
+      TERN_(ANKER_FLOW_CTRL, anker_flow.block_done(!planner.has_blocks_queued()));
     }
     else {
       // Step events not completed yet...
@@ -2171,7 +2283,7 @@ uint32_t Stepper::block_phase_isr() {
       if (step_events_completed <= accelerate_until) { // Calculate new timer value
 
         //#if ENABLED(S_CURVE_ACCELERATION)
-        if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_3){
+        if(la_version >= LIN_ADV_VERSION_3){
           // Get the next speed to use (Jerk limited!)
           acc_step_rate = acceleration_time < current_block->acceleration_time
                                    ? _eval_bezier_curve(acceleration_time)
@@ -2188,9 +2300,10 @@ uint32_t Stepper::block_phase_isr() {
         // step_rate to timer interval and steps per stepper isr
         interval = calc_timer_interval(acc_step_rate << oversampling_factor, steps_per_isr);
         acceleration_time += interval;
+        TERN_(ANKER_STEPPER_SNAPSHOT, snap_rate = acc_step_rate);
 
         #if ENABLED(LIN_ADVANCE)
-         if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+         if(la_version >= LIN_ADV_VERSION_2){
            la_acc_calc();
          }else{
           if (LA_ver.v0.LA_use_advance_lead) {
@@ -2235,7 +2348,7 @@ uint32_t Stepper::block_phase_isr() {
         uint32_t step_rate;
 
         //#if ENABLED(S_CURVE_ACCELERATION)
-        if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_3){
+        if(la_version >= LIN_ADV_VERSION_3){
           // If this is the 1st time we process the 2nd half of the trapezoid...
           if (!bezier_2nd_half) {
             // Initialize the Bézier speed curve
@@ -2265,9 +2378,10 @@ uint32_t Stepper::block_phase_isr() {
         // step_rate to timer interval and steps per stepper isr
         interval = calc_timer_interval(step_rate << oversampling_factor, steps_per_isr);
         deceleration_time += interval;
+        TERN_(ANKER_STEPPER_SNAPSHOT, snap_rate = step_rate);
 
         #if ENABLED(LIN_ADVANCE)
-        if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+        if(la_version >= LIN_ADV_VERSION_2){
           la_dec_calc(step_rate);
         }
         else{
@@ -2315,7 +2429,7 @@ uint32_t Stepper::block_phase_isr() {
       else {
 
         #if ENABLED(LIN_ADVANCE)
-        if(planner.LIN_ADV_version_change <= LIN_ADV_VERSION_1){
+        if(la_version <= LIN_ADV_VERSION_1){
           // If there are any esteps, fire the next advance_isr "now"
           if (LA_ver.v0.LA_steps && LA_ver.v0.LA_isr_rate != current_block->advance_speed) initiateLA();
         }
@@ -2327,7 +2441,7 @@ uint32_t Stepper::block_phase_isr() {
           ticks_nominal = calc_timer_interval(current_block->nominal_rate << oversampling_factor, steps_per_isr);
 
           #if ENABLED(LIN_ADVANCE)
-            if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+            if(la_version >= LIN_ADV_VERSION_2){
               if (LA_ver.v1.la_active)
                 LA_ver.v1.la_interval = calc_timer_interval(current_block->nominal_rate >> current_block->la_scaling);
               #if ENABLED(ANKER_E_SMOOTH)
@@ -2339,6 +2453,7 @@ uint32_t Stepper::block_phase_isr() {
 
         // The timer interval is just the nominal value for the nominal speed
         interval = ticks_nominal;
+        TERN_(ANKER_STEPPER_SNAPSHOT, snap_rate = current_block->nominal_rate);
 
         // Update laser - Cruising
         #if ENABLED(LASER_POWER_INLINE_TRAPEZOID)
@@ -2373,9 +2488,25 @@ uint32_t Stepper::block_phase_isr() {
       }
     #endif
 
+    // Every shaped block takes a dividend slot until its last echo starts. On a run of
+    // very short blocks wait for one to free up rather than overwrite it.
+    if (TERN0(HAS_SHAPING_X, shaping_x.echoes && !shaping_dividend_queue_x.free(shaping_x.echoes))
+     || TERN0(HAS_SHAPING_Y, shaping_y.echoes && !shaping_dividend_queue_y.free(shaping_y.echoes))
+    ) return (STEPPER_TIMER_RATE) / 20000UL;  // Check again in 50us
+
+    #if ENABLED(DIRECT_STEPPING) && EITHER(HAS_SHAPING_X, HAS_SHAPING_Y)
+      // A page steps X/Y and their directions itself, the echoes of the shaped blocks before it run out first
+      if (planner.has_blocks_queued() && IS_PAGE((&planner.block_buffer[planner.block_buffer_tail]))
+        && (TERN0(HAS_SHAPING_X, shaping_x.echoes && shaping_queue_x.free(shaping_x.echoes) < SHAPING_BUFFER_X - 1)
+         || TERN0(HAS_SHAPING_Y, shaping_y.echoes && shaping_queue_y.free(shaping_y.echoes) < SHAPING_BUFFER_Y - 1))
+      ) return (STEPPER_TIMER_RATE) / 20000UL;  // Check again in 50us
+    #endif
+
     // Anything in the buffer?
     if ((current_block = planner.get_current_block())) {
 
+      TERN_(ANKER_FLOW_CTRL, anker_flow.block_start());
+
       // Sync block? Sync the stepper counts or fan speeds and return
       while (current_block->flag & BLOCK_MASK_SYNC) {
 
@@ -2402,6 +2533,12 @@ uint32_t Stepper::block_phase_isr() {
 
       TERN_(POWER_LOSS_RECOVERY, recovery.info.sdpos = current_block->sdpos);
 
+      // Run the block with the LA generation it was planned for
+      #if ENABLED(LIN_ADVANCE)
+        la_version = current_block->la_version;
+        pulse_phase_steps = la_version >= LIN_ADV_VERSION_2 ? &pulse_phase_kernel<true> : &pulse_phase_kernel<false>;
+      #endif
+
       #if ENABLED(DIRECT_STEPPING)
         if (IS_PAGE(current_block)) {
           page_step_state.segment_steps = 0;
@@ -2501,19 +2638,29 @@ uint32_t Stepper::block_phase_isr() {
       // No acceleration / deceleration time elapsed so far
       acceleration_time = deceleration_time = 0;
 
+      // Only blocks that move a shaped axis feed its echoes
+      TERN_(HAS_SHAPING_X, shaping_enqueue_x = shaping_x.echoes && current_block->steps.x);
+      TERN_(HAS_SHAPING_Y, shaping_enqueue_y = shaping_y.echoes && current_block->steps.y);
+
       #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
       oversampling_factor = 0;   // Assume no axis smoothing (via oversampling)
-      if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){                       
+      if(la_version >= LIN_ADV_VERSION_2 && !IS_PAGE(current_block)){ // A page is stepped one segment step per event
+        // Every oversampled event is also an echo event, so stay within the echo buffers
+        uint32_t isr_limit = TERN(ANKER_STEP_SCHED, step_sched.isr_limit(), MIN_STEP_ISR_FREQUENCY);
+        TERN_(HAS_SHAPING_X, if (shaping_enqueue_x) NOMORE(isr_limit, shaping_x.max_rate));
+        TERN_(HAS_SHAPING_Y, if (shaping_enqueue_y) NOMORE(isr_limit, shaping_y.max_rate));
         // Decide if axis smoothing is possible
         uint32_t max_rate = current_block->nominal_rate;    // Get the step event rate
-        while (max_rate < MIN_STEP_ISR_FREQUENCY) {         // As long as more ISRs are possible...
+        while (max_rate < isr_limit) {                      // As long as more ISRs are possible...
           max_rate <<= 1;                                   // Try to double the rate
-          if (max_rate < MIN_STEP_ISR_FREQUENCY)            // Don't exceed the estimated ISR limit
+          if (max_rate < isr_limit)                         // Don't exceed the estimated ISR limit
             ++oversampling_factor;                          // Increase the oversampling (used for left-shift)
         }
       }
       #endif
 
+      TERN_(ANKER_STEP_SCHED, step_sched.block_start(current_block->nominal_rate << oversampling_factor));
+
       // Based on the oversampling factor, do the calculations
       step_event_count = current_block->step_event_count << oversampling_factor;
 
@@ -2535,10 +2682,10 @@ uint32_t Stepper::block_phase_isr() {
       // and the dividend is directional, i.e. signed
       TERN_(HAS_SHAPING_X, advance_dividend.x = (uint64_t(current_block->steps.x) << 29) / step_event_count);
       TERN_(HAS_SHAPING_X, if (TEST(current_block->direction_bits, X_AXIS)) advance_dividend.x = -advance_dividend.x);
-      TERN_(HAS_SHAPING_X, SET_BIT_TO(current_block->direction_bits, X_AXIS, TEST(last_direction_bits, X_AXIS)));
+      TERN_(HAS_SHAPING_X, if (!IS_PAGE(current_block)) SET_BIT_TO(current_block->direction_bits, X_AXIS, TEST(last_direction_bits, X_AXIS)));
       TERN_(HAS_SHAPING_Y, advance_dividend.y = (uint64_t(current_block->steps.y) << 29) / step_event_count);
       TERN_(HAS_SHAPING_Y, if (TEST(current_block->direction_bits, Y_AXIS)) advance_dividend.y = -advance_dividend.y);
-      TERN_(HAS_SHAPING_Y, SET_BIT_TO(current_block->direction_bits, Y_AXIS, TEST(last_direction_bits, Y_AXIS)));
+      TERN_(HAS_SHAPING_Y, if (!IS_PAGE(current_block)) SET_BIT_TO(current_block->direction_bits, Y_AXIS, TEST(last_direction_bits, Y_AXIS)));
 
       // The scaling operation above introduces rounding errors which must now be removed.
       // For this segment, there will be step_event_count calls to the Bresenham logic and the same number of echoes.
@@ -2553,27 +2700,18 @@ uint32_t Stepper::block_phase_isr() {
       TERN_(HAS_SHAPING_X, delta_error.x = old_delta_error_x + 0x10000000L - ((0x10000000L + advance_dividend.x * step_event_count) & 0x1fffffffUL));
       TERN_(HAS_SHAPING_Y, delta_error.y = old_delta_error_y + 0x10000000L - ((0x10000000L + advance_dividend.y * step_event_count) & 0x1fffffffUL));
 
-      // when there is damping, the signal and its echo have different amplitudes
-      #if ENABLED(HAS_SHAPING_X)
-        int32_t echo_x = shaping_factor_x * (advance_dividend.x >> 7);
-      #endif
-      #if ENABLED(HAS_SHAPING_Y)
-        int32_t echo_y = shaping_factor_y * (advance_dividend.y >> 7);
-      #endif
+      // Plan the dividend change each echo picks up after its delay, and leave the
+      // primary signal with what is not handed to the echoes. The echoes recompute
+      // their share from the full dividend so the shares always add up.
+      #define SHAPING_SPLIT_DIVIDEND(A) do{ \
+        const int32_t full = advance_dividend.A; \
+        shaping_dividend_queue_##A.enqueue(full); \
+        LOOP_L_N(e, shaping_##A.echoes) advance_dividend.A -= shaping_##A.factor[e] * (full >> 7); \
+      }while(0)
+      TERN_(HAS_SHAPING_X, if (shaping_enqueue_x) SHAPING_SPLIT_DIVIDEND(x));
+      TERN_(HAS_SHAPING_Y, if (shaping_enqueue_y) SHAPING_SPLIT_DIVIDEND(y));
 
-      // plan the change of values for advance_dividend for the input shaping echoes
-      TERN_(HAS_SHAPING_X, shaping_dividend_queue_x.enqueue(shaping_delay_x, echo_x));
-      TERN_(HAS_SHAPING_Y, shaping_dividend_queue_y.enqueue(shaping_delay_y, echo_y));
-
-      // apply the adjustment to the primary signal
-      TERN_(HAS_SHAPING_X, advance_dividend.x -= echo_x);
-      TERN_(HAS_SHAPING_Y, advance_dividend.y -= echo_y);
-
-      //begin add by jason.wu for detect layer change to notify remote controller capture
-      #if 0 //ENABLED(PHOTO_Z_LAYER)  // before z layer update
-        z_axis_layer_change_notify(current_block);
-      #endif
-      //end add by jason.wu for detect layer change to notify remote controller capture
+      TERN_(PHOTO_Z_LAYER, block_event.start(current_block->event_id));
 
 
       // No step events completed so far
@@ -2589,7 +2727,7 @@ uint32_t Stepper::block_phase_isr() {
 
       // Initialize the trapezoid generator from the current block.
       #if ENABLED(LIN_ADVANCE)
-      if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){// version 2
+      if(la_version >= LIN_ADV_VERSION_2){// version 2
         LA_ver.v1.la_active = (current_block->la_advance_rate != 0);
         #if DISABLED(MIXING_EXTRUDER) && E_STEPPERS > 1
           if (stepper_extruder != last_moved_extruder) la_advance_steps = 0;// If the now active extruder wasn't in use during the last move, its pressure is most likely gone.
@@ -2674,7 +2812,7 @@ uint32_t Stepper::block_phase_isr() {
       ticks_nominal = 0;
 
       //#if ENABLED(S_CURVE_ACCELERATION)
-      if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_3){
+      if(la_version >= LIN_ADV_VERSION_3){
         // Initialize the Bézier speed curve
         _calc_bezier_curve_coeffs(current_block->initial_rate, current_block->cruise_rate, current_block->acceleration_time_inverse);
         // We haven't started the 2nd half of the trapezoid
@@ -2686,16 +2824,18 @@ uint32_t Stepper::block_phase_isr() {
 
       // Calculate the initial timer interval
       acceleration_time = interval = calc_timer_interval(current_block->initial_rate << oversampling_factor, steps_per_isr);
+      TERN_(ANKER_STEPPER_SNAPSHOT, snap_rate = current_block->initial_rate);
 
-      TERN_(ANKER_MAKE_API, RCS.nominal_speed_sqr = current_block->nominal_speed_sqr);
+      TERN_(ANKER_MAKE_API, RCS.nominal_speed_sqr = planner.plan_of(current_block).nominal_speed_sqr);
 
       #if ENABLED(LIN_ADVANCE)
-        if(planner.LIN_ADV_version_change >= LIN_ADV_VERSION_2){
+        if(la_version >= LIN_ADV_VERSION_2){
           if (LA_ver.v1.la_active) {// version 1
             #if ENABLED(ANKER_E_SMOOTH)
             if(stepper.la_status.pre.la_advance_rate != 0){
               stepper.la_status.growth_v0_2 = sq(LA_ver.v1.la_current_advance_rate);
             }
+            stepper.la_status.advance_rate_v2 = sq(current_block->la_advance_rate);
             const uint32_t la_step_rate = LA_ver.v1.la_advance_steps < current_block->max_adv_steps_v1\
                                           ? (la_calc_Acc_speed_curves(accelerate_until, step_events_completed, current_block->la_advance_rate))\
                                           : 0;
@@ -2867,15 +3007,8 @@ uint32_t Stepper::block_phase_isr() {
     }
   }
  #if ENABLED(ANKER_E_SMOOTH)
-  float fast_InvSqrt(float x)  // 1/ SQRT(X)
-  {
-      float xhalf = 0.5f * x;
-      int i = *(int *)&x;
-      i = 0x5f3759df - (i>>1);
-      x = *(float *)&i;
-      x = x * (1.5f - xhalf * x * x);
-      return x;
-  }
+  // (steps/s)^2 -> steps/s. A single VSQRT on the M4F, cheaper than 1/InvSqrt(x) which needs a VDIV.
+  FORCE_INLINE uint32_t la_rate_from_v2(const uint32_t rate_v2) { return uint32_t(SQRT(float(rate_v2))); }
 
   //begin add by Anan.huang
   uint32_t Stepper::la_calc_Acc_speed_curves(const int32_t length, const int32_t steps_now, const uint32_t advance_rate)
@@ -2884,7 +3017,7 @@ uint32_t Stepper::block_phase_isr() {
 
     if( length < LA_MAX_NOISE_STEP) return 0;
 
-    const uint32_t advance_rate_v2 = sq(advance_rate);
+    const uint32_t advance_rate_v2 = stepper.la_status.advance_rate_v2;
     uint32_t growth_rate_v2 = current_block->la_segment.double_steps_per_s2 * steps_now; // Calculate the growth rate and decay rate of the K-value speed.
     uint32_t decay_speed_v2 = current_block->la_segment.double_steps_per_s2 * (length - steps_now);
 
@@ -2905,7 +3038,7 @@ uint32_t Stepper::block_phase_isr() {
 
     if(la_current_rate_2 == 0) return 0;
 
-    const uint32_t la_current_rate = (uint32_t)(1.0f/fast_InvSqrt(la_current_rate_2));
+    const uint32_t la_current_rate = la_rate_from_v2(la_current_rate_2);
 
     return _MIN(la_current_rate, advance_rate);
   }
@@ -2917,7 +3050,7 @@ uint32_t Stepper::block_phase_isr() {
     if( length < LA_MAX_NOISE_STEP) return 0;
 
     // start 500NS
-    const uint32_t advance_rate_v2 = sq(advance_rate);
+    const uint32_t advance_rate_v2 = stepper.la_status.advance_rate_v2;
     uint32_t growth_rate_v2 = current_block->la_segment.double_steps_per_s2 *steps_now; // Calculate the growth rate and decay rate of the K-value speed.
     uint32_t decay_speed_v2 = current_block->la_segment.double_steps_per_s2 * (length - steps_now);
 
@@ -2938,7 +3071,7 @@ uint32_t Stepper::block_phase_isr() {
 
     if(la_current_rate_2 == 0) return 0;
 
-    const uint32_t la_current_rate = (uint32_t)(1.0f/fast_InvSqrt(la_current_rate_2));
+    const uint32_t la_current_rate = la_rate_from_v2(la_current_rate_2);
     // end 500NS
 
     return _MIN(la_current_rate, advance_rate);   // 1uS~3.5us 
@@ -3151,6 +3284,8 @@ void Stepper::init() {
     AXIS_INIT(X, X);
   #endif
 
+  TERN_(STEP_PORT_BATCH, step_port_batch_init());
+
   #if HAS_Y_STEP
     #if ENABLED(Y_DUAL_STEPPER_DRIVERS)
       Y2_STEP_INIT();
@@ -3232,34 +3367,125 @@ void Stepper::init() {
     digipot_init();
   #endif
   
-  // Init input shaping
-  TERN_(HAS_SHAPING_X, set_shaping_damping_ratio(X_AXIS, SHAPING_ZETA_X));
-  TERN_(HAS_SHAPING_Y, set_shaping_damping_ratio(Y_AXIS, SHAPING_ZETA_Y));
+  // Input shaping is set up by settings.reset() / load()
 }
 
 #if ENABLED(INPUT_SHAPING)
+
+  static const char * const shaping_type_name[SHAPER_COUNT] = { "NONE", "ZV", "ZVD", "MZV", "EI" };
+
   /**
-   * Calculate a fixed point factor to apply to the signal and its echo
-   * when shaping an axis.
+   * Work out the echo shares and delays of a shaper.
+   *
+   * Amplitudes are the damped forms, with K = exp(-zeta * PI / sqrt(1 - zeta^2))
+   * and Td = 1 / (freq * sqrt(1 - zeta^2)) the damped period:
+   *   ZV  : 1, K                                         at 0, Td/2
+   *   ZVD : 1, 2K, K^2                                   at 0, Td/2, Td
+   *   MZV : 1-1/sqrt2, (sqrt2-1)K', (1-1/sqrt2)K'^2      at 0, 3Td/8, 3Td/4  (K' uses 0.75 zeta)
+   *   EI  : (1+v)/4, (1-v)K/2, (1+v)K^2/4                at 0, Td/2, Td      (v = 0.05)
+   * They are normalized to a unit sum and the echoes are stored in 1:7 fixed point.
+   * The primary keeps whatever the echoes don't take, so rounding never loses steps.
    */
-  void Stepper::set_shaping_damping_ratio(const AxisEnum axis, const float zeta) {
-    // from the damping ratio, get a factor that can be applied to advance_dividend for fixed point maths
-    // for ZV, we use amplitudes 1/(1+K) and K/(1+K) where K = exp(-zeta * M_PI / sqrt(1.0f - zeta * zeta))
-    // which can be converted to 1:7 fixed point with an excellent fit with a 3rd order polynomial
-    float shaping_factor;
-    if (zeta <= 0.0f) shaping_factor = 64.0f;
-    else if (zeta >= 1.0f) shaping_factor = 0.0f;
-    else {
-      shaping_factor = 64.44056192 + -99.02008832 * zeta;
-      const float zeta2 = zeta * zeta;
-      shaping_factor += -7.58095488 * zeta2;
-      const float zeta3 = zeta2 * zeta;
-      shaping_factor += 43.073216 * zeta3;
+  static void calc_shaping(shaping_params_t &sp, const uint16_t buffer_size) {
+    float amp[SHAPING_ECHOES + 1] = { 1.0f }, at[SHAPING_ECHOES] = { 0 };
+    uint8_t echoes = 0;
+
+    const float df = SQRT(1.0f - sq(sp.zeta)),
+                K = expf(-sp.zeta * float(M_PI) / df),
+                Td = 1.0f / (sp.frequency * df);
+
+    switch (sp.type) {
+      default: break;
+      case SHAPER_ZV:
+        echoes = 1; amp[1] = K; at[0] = 0.5f;
+        break;
+      case SHAPER_ZVD:
+        echoes = 2; amp[1] = 2.0f * K; amp[2] = sq(K); at[0] = 0.5f; at[1] = 1.0f;
+        break;
+      case SHAPER_MZV: {
+        const float K2 = expf(-0.75f * sp.zeta * float(M_PI) / df), a1 = 1.0f - float(M_SQRT1_2);
+        echoes = 2; amp[0] = a1; amp[1] = (float(M_SQRT2) - 1.0f) * K2; amp[2] = a1 * sq(K2);
+        at[0] = 0.375f; at[1] = 0.75f;
+      } break;
+      case SHAPER_EI: {
+        constexpr float v = 0.05f;
+        echoes = 2; amp[0] = 0.25f * (1.0f + v); amp[1] = 0.5f * (1.0f - v) * K; amp[2] = amp[0] * sq(K);
+        at[0] = 0.5f; at[1] = 1.0f;
+      } break;
+    }
+
+    float sum = 0;
+    LOOP_LE_N(i, echoes) sum += amp[i];
+
+    sp.echoes = echoes;
+    LOOP_L_N(e, SHAPING_ECHOES) {
+      if (e < echoes) {
+        sp.factor[e] = LROUND(128.0f * amp[e + 1] / sum);
+        sp.delay[e] = LROUND(float(STEPPER_TIMER_RATE) * at[e] * Td);
+      }
+      else {
+        sp.factor[e] = 0;
+        sp.delay[e] = 0;
+      }
     }
 
-    TERN_(HAS_SHAPING_X, if (axis == X_AXIS) shaping_factor_x = floor(shaping_factor));
-    TERN_(HAS_SHAPING_Y, if (axis == Y_AXIS) shaping_factor_y = floor(shaping_factor));
+    // Events queued within the longest delay must fit, with headroom for a multi-step ISR burst
+    sp.max_rate = echoes ? uint32_t(buffer_size - 16) * (STEPPER_TIMER_RATE) / sp.delay[echoes - 1] : UINT32_MAX;
   }
+
+  bool Stepper::set_shaping(const AxisEnum axis, const ShapingType type, const float freq, const float zeta) {
+    if (type >= SHAPER_COUNT || !WITHIN(zeta, 0.0f, SHAPING_MAX_ZETA)) return false;
+    if (type != SHAPER_NONE && freq < (SHAPING_MIN_FREQ)) return false;
+
+    shaping_params_t sp = { type, 0, freq, zeta };
+    uint16_t buffer_size = 0;
+    switch (axis) {
+      TERN_(HAS_SHAPING_X, case X_AXIS: buffer_size = SHAPING_BUFFER_X; break;)
+      TERN_(HAS_SHAPING_Y, case Y_AXIS: buffer_size = SHAPING_BUFFER_Y; break;)
+      default: return false;
+    }
+    calc_shaping(sp, buffer_size);
+
+    // Echo heads and delays must not change under a running echo, let the moves
+    // and their echoes finish first, the purge would drop their steps (M501, M502)
+    planner.synchronize();
+    while (!shaping_idle()) idle();
+
+    const bool was_on = suspend();
+    TERN_(HAS_SHAPING_X, if (axis == X_AXIS) { shaping_queue_x.purge(); shaping_dividend_queue_x.purge(); shaping_x = sp; })
+    TERN_(HAS_SHAPING_Y, if (axis == Y_AXIS) { shaping_queue_y.purge(); shaping_dividend_queue_y.purge(); shaping_y = sp; })
+    if (was_on) wake_up();
+    return true;
+  }
+
+  const shaping_params_t* Stepper::get_shaping(const AxisEnum axis) {
+    switch (axis) {
+      TERN_(HAS_SHAPING_X, case X_AXIS: return &shaping_x;)
+      TERN_(HAS_SHAPING_Y, case Y_AXIS: return &shaping_y;)
+      default: return nullptr;
+    }
+  }
+
+  bool Stepper::shaping_idle() {
+    return !current_block
+      && TERN1(HAS_SHAPING_X, shaping_queue_x.empty())
+      && TERN1(HAS_SHAPING_Y, shaping_queue_y.empty());
+  }
+
+  void Stepper::shaping_report() {
+    LOOP_L_N(i, 2) {
+      const AxisEnum axis = AxisEnum(i);
+      const shaping_params_t * const sp = get_shaping(axis);
+      if (!sp) continue;
+      SERIAL_ECHOPAIR("echo:shaping ", AS_CHAR(axis_codes[axis]), " ", shaping_type_name[sp->type]);
+      SERIAL_ECHOPAIR_F(" F", sp->frequency, 1);
+      SERIAL_ECHOPAIR_F(" D", sp->zeta, 3);
+      LOOP_L_N(e, sp->echoes) SERIAL_ECHOPAIR(" echo", e, ":", sp->factor[e], "/128@", sp->delay[e], "t");
+      if (sp->echoes) SERIAL_ECHOPAIR(" max rate:", sp->max_rate);
+      SERIAL_EOL();
+    }
+  }
+
 #endif
 
 /**
@@ -3291,6 +3517,7 @@ void Stepper::_set_position(const abce_long_t &spos) {
     // default non-h-bot planning
     count_position = spos;
   #endif
+  TERN_(ANKER_STEPPER_SNAPSHOT, publish_snapshot());
 }
 
 /**
@@ -3312,6 +3539,46 @@ int32_t Stepper::position(const AxisEnum axis) {
   return v;
 }
 
+#if ENABLED(ANKER_STEPPER_SNAPSHOT)
+
+  /**
+   * Seqlock over two copies. The writer fills the copy the readers are not on, then bumps
+   * snap_seq. A reader that saw snap_seq move while copying had the copy rewritten under
+   * it and reads again. The writer never waits, so any isr may read, even one that
+   * preempted the stepper isr: it gets the previous snapshot.
+   * Writers: the stepper isr, or the main loop with the stepper isr suspended on every
+   * target (set_position(), set_axis_position()), never both at once.
+   */
+  void Stepper::publish_snapshot() {
+    const uint32_t seq = snap_seq + 1;
+    stepper_snapshot_t &s = snap[seq & 1];
+    s.pos = count_position;
+    if (current_block) {
+      s.step_events_completed = step_events_completed;
+      s.step_event_count = step_event_count;
+      s.step_rate = snap_rate;
+    }
+    else
+      s.step_events_completed = s.step_event_count = s.step_rate = 0;
+    __atomic_store_n(&snap_seq, seq, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * @brief  Positions, block progress and step rate, all from the same stepper isr
+   * @param  s snapshot
+   * @retval None
+   */
+  void Stepper::snapshot(stepper_snapshot_t &s) {
+    uint32_t seq;
+    do {
+      seq = __atomic_load_n(&snap_seq, __ATOMIC_ACQUIRE);
+      s = snap[seq & 1];
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (seq != __atomic_load_n(&snap_seq, __ATOMIC_RELAXED));
+  }
+
+#endif
+
 // Set the current position in steps
 void Stepper::set_position(const xyze_long_t &spos) {
   planner.synchronize();
@@ -3323,15 +3590,17 @@ void Stepper::set_position(const xyze_long_t &spos) {
 void Stepper::set_axis_position(const AxisEnum a, const int32_t &v) {
   planner.synchronize();
 
-  #ifdef __AVR__
+  #if defined(__AVR__) || ENABLED(ANKER_STEPPER_SNAPSHOT)
     // Protect the access to the position. Only required for AVR, as
-    //  any 32bit CPU offers atomic access to 32bit variables
+    //  any 32bit CPU offers atomic access to 32bit variables.
+    //  The snapshot needs it on every target, the stepper isr publishes it too.
     const bool was_enabled = suspend();
   #endif
 
   count_position[a] = v;
+  TERN_(ANKER_STEPPER_SNAPSHOT, publish_snapshot());
 
-  #ifdef __AVR__
+  #if defined(__AVR__) || ENABLED(ANKER_STEPPER_SNAPSHOT)
     // Reenable Stepper ISR
     if (was_enabled) wake_up();
   #endif
@@ -3409,15 +3678,26 @@ void Stepper::report_a_position(const xyz_long_t &pos) {
 
 void Stepper::report_positions() {
 
-  #ifdef __AVR__
-    // Protect the access to the position.
-    const bool was_enabled = suspend();
-  #endif
+  #if ENABLED(ANKER_STEPPER_SNAPSHOT)
 
-  const xyz_long_t pos = count_position;
+    // All axes from the same isr, not torn by a step in between
+    stepper_snapshot_t s;
+    snapshot(s);
+    const xyz_long_t pos = s.pos;
+
+  #else
+
+    #ifdef __AVR__
+      // Protect the access to the position.
+      const bool was_enabled = suspend();
+    #endif
+
+    const xyz_long_t pos = count_position;
+
+    #ifdef __AVR__
+      if (was_enabled) wake_up();
+    #endif
 
-  #ifdef __AVR__
-    if (was_enabled) wake_up();
   #endif
 
   report_a_position(pos);
@@ -3465,17 +3745,10 @@ void Stepper::report_current_status(uint8_t index) {
  * @param  None
  * @retval None
  */
+// Runs once a second from the anker_sched timer wheel
 void Stepper::current_status_polling() {
-
-   const millis_t ms = millis();
-  // Limit nextReportCheck_ms frequency to 1second
-  static millis_t nextReportCheck_ms = 0;
-  if (ELAPSED(ms, nextReportCheck_ms)) {
-    if(queue.ring_buffer.full(BUFSIZE/2)){
-      report_current_status(SERIAL_HOST);
-    }
-    nextReportCheck_ms = ms + 1000UL;
-  }
+  if (queue.ring_buffer.full(BUFSIZE/2))
+    report_current_status(SERIAL_HOST);
 }
 #endif
 
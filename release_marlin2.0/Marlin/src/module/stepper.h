@@ -243,6 +243,7 @@ typedef struct {//add by Anan.huang
   la_block_bits_t pre;
   la_block_bits_t next;
   uint32_t growth_v0_2; // (steps/s)^2
+  uint32_t advance_rate_v2; // sq(current_block->la_advance_rate), set once per block
 }la_stepper_bits_t;
 #endif
 
@@ -269,50 +270,97 @@ typedef struct{
 
   typedef IF<ENABLED(__AVR__), uint16_t, uint32_t>::type shaping_time_t;
 
+  // Shaper families. Each one is the primary impulse plus up to SHAPING_ECHOES delayed echoes.
+  enum ShapingType : uint8_t {
+    SHAPER_NONE,  // Shaping off, the axis steps straight from the block
+    SHAPER_ZV,    // 1 echo at T/2
+    SHAPER_ZVD,   // 2 echoes at T/2 and T
+    SHAPER_MZV,   // 2 echoes at 3T/8 and 3T/4
+    SHAPER_EI,    // 2 echoes at T/2 and T, 5% vibration tolerance
+    SHAPER_COUNT
+  };
+
+  #define SHAPING_ECHOES   2
+  #define SHAPING_MAX_ZETA 0.6f  // Bounds the longest echo delay to 1.25 / frequency
+
+  typedef struct {
+    ShapingType type;
+    uint8_t echoes;                         // Active echoes, 0 when type is SHAPER_NONE
+    float frequency, zeta;
+    uint8_t factor[SHAPING_ECHOES];         // Echo share of the dividend, 1:7 fixed point
+    shaping_time_t delay[SHAPING_ECHOES];   // Echo delay in stepper ticks, ascending
+    uint32_t max_rate;                      // Highest step event rate the echo buffer can hold
+  } shaping_params_t;
+
   class DelayNowTimer {
-    private:
+    protected:
       static shaping_time_t now;
     public:
       static void decrement_delays(const shaping_time_t interval) { now += interval; }
   };
 
-  template <int SIZE> class DelayQueue : public DelayNowTimer {
+  /**
+   * Step event times of one axis, shared by all of its echoes.
+   * Echo e replays an entry at its enqueue time + delay[e]. Delays are ascending
+   * so the last active echo always holds the oldest entry.
+   */
+  template <int SIZE> class EchoQueue : public DelayNowTimer {
     protected:
       shaping_time_t times[SIZE];
-      uint16_t head = 0, tail = 0;
+      uint16_t head[SHAPING_ECHOES] = { 0 }, tail = 0;
 
     public:
-      void enqueue(const shaping_time_t delay) {
-        times[tail] = now + delay;
+      void enqueue() {
+        times[tail] = now;
         if (++tail == SIZE) tail = 0;
       }
-      shaping_time_t peek() {
-        if (head != tail) return times[head] - now;
+      shaping_time_t peek(const uint8_t e, const shaping_time_t delay) {
+        if (head[e] != tail) return times[head[e]] + delay - now;
         else return shaping_time_t(-1);
       }
-      void dequeue() { if (++head == SIZE) head = 0; }
-      void purge() { tail = head; }
-      bool empty() { return head == tail; }
+      void dequeue(const uint8_t e) { if (++head[e] == SIZE) head[e] = 0; }
+      uint16_t free(const uint8_t echoes) {
+        const uint16_t h = head[echoes - 1];
+        return SIZE - 1 - (tail >= h ? tail - h : tail + SIZE - h);
+      }
+      void purge() { LOOP_L_N(e, SHAPING_ECHOES) head[e] = tail; }
+      bool empty() {
+        LOOP_L_N(e, SHAPING_ECHOES) if (head[e] != tail) return false;
+        return true;
+      }
   };
 
-  template <int SIZE> class ParamDelayQueue : public DelayQueue<SIZE> {
+  // Block dividends, replayed to each echo at the same delays as the step events
+  template <int SIZE> class EchoParamQueue : public EchoQueue<SIZE> {
     private:
       int32_t params[SIZE];
 
     public:
-      void enqueue(const shaping_time_t delay, const int32_t param) {
-        params[DelayQueue<SIZE>::tail] = param;
-        DelayQueue<SIZE>::enqueue(delay);
+      void enqueue(const int32_t param) {
+        params[EchoQueue<SIZE>::tail] = param;
+        EchoQueue<SIZE>::enqueue();
       }
-      const int32_t dequeue() {
-        const int32_t result = params[DelayQueue<SIZE>::head];
-        DelayQueue<SIZE>::dequeue();
+      const int32_t dequeue(const uint8_t e) {
+        const int32_t result = params[EchoQueue<SIZE>::head[e]];
+        EchoQueue<SIZE>::dequeue(e);
         return result;
       }
   };
 
 #endif // INPUT_SHAPING
 
+#if ENABLED(ANKER_STEPPER_SNAPSHOT)
+
+  // Everything the stepper isr knew at the end of one run
+  typedef struct {
+    xyze_long_t pos;                // count_position, steps
+    uint32_t step_events_completed, // Progress in the current block, 0 when idle
+             step_event_count,      // Length of the current block, 0 when idle
+             step_rate;             // Step rate of the current phase, steps/s, 0 when idle
+  } stepper_snapshot_t;
+
+#endif
+
 //
 // Stepper class definition
 //
@@ -377,6 +425,14 @@ class Stepper {
                     #endif
                   #endif
                   ;
+      #if ENABLED(ANKER_ALIGN_LSQ)
+        static uint32_t z_lock_after[2];
+        FORCE_INLINE static void z_lock_count() {
+          if (!separate_multi_axis) return;
+          if (z_lock_after[0] && !locked_Z_motor && !--z_lock_after[0]) locked_Z_motor = true;
+          if (z_lock_after[1] && !locked_Z2_motor && !--z_lock_after[1]) locked_Z2_motor = true;
+        }
+      #endif
     #endif
 
     static uint32_t acceleration_time, deceleration_time; // time measured in Stepper Timer ticks
@@ -418,18 +474,18 @@ class Stepper {
 
     #if ENABLED(INPUT_SHAPING)
       #if HAS_SHAPING_X
-        static uint8_t                            shaping_factor_x;
-        static DelayQueue<SHAPING_BUFFER_X>       shaping_queue_x;
-        static ParamDelayQueue<SHAPING_SEGMENTS>  shaping_dividend_queue_x;
-        static int32_t                            shaping_dividend_x;
-        static constexpr shaping_time_t           shaping_delay_x = uint32_t(STEPPER_TIMER_RATE) / (SHAPING_FREQ_X) / 2;
+        static shaping_params_t                 shaping_x;
+        static bool                             shaping_enqueue_x;  // Current block feeds the X echoes
+        static EchoQueue<SHAPING_BUFFER_X>      shaping_queue_x;
+        static EchoParamQueue<SHAPING_SEGMENTS> shaping_dividend_queue_x;
+        static int32_t                          shaping_dividend_x[SHAPING_ECHOES];
       #endif
       #if HAS_SHAPING_Y
-        static uint8_t                            shaping_factor_y;
-        static DelayQueue<SHAPING_BUFFER_Y>       shaping_queue_y;
-        static ParamDelayQueue<SHAPING_SEGMENTS>  shaping_dividend_queue_y;
-        static int32_t                            shaping_dividend_y;
-        static constexpr shaping_time_t           shaping_delay_y = uint32_t(STEPPER_TIMER_RATE) / (SHAPING_FREQ_Y) / 2;
+        static shaping_params_t                 shaping_y;
+        static bool                             shaping_enqueue_y;  // Current block feeds the Y echoes
+        static EchoQueue<SHAPING_BUFFER_Y>      shaping_queue_y;
+        static EchoParamQueue<SHAPING_SEGMENTS> shaping_dividend_queue_y;
+        static int32_t                          shaping_dividend_y[SHAPING_ECHOES];
       #endif
     #endif
 
@@ -437,6 +493,7 @@ class Stepper {
       static constexpr uint32_t LA_ADV_NEVER = 0xFFFFFFFF;
       static uint32_t nextAdvanceISR;
       static LA_version_tu LA_ver;
+      static uint8_t la_version;            // LIN_ADV_VERSION_* of the current block
     #endif
 
     #if ENABLED(INTEGRATED_BABYSTEPPING)
@@ -459,6 +516,13 @@ class Stepper {
     // Positions of stepper motors, in step units
     static xyze_long_t count_position;
 
+    #if ENABLED(ANKER_STEPPER_SNAPSHOT)
+      static stepper_snapshot_t snap[2];  // Written by turns, see publish_snapshot()
+      static volatile uint32_t snap_seq;
+      static uint32_t snap_rate;          // Step rate of the current phase, steps/s
+      static void publish_snapshot();
+    #endif
+
     // Current stepper motor directions (+1 or -1)
     static xyze_int8_t count_direction;
 
@@ -504,15 +568,17 @@ class Stepper {
 
     // The stepper pulse ISR phase
     static void pulse_phase_isr();
+    template<bool LA_V1> static void pulse_phase_kernel(uint8_t events_to_do);
+    static void (*pulse_phase_steps)(uint8_t events_to_do); // pulse_phase_kernel of the current block
 
     // The stepper block processing ISR phase
     static uint32_t block_phase_isr();
 
     #if HAS_SHAPING_X
-      static void shaping_isr_x();
+      static void shaping_isr_x(const uint8_t e);
     #endif
     #if HAS_SHAPING_Y
-      static void shaping_isr_y();
+      static void shaping_isr_y(const uint8_t e);
     #endif
 
     #if ENABLED(LIN_ADVANCE)
@@ -545,6 +611,11 @@ class Stepper {
     // Get the position of a stepper, in steps
     static int32_t position(const AxisEnum axis);
 
+    #if ENABLED(ANKER_STEPPER_SNAPSHOT)
+      // All axes and the block progress at once, safe from any context
+      static void snapshot(stepper_snapshot_t &s);
+    #endif
+
     // Set the current position in steps
     static void set_position(const xyze_long_t &spos);
     static void set_axis_position(const AxisEnum a, const int32_t &v);
@@ -564,7 +635,10 @@ class Stepper {
       #endif
 
       #if ENABLED(ANKER_E_SMOOTH) //add by Anan.huang
-        la_status.pre = current_block->la_segment;
+        if (current_block->la_version >= LIN_ADV_VERSION_2)
+          la_status.pre = current_block->la_segment;
+        else
+          LA_CLEAR_SEGMENT(la_status.pre);
       #endif
 
       current_block = nullptr;
@@ -630,6 +704,11 @@ class Stepper {
           #endif
         #endif
       }
+      #if ENABLED(ANKER_ALIGN_LSQ)
+        // Lock a Z motor after this many more steps of a separate multi axis move, 0 for no limit.
+        // One planned move then raises both motors by different amounts.
+        FORCE_INLINE static void set_z_lock_after(const uint8_t i, const uint32_t steps) { z_lock_after[i] = steps; }
+      #endif
     #endif
 
     #if ENABLED(BABYSTEPPING)
@@ -650,7 +729,19 @@ class Stepper {
     }
 
     #if ENABLED(INPUT_SHAPING)
-      static void set_shaping_damping_ratio(const AxisEnum axis, const float zeta);
+      /**
+       * @brief  Select the shaper of an axis, once the planner and the echoes have run out
+       * @param  axis : X_AXIS or Y_AXIS
+       * @param  type : shaper family, SHAPER_NONE turns the axis shaping off
+       * @param  freq : resonance frequency (Hz), SHAPING_MIN_FREQ or more
+       * @param  zeta : damping ratio, 0 to SHAPING_MAX_ZETA
+       * @retval false if the axis is not shaped or a parameter is out of range
+       */
+      static bool set_shaping(const AxisEnum axis, const ShapingType type, const float freq, const float zeta);
+      static const shaping_params_t* get_shaping(const AxisEnum axis);
+      // True once every echo of every shaped axis has been played out
+      static bool shaping_idle();
+      static void shaping_report();
     #endif
     
   private:
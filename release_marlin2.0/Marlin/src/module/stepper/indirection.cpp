@@ -32,14 +32,20 @@
 #include "../../inc/MarlinConfig.h"
 #include "indirection.h"
 
+#if ENABLED(ANKER_TMC_POLL)
+  #include "../../feature/anker/anker_tmc_poll.h"
+#endif
+
 void restore_stepper_drivers() {
   TERN_(HAS_TRINAMIC_CONFIG, restore_trinamic_drivers());
+  TERN_(ANKER_TMC_POLL, anker_tmc_poll.invalidate_all());
 }
 
 void reset_stepper_drivers() {
   TERN_(HAS_TMC26X, tmc26x_init_to_defaults());
   TERN_(HAS_L64XX, L64xxManager.init_to_defaults());
   TERN_(HAS_TRINAMIC_CONFIG, reset_trinamic_drivers());
+  TERN_(ANKER_TMC_POLL, anker_tmc_poll.invalidate_all());
 }
 
 #if ENABLED(SOFTWARE_DRIVER_ENABLE)
@@ -61,6 +61,8 @@
   #include "../feature/interactive/uart_nozzle_tx.h"
 #endif
 
+#include "../feature/anker/anker_isr_profile.h"
+
 // MAX TC related macros
 #define TEMP_SENSOR_IS_MAX(n, M) (ENABLED(TEMP_SENSOR_##n##_IS_MAX##M) || (ENABLED(TEMP_SENSOR_REDUNDANT_IS_MAX##M) && REDUNDANT_TEMP_MATCH(SOURCE, E##n)))
 #define TEMP_SENSOR_IS_ANY_MAX_TC(n) (ENABLED(TEMP_SENSOR_##n##_IS_MAX_TC) || (ENABLED(TEMP_SENSOR_REDUNDANT_IS_MAX_TC) && REDUNDANT_TEMP_MATCH(SOURCE, E##n)))
@@ -3521,6 +3523,7 @@ public:
  *  - Planner clean buffer
  */
 void Temperature::isr() {
+  ISR_PROFILE(PROF_TEMPERATURE_ISR);
 
   static int8_t temp_count = -1;
   static ADCSensorState adc_sensor_state = StartupDelay;
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+#
+# blog_decode.py
+#
+# Decode the binary host log of the firmware (ANKER_BINARY_LOG, M4902 S1).
+#
+# The firmware sends a hash of the format string instead of the text. The
+# formats are found here in the firmware sources, the same way the compiler
+# builds them, so the table always matches the sources it is given.
+#
+#   record: 0xA5 <len> <id:4> <ms:4> <args:len-8> <sum>
+#           little endian, sum of <len>..<args> & 0xFF
+#   args  : 4 bytes per integer or float, %s is <n> <n chars>
+#
+# Text around the records is passed through unchanged.
+#
+# Usage:
+#   blog_decode.py --src Marlin/src capture.bin
+#   blog_decode.py --src Marlin/src --port /dev/ttyS1 --baud 115200
+#   blog_decode.py --src Marlin/src --table           (print the format table)
+#
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+
+# The message macros of core/serial.h and the text they wrap around the format
+MACROS = {
+  'SEND_ERRNO_TO_HOST'   : 'Err_<%d-%X> = {}\n',
+  'SEND_DEBUG_TO_HOST'   : 'echo_<%d-%X> = {}\n',
+  'SEND_RESPONSE_TO_HOST': 'resp_<%d-%X> = {}\n',
+  'BLOG_TO_HOST'         : '{}',
+}
+
+CALL_RE = re.compile(r'\b(' + '|'.join(MACROS) + r')\s*\(')
+STRING_RE = re.compile(r'\s*"((?:[^"\\]|\\.)*)"')
+SPEC_RE = re.compile(r'%([-+ #0]*)(\d*|\*)(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t|L)?([diouxXcsfFeEgGaA%])')
+
+ESCAPES = { 'n': '\n', 't': '\t', 'r': '\r', '0': '\0', '\\': '\\', '"': '"', "'": "'" }
+
+def unescape(s):
+  return re.sub(r'\\(.)', lambda m: ESCAPES.get(m.group(1), m.group(1)), s)
+
+def fnv1a(s):
+  h = 2166136261
+  for b in s.encode('latin-1'):
+    h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+  return h
+
+def skip_args(text, pos, count):
+  """Index after `count` top level commas from pos, None if the call ends first"""
+  depth = 0
+  while pos < len(text):
+    c = text[pos]
+    if c == '"':
+      m = STRING_RE.match(text, pos)
+      pos = m.end() if m else pos + 1
+      continue
+    if c in '([{': depth += 1
+    elif c in ')]}':
+      if depth == 0: return None
+      depth -= 1
+    elif c == ',' and depth == 0:
+      count -= 1
+      if count == 0: return pos + 1
+    pos += 1
+  return None
+
+def scan_sources(src):
+  """Format table { id: format } of every message macro call under src"""
+  table = {}
+  for root, _, files in os.walk(src):
+    for name in files:
+      if not name.endswith(('.cpp', '.h', '.c')): continue
+      path = os.path.join(root, name)
+      with open(path, encoding='utf-8', errors='replace') as f:
+        text = f.read()
+      for m in CALL_RE.finditer(text):
+        macro = m.group(1)
+        if text[m.start() - 8:m.start()].endswith('define '): continue
+        # The format follows errno, errno2 except for BLOG_TO_HOST
+        pos = m.end() if macro == 'BLOG_TO_HOST' else skip_args(text, m.end(), 2)
+        if pos is None: continue
+        parts = []
+        while True:
+          s = STRING_RE.match(text, pos)
+          if not s: break
+          parts.append(unescape(s.group(1)))
+          pos = s.end()
+        if not parts: continue
+        fmt = MACROS[macro].format(''.join(parts))
+        table[fnv1a(fmt)] = fmt
+  return table
+
+def format_record(fmt, args):
+  """printf the raw args with fmt"""
+  out, pos, i = [], 0, 0
+  for m in SPEC_RE.finditer(fmt):
+    out.append(fmt[pos:m.start()])
+    pos = m.end()
+    flags, width, prec, _, conv = m.groups()
+    if conv == '%':
+      out.append('%')
+      continue
+    spec = '%' + flags + (width or '') + ('.' + prec if prec else '')
+    if conv == 's':
+      n = args[i] if i < len(args) else 0
+      v = args[i + 1:i + 1 + n].decode('latin-1', 'replace')
+      i += 1 + n
+      out.append((spec + 's') % v)
+      continue
+    word = args[i:i + 4]
+    i += 4
+    if len(word) < 4:
+      out.append('<?>')
+      continue
+    if conv in 'fFeEgGaA':
+      out.append((spec + ('f' if conv in 'aA' else conv)) % struct.unpack('<f', word)[0])
+    elif conv in 'di':
+      out.append((spec + 'd') % struct.unpack('<i', word)[0])
+    elif conv == 'c':
+      out.append(chr(word[0]))
+    else:
+      out.append((spec + ('d' if conv == 'u' else conv)) % struct.unpack('<I', word)[0])
+  out.append(fmt[pos:])
+  return ''.join(out)
+
+class Decoder:
+  def __init__(self, table, out):
+    self.table, self.out = table, out
+    self.buf = bytearray()
+    self.bad = 0
+
+  def feed(self, data):
+    self.buf += data
+    while self.buf:
+      i = self.buf.find(SYNC)
+      if i < 0:
+        self.text(self.buf)
+        self.buf = bytearray()
+        return
+      if i: self.text(self.buf[:i])
+      del self.buf[:i]
+      if len(self.buf) < 2: return
+      n = self.buf[1]
+      if n < 8:
+        self.drop()
+        continue
+      if len(self.buf) < n + 3: return
+      rec = self.buf[:n + 3]
+      if sum(rec[1:n + 2]) & 0xFF != rec[n + 2]:
+        self.drop()
+        continue
+      del self.buf[:n + 3]
+      rid, ms = struct.unpack('<II', bytes(rec[2:10]))
+      args = bytes(rec[10:n + 2])
+      fmt = self.table.get(rid)
+      text = format_record(fmt, args) if fmt else '<unknown id %08X> %s\n' % (rid, args.hex())
+      self.out.write('[%10.3f] %s' % (ms / 1000.0, text if text.endswith('\n') else text + '\n'))
+
+  def drop(self):
+    # Not a record after all, pass the byte through and resync on the next one
+    self.bad += 1
+    self.text(self.buf[:1])
+    del self.buf[:1]
+
+  def text(self, data):
+    self.out.write(bytes(data).decode('latin-1', 'replace'))
+
+def main():
+  ap = argparse.ArgumentParser(description='Decode the firmware binary host log')
+  ap.add_argument('--src', default=os.path.join(os.path.dirname(__file__), '..', '..', '..', 'Marlin', 'src'),
+                  help='Firmware sources holding the formats')
+  ap.add_argument('--table', action='store_true', help='Print the format table and exit')
+  ap.add_argument('--port', help='Serial port to read, needs pyserial')
+  ap.add_argument('--baud', type=int, default=115200)
+  ap.add_argument('input', nargs='?', help='Captured log file, stdin if omitted')
+  args = ap.parse_args()
+
+  table = scan_sources(args.src)
+  if args.table:
+    for rid, fmt in sorted(table.items()):
+      print('%08X %r' % (rid, fmt))
+    return
+
+  dec = Decoder(table, sys.stdout)
+  try:
+    if args.port:
+      import serial
+      with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        while True:
+          dec.feed(port.read(256))
+          sys.stdout.flush()
+    else:
+      f = open(args.input, 'rb') if args.input else getattr(sys.stdin, 'buffer', sys.stdin)
+      while True:
+        data = f.read(4096)
+        if not data: break
+        dec.feed(data)
+  except KeyboardInterrupt:
+    pass
+  if dec.bad: print('\n%d bytes out of sync' % dec.bad, file=sys.stderr)
+
+if __name__ == '__main__':
+  main()